@@ -54,6 +54,8 @@ void PlayerScript::OnUpdate(const shade::FrameTimer& deltaTime)
 
 		if (graph.AnimationGraph)
 		{
+			shade::graphs::GraphInstance::Scope instance(*graph.AnimationGraph->GetGraphContext(), graph.Instance.Raw());
+
 			graph.AnimationGraph->SetInputValue("State", static_cast<int>(rState)); 
 			graph.AnimationGraph->SetInputValue("Direction", m_Velocity);  
 
@@ -2387,15 +2387,29 @@ void  graph_editor::BoneMaskNodeDelegate::ProcessSideBar(const InternalContext*
 	BoneMaskNode& node = GetNode()->As<animation::BoneMaskNode>();
 	ImGui::Text("Node: Bone Mask");
 
+	BoneMask& boneMask = node.GetBoneMask();
+	const Asset<Skeleton>& skeleton = node.GetGraphContext()->As<animation::AnimationGraphContext>().Skeleton;
+
+	if (m_BoneNames.size() != boneMask.GetWeights().size())
+	{
+		m_BoneNames.assign(boneMask.GetWeights().size(), std::string());
+
+		if (skeleton)
+		{
+			for (auto& [name, bone] : skeleton->GetBones())
+				if (bone.ID < m_BoneNames.size()) m_BoneNames[bone.ID] = name;
+		}
+	}
+
 	if (ImGui::BeginChildEx("Node: Bone Mask", std::size_t(&node), ImGui::GetContentRegionAvail(), true, 0))
 	{
 		ImGuiLayer::InputTextCol("Search", m_Search);
 
 		if (ImGui::BeginTable("##BoneMaskTable", 2, ImGuiTableFlags_SizingFixedFit))
 		{
-			for (auto& [key, value] : node.GetBoneMask().Weights)
+			for (std::size_t key = 0; key < m_BoneNames.size(); ++key)
 			{
-				if (value.first.find(m_Search) != std::string::npos)
+				if (m_BoneNames[key].find(m_Search) != std::string::npos)
 				{
 					ImGui::TableNextRow();
 					{
@@ -2403,13 +2417,14 @@ void  graph_editor::BoneMaskNodeDelegate::ProcessSideBar(const InternalContext*
 
 						shade::ImGuiLayer::DrawFontIcon(u8"\xf2d8", 1, 0.6f); ImGui::SameLine(); //ImGui::Text(value.first.c_str());
 
-						ImGui::Text(std::to_string(key).c_str()); ImGui::SameLine(); ImGui::Text(value.first.c_str());
+						ImGui::Text(std::to_string(key).c_str()); ImGui::SameLine(); ImGui::Text(m_BoneNames[key].c_str());
 
 
 						ImGui::TableNextColumn();
 						ImGui::PushID(key);
 						ImGui::PushItemWidth(50.f);
-						ImGui::DragFloat("##", &value.second, 0.001f, 0.f, 1.f);
+						float weight = boneMask.GetWeight(key);
+						if (ImGui::DragFloat("##", &weight, 0.001f, 0.f, 1.f)) boneMask.SetWeight(key, weight);
 						ImGui::PopItemWidth();
 						ImGui::PopID();
 					}
@@ -445,6 +445,8 @@ namespace graph_editor
 		virtual void ProcessBodyContent(const InternalContext* context) override;
 	private:
 		std::string m_Search;
+		// Bone names by bone ID, mask itself keeps only weights
+		std::vector<std::string> m_BoneNames;
 	};
 
 	class IntEqualsNodeDelegate : public GraphNodePrototype
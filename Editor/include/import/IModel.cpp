@@ -106,7 +106,7 @@ std::pair<shade::SharedPointer<shade::Model>, std::unordered_map<std::string, sh
 			SHADE_INFO("Start to extracting animations");
 			SHADE_INFO("******************************************************************");
 
-			animations = IAnimation::ImportAnimations(pScene, skeleton);
+			animations = IAnimation::ImportAnimations(pScene, skeleton, flags & CompressAnimations);
 		}
 
 		model->SetSkeleton(skeleton);
@@ -311,7 +311,7 @@ void ISkeleton::ProcessBone(const aiScene* pScene, const aiNode* pNode, shade::S
 	}
 }
 
-std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> IAnimation::ImportAnimations(const aiScene* pScene, const shade::SharedPointer<shade::Skeleton>& skeleton)
+std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> IAnimation::ImportAnimations(const aiScene* pScene, const shade::SharedPointer<shade::Skeleton>& skeleton, bool compress)
 {
 	std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> Animations;
 
@@ -382,6 +382,13 @@ std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> IAnimati
 			animation->AddChannel(pChannel->mNodeName.C_Str(), channel);
 		}
 
+		if (compress)
+		{
+			animation->Compress(shade::animation::CompressionSettings{}, skeleton.Raw());
+
+			SHADE_INFO("Compressed : {0} channels, {1} bytes", animation->GetAnimationCahnnels().size(), animation->GetCompressedClip().GetMemoryUsage());
+		}
+
 		Animations[pAnimation->mName.C_Str()] = animation;
 	}
 
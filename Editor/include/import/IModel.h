@@ -21,7 +21,8 @@ enum IImportFlags : std::uint32_t
 	CalcTangentSpace				= (1u << 10),
 	CalcNormals						= (1u << 11),
 	GenSmoothNormals				= (1u << 12),
-	UseScale						= (1u << 13)
+	UseScale						= (1u << 13),
+	CompressAnimations				= (1u << 14)
 };
 
 using IImportFlag = std::uint32_t;
@@ -37,7 +38,7 @@ private:
 class IAnimation
 {
 public:
-	static std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> ImportAnimations(const aiScene* scene, const shade::SharedPointer<shade::Skeleton>& skeleton = nullptr);
+	static std::unordered_map<std::string, shade::SharedPointer<shade::Animation>> ImportAnimations(const aiScene* scene, const shade::SharedPointer<shade::Skeleton>& skeleton = nullptr, bool compress = false);
 };
 
 class IModel
@@ -2,6 +2,11 @@
 #include "EditorLayer.h"
 #include <shade/core/event/Input.h>
 #include <shade/core/application/Application.h>
+#include <shade/core/physics/broadphase/BroadPhaseBenchmark.h>
+#include <shade/core/entity/StorageBenchmark.h>
+#include <shade/core/physics/shapes/BoxShape.h>
+#include <shade/core/physics/shapes/SphereShape.h>
+#include <shade/core/physics/shapes/CapsuleShape.h>
 
 // TODO: Temporary
 
@@ -217,6 +222,7 @@ void EditorLayer::MainMenu(shade::SharedPointer<shade::Scene>& scene)
 				importAnimations = true,
 				importMaterials = true,
 				validateAnimationChannels = false,
+				compressAnimations = false,
 				triangulate = true,
 				flipUvs = true,
 				joinVerties = true,
@@ -268,6 +274,12 @@ void EditorLayer::MainMenu(shade::SharedPointer<shade::Scene>& scene)
 							ImGui::TableNextColumn(); { ImGui::Checkbox("##ValidateAnimationsChannels", &validateAnimationChannels); HelpMarker("(?)", "Remove animation channels if there are no specific bones present."); }
 							(!importSkeleton || !importAnimations) ? ImGui::EndDisabled() : void();
 
+							ImGui::TableNextRow();
+							(!importAnimations) ? ImGui::BeginDisabled() : void();
+							ImGui::TableNextColumn(); { ImGui::Text("	Compress animations"); }
+							ImGui::TableNextColumn(); { ImGui::Checkbox("##CompressAnimations", &compressAnimations); HelpMarker("(?)", "Quantize and reduce animation keys, channels of bones which keep bind pose are removed if skeleton is imported."); }
+							(!importAnimations) ? ImGui::EndDisabled() : void();
+
 							ImGui::EndTable();
 						}
 					}
@@ -346,6 +358,7 @@ void EditorLayer::MainMenu(shade::SharedPointer<shade::Scene>& scene)
 									((importAnimations) ? IImportFlags::ImportAnimation : 0) |
 									((importSkeleton) ? IImportFlags::TryToImportSkeleton : 0) |
 									((validateAnimationChannels) ? IImportFlags::TryValidateAnimationChannels : 0) |
+									((compressAnimations) ? IImportFlags::CompressAnimations : 0) |
 
 									((triangulate) ? IImportFlags::Triangulate : 0) |
 									((bakeBones) ? IImportFlags::BakeBoneIdsWeightsIntoMesh : 0) |
@@ -968,8 +981,7 @@ void EditorLayer::Entities(shade::SharedPointer<shade::Scene>& scene)
 					{
 						// WRONG ASSET Creation !!
 						auto& graph = entity.AddComponent<shade::AnimationGraphComponent>();
-						graph.AnimationGraph = shade::SharedPointer<shade::animation::AnimationGraph>::Create(&graph.GraphContext);
-						graph.GraphContext.Controller = shade::animation::AnimationController::Create();
+						graph.AnimationGraph = shade::SharedPointer<shade::animation::AnimationGraph>::Create(nullptr);
 					}, m_SelectedEntity);
 
 				AddComponent<shade::NativeScriptComponent>("Native script", false, m_SelectedEntity, [&](shade::ecs::Entity& entity)
@@ -1944,6 +1956,48 @@ void EditorLayer::RenderSettings(shade::SharedPointer<shade::SceneRenderer>& ren
 	shade::DirectionalLight::GetRenderShadowSettings().PCFP.Samples = Samples;*/
 
 
+	if (ImGui::TreeNodeEx("ECS", ImGuiTreeNodeFlags_Framed))
+	{
+		static std::vector<shade::ecs::StorageBenchmark::Result> results;
+		if (ImGui::Button("Run storage benchmark"))
+		{
+			results.clear();
+			for (std::size_t count : { 1000u, 10000u, 100000u })
+				results.emplace_back(shade::ecs::StorageBenchmark::Run(count));
+		}
+		for (const auto& result : results)
+			ImGui::Text("%zu entities: iterate %.3f / %.3f ms, get %.3f / %.3f ms (shared_ptr / paged)", result.EntitiesCount, result.SharedPointerIterateMilliseconds, result.PagedIterateMilliseconds, result.SharedPointerGetMilliseconds, result.PagedGetMilliseconds);
+
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNodeEx("Physics", ImGuiTreeNodeFlags_Framed))
+	{
+		std::vector<std::string> items(std::size_t(shade::physic::BroadPhase::Type::TYPE_MAX_ENUM));
+		for (shade::physic::BroadPhase::Type type = shade::physic::BroadPhase::Type::SweepAndPrune; type < shade::physic::BroadPhase::Type::TYPE_MAX_ENUM; ((std::uint32_t&)type)++)
+			items[std::size_t(type)] = shade::physic::BroadPhase::GetTypeAsString(type);
+		std::uint32_t currentItem = std::uint32_t(shade::physic::PhysicsManager::GetBroadPhaseType());
+
+		ImGui::Text("Broad phase"); ImGui::SameLine();
+		if (DrawComboWithIndex("##BroadPhase", currentItem, items, ImGuiSelectableFlags_None, ImGuiComboFlags_None))
+			shade::physic::PhysicsManager::SetBroadPhase(shade::physic::BroadPhase::Type(currentItem));
+
+		const auto& statistic = shade::physic::PhysicsManager::GetBroadPhaseStatistic();
+		ImGui::Text("Proxies %zu, pairs tested %zu, pairs found %zu", statistic.ProxiesCount, statistic.PairsTested, statistic.PairsFound);
+
+		static std::vector<shade::physic::BroadPhaseBenchmark::Result> results;
+		if (ImGui::Button("Run broad phase benchmark"))
+		{
+			results.clear();
+			for (shade::physic::BroadPhase::Type type = shade::physic::BroadPhase::Type::SweepAndPrune; type < shade::physic::BroadPhase::Type::TYPE_MAX_ENUM; ((std::uint32_t&)type)++)
+				results.emplace_back(shade::physic::BroadPhaseBenchmark::Run(type));
+		}
+		for (const auto& result : results)
+			ImGui::Text("%s: tested %.0f / %zu, found %.0f, %.3f ms per step", shade::physic::BroadPhase::GetTypeAsString(result.Type).c_str(), result.AveragePairsTested, result.BruteForcePairs, result.AveragePairsFound, result.AverageStepMilliseconds);
+
+		ImGui::TreePop();
+	}
+
 	if (ImGui::TreeNodeEx("Render", ImGuiTreeNodeFlags_Framed))
 	{
 		auto vramUsage = shade::Renderer::GetVramMemoryUsage();
@@ -1958,6 +2012,9 @@ void EditorLayer::RenderSettings(shade::SharedPointer<shade::SceneRenderer>& ren
 		// Display progress bar with VRAM usage
 		ImGui::Text("V-Ram"); ImGui::SameLine(); ImGui::ProgressBar(progress, ImVec2(ImGui::GetContentRegionAvail().x, ImGui::GetFrameHeight() * 0.7f), std::format("{:.2f} MB / {:.2f} MB", usedMemoryMB, totalMemoryMB).c_str());
 		//ImGui::Text("Submited instances %d, point lights %d, spot lights %d", m_SceneRenderer->GetStatistic().SubmitedInstances, m_SceneRenderer->GetStatistic().SubmitedOmnidirectLights, m_SceneRenderer->GetStatistic().SubmitedSpotLights);
+		ImGui::Text("Visible meshes %u, culled meshes %u", m_SceneRenderer->GetStatistic().VisibleMeshes, m_SceneRenderer->GetStatistic().CulledMeshes);
+		ImGui::Text("Resident geometry %.2f MB, uploads %llu, evictions %llu", shade::Renderer::GetGeometryResidency().GetStatistic().ResidentBytes / 1048576.0f,
+			static_cast<unsigned long long>(shade::Renderer::GetGeometryResidency().GetStatistic().Uploads), static_cast<unsigned long long>(shade::Renderer::GetGeometryResidency().GetStatistic().Evictions));
 		
 		if (ImGui::TreeNodeEx("Effects", ImGuiTreeNodeFlags_Framed))
 		{
@@ -2766,6 +2823,8 @@ void EditorLayer::RgidBodyComponent(shade::ecs::Entity& entity)
 void EditorLayer::AnimationGraphComponent(shade::ecs::Entity& entity)
 {
 	auto& graph = entity.GetComponent<shade::AnimationGraphComponent>();
+	// Skeleton is kept by graph context, graph can be replaced while the component is drawn
+	auto graphContext = [&graph]() { return (graph.AnimationGraph) ? &graph.AnimationGraph->GetGraphContext()->As<shade::animation::AnimationGraphContext>() : nullptr; };
 
 	if (!m_GraphEditor.GetRootGraph() && graph.AnimationGraph)
 	{
@@ -2797,8 +2856,7 @@ void EditorLayer::AnimationGraphComponent(shade::ecs::Entity& entity)
 				{
 					if (shade::file::File file = shade::file::FileManager::LoadFile(path.string(), "@s_animgraph"))
 					{
-						graph.GraphContext.Drop();
-						graph.AnimationGraph = shade::SharedPointer<shade::animation::AnimationGraph>::Create(&graph.GraphContext); file.Read(graph.AnimationGraph); m_GraphEditor.Initialize(graph.AnimationGraph);
+						graph.AnimationGraph = shade::SharedPointer<shade::animation::AnimationGraph>::Create(nullptr); file.Read(graph.AnimationGraph); m_GraphEditor.Initialize(graph.AnimationGraph);
 					}
 					else
 					{
@@ -2861,8 +2919,11 @@ void EditorLayer::AnimationGraphComponent(shade::ecs::Entity& entity)
 				{
 					if (shade::file::File file = shade::file::FileManager::LoadFile(path.string(), "@s_skel"))
 					{
-						graph.GraphContext.Skeleton = shade::Skeleton::CreateEXP();
-						file.Read(graph.GraphContext.Skeleton);
+						if (auto pContext = graphContext())
+						{
+							pContext->Skeleton = shade::Skeleton::CreateEXP();
+							file.Read(pContext->Skeleton);
+						}
 					}
 					else
 					{
@@ -2873,7 +2934,8 @@ void EditorLayer::AnimationGraphComponent(shade::ecs::Entity& entity)
 		}
 		ImGui::TableNextColumn();
 		{
-			std::string buttonTitle = (!graph.GraphContext.Skeleton || !graph.GraphContext.Skeleton->GetAssetData()) ? "Not set" : graph.GraphContext.Skeleton->GetAssetData()->GetId();
+			auto pContext = graphContext();
+			std::string buttonTitle = (!pContext || !pContext->Skeleton || !pContext->Skeleton->GetAssetData()) ? "Not set" : pContext->Skeleton->GetAssetData()->GetId();
 			ImGui::BeginDisabled();
 			ImGui::Button(buttonTitle.c_str(), ImVec2{ ImGui::GetContentRegionAvail().x, 0.f });
 			ImGui::EndDisabled();
@@ -2955,7 +3017,7 @@ void EditorLayer::AnimationGraphComponent(shade::ecs::Entity& entity)
 										shade::BaseAsset::LifeTime::KeepAlive,
 										[&](auto& skeleton) mutable
 										{
-											graph.GraphContext.Skeleton = skeleton;
+											if (auto pContext = graphContext()) pContext->Skeleton = skeleton;
 										});
 
 								skeletonAssetPopop = false;
@@ -3124,7 +3186,8 @@ void EditorLayer::BoneMaskEdnitor(const shade::Skeleton::BoneNode* node, shade::
 				ImGui::TableNextColumn();
 				{
 					ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
-					ImGui::DragFloat(std::string("##" + node->Name).c_str(), &boneMask.Weights.at(node->ID).second, 0.01f, 0.f, 1.f);
+					float weight = boneMask.GetWeight(node->ID);
+					if (ImGui::DragFloat(std::string("##" + node->Name).c_str(), &weight, 0.01f, 0.f, 1.f)) boneMask.SetWeight(node->ID, weight);
 				}
 				ImGui::TableNextColumn();
 				{
@@ -3329,6 +3392,13 @@ void EditorLayer::CreateCollisionShapes()
 	}
 	ImGui::Separator();
 
+	// Primitive colliders are fitted to mesh bounds and use closed form collision routines instead of hulls
+	static std::string shapeType = "Mesh";
+	std::vector<std::string> shapeTypes = { "Mesh", "Box", "Sphere", "Capsule" };
+	ComboCol("Shape", shapeType, shapeTypes, ImGuiSelectableFlags_None, ImGuiComboFlags_None, 50);
+
+	ImGui::Separator();
+
 	static std::string path;
 
 	ImGui::SetNextWindowSize(ImGui::GetContentRegionAvail());
@@ -3362,6 +3432,27 @@ void EditorLayer::CreateCollisionShapes()
 						{
 							for (const auto& mesh : *shade::Asset<shade::Model>(asset))
 							{
+								// Primitives are centered at local origin, so they cover bounds symmetrically
+								const glm::vec<3, shade::physic::scalar_t> halfSize = glm::max(glm::abs(glm::vec<3, shade::physic::scalar_t>(mesh->GetMinHalfExt())), glm::abs(glm::vec<3, shade::physic::scalar_t>(mesh->GetMaxHalfExt())));
+
+								if (shapeType == "Box")
+								{
+									shapes->AddShape(shade::SharedPointer<shade::physic::BoxShape>::Create(halfSize));
+									continue;
+								}
+								if (shapeType == "Sphere")
+								{
+									shapes->AddShape(shade::SharedPointer<shade::physic::SphereShape>::Create(glm::max(halfSize.x, glm::max(halfSize.y, halfSize.z))));
+									continue;
+								}
+								if (shapeType == "Capsule")
+								{
+									// Capsule stands along local Y axis
+									const shade::physic::scalar_t radius = glm::max(halfSize.x, halfSize.z);
+									shapes->AddShape(shade::SharedPointer<shade::physic::CapsuleShape>::Create(radius, glm::max<shade::physic::scalar_t>(halfSize.y - radius, 0.0)));
+									continue;
+								}
+
 								auto collider = shade::SharedPointer<shade::physic::MeshShape>::Create();
 								collider->SetMinMaxHalfExt(mesh->GetMinHalfExt(), mesh->GetMaxHalfExt());
 
@@ -3369,8 +3460,7 @@ void EditorLayer::CreateCollisionShapes()
 
 								auto [hull, indices] = shade::physic::algo::GenerateConvexHull(lod.Vertices, 0.0001);
 
-								for (auto& point : hull)
-									collider->AddVertex(point);
+								collider->SetHull(hull, indices);
 
 								shapes->AddShape(collider);
 							}
@@ -3392,6 +3482,6 @@ void EditorLayer::CreateCollisionShapes()
 
 		});
 
-	if (ImGui::Button("Create convex shapes", { ImGui::GetContentRegionAvail().x, 0 }))
+	if (ImGui::Button((shapeType == "Mesh") ? "Create convex shapes" : "Create primitive shapes", { ImGui::GetContentRegionAvail().x, 0 }))
 		m_IsCreateNewRawAssetModalOpen = true;
 }
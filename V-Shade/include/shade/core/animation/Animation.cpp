@@ -18,76 +18,100 @@ shade::Animation::Animation(SharedPointer<AssetData> assetData, LifeTime lifeTim
 
 void shade::Animation::AddChannel(const std::string& name, const Channel& channel)
 {
+	if (IsCompressed())
+	{
+		SHADE_CORE_ERROR("Cannot add channel '{0}', animation is already compressed!", name);
+		return;
+	}
+
 	if (m_AnimationChannels.find(name) != m_AnimationChannels.end())
 		SHADE_CORE_ERROR("Animation channel '{0}' already exists in '{1}' animation!");
 
 	m_AnimationChannels.emplace(name, channel);
+
+	// Channel indices could be changed, bindings which are in use stay alive and are rebuilt on next request
+	m_ChannelsVersion.fetch_add(1u, std::memory_order_acq_rel);
 }
 
-glm::vec3 shade::Animation::InterpolatePosition(const Channel& channel, float time) const
+glm::vec3 shade::Animation::InterpolatePosition(const Channel& channel, float time, KeyFrameCursor* cursor) const
 {
 	if (channel.PositionKeys.size() == 1)
 		return channel.PositionKeys[0].Key;
 	
-	std::uint32_t firstKeyFrame = GetPositionKeyFrame(channel, time), secondKeyFrame = firstKeyFrame++;
+	std::uint32_t firstKeyFrame = GetPositionKeyFrame(channel, time, (cursor) ? cursor->Position : 0u), secondKeyFrame = firstKeyFrame + 1;
+	if (cursor) cursor->Position = firstKeyFrame;
 
 	float timeFactor = GetTimeFactor(channel.PositionKeys[firstKeyFrame].TimeStamp, channel.PositionKeys[secondKeyFrame].TimeStamp, time);
 
 	return glm::mix(channel.PositionKeys[firstKeyFrame].Key, channel.PositionKeys[secondKeyFrame].Key, timeFactor);
 }
 
-glm::quat shade::Animation::InterpolateRotation(const Channel& channel, float time) const
+glm::quat shade::Animation::InterpolateRotation(const Channel& channel, float time, KeyFrameCursor* cursor) const
 {
 	if (channel.RotationKeys.size() == 1)
 		return glm::toMat4(glm::normalize(channel.RotationKeys[0].Key));
 
-	std::uint32_t firstKeyFrame = GetRotationKeyFrame(channel, time), secondKeyFrame = firstKeyFrame++;
+	std::uint32_t firstKeyFrame = GetRotationKeyFrame(channel, time, (cursor) ? cursor->Rotation : 0u), secondKeyFrame = firstKeyFrame + 1;
+	if (cursor) cursor->Rotation = firstKeyFrame;
 
 	float timeFactor = GetTimeFactor(channel.RotationKeys[firstKeyFrame].TimeStamp, channel.RotationKeys[secondKeyFrame].TimeStamp, time);
 
 	return glm::normalize(glm::slerp(channel.RotationKeys[firstKeyFrame].Key, channel.RotationKeys[secondKeyFrame].Key, timeFactor));
 }
 
-glm::vec3 shade::Animation::InterpolateScale(const Channel& channel, float time) const
+glm::vec3 shade::Animation::InterpolateScale(const Channel& channel, float time, KeyFrameCursor* cursor) const
 {
 	if (channel.ScaleKeys.size() == 1)
 		return channel.ScaleKeys[0].Key;
 
-	std::uint32_t firstKeyFrame = GetScaleKeyFrame(channel, time), secondKeyFrame = firstKeyFrame++;
+	std::uint32_t firstKeyFrame = GetScaleKeyFrame(channel, time, (cursor) ? cursor->Scale : 0u), secondKeyFrame = firstKeyFrame + 1;
+	if (cursor) cursor->Scale = firstKeyFrame;
 
 	float timeFactor = GetTimeFactor(channel.ScaleKeys[firstKeyFrame].TimeStamp, channel.ScaleKeys[secondKeyFrame].TimeStamp, time);
 
 	return glm::mix(channel.ScaleKeys[firstKeyFrame].Key, channel.ScaleKeys[secondKeyFrame].Key, timeFactor);
 }
 
-std::size_t shade::Animation::GetPositionKeyFrame(const Channel& chanel, float time) const
+namespace
 {
-	for (std::size_t index = 0; index < chanel.PositionKeys.size() - 1; ++index)
+	// Forward playback usually moves by zero or one key per frame, further jumps (seek, loop) fall back to binary search
+	constexpr std::size_t MAX_CURSOR_STEPS = 4u;
+
+	// Find index of the first key whose next key is at or after time, last segment is used when time is beyond the keys
+	template<typename T>
+	std::size_t FindKeyFrame(const std::vector<shade::Animation::AnimationKey<T>>& keys, float time, std::size_t hint)
 	{
-		if (chanel.PositionKeys[index + 1].TimeStamp >= time) 
-			return index;
+		const std::size_t last = keys.size() - 2;
+
+		if (hint <= last && (hint == 0 || keys[hint].TimeStamp < time))
+		{
+			for (std::size_t step = 0; step < MAX_CURSOR_STEPS && hint <= last; ++step, ++hint)
+			{
+				if (keys[hint + 1].TimeStamp >= time)
+					return hint;
+			}
+			if (hint > last)
+				return last;
+		}
+
+		const auto key = std::lower_bound(keys.begin() + 1, keys.end(), time, [](const shade::Animation::AnimationKey<T>& key, float time) { return key.TimeStamp < time; });
+		return (key != keys.end()) ? static_cast<std::size_t>(key - keys.begin()) - 1 : last;
 	}
-	return 0u;
 }
 
-std::size_t shade::Animation::GetRotationKeyFrame(const Channel& chanel, float time) const
+std::size_t shade::Animation::GetPositionKeyFrame(const Channel& chanel, float time, std::size_t hint) const
 {
-	for (std::size_t index = 0; index < chanel.RotationKeys.size() - 1; ++index)
-	{
-		if (chanel.RotationKeys[index + 1].TimeStamp >= time)
-			return index;
-	}
-	return 0u;
+	return FindKeyFrame(chanel.PositionKeys, time, hint);
 }
 
-std::size_t shade::Animation::GetScaleKeyFrame(const Channel& chanel, float time) const
+std::size_t shade::Animation::GetRotationKeyFrame(const Channel& chanel, float time, std::size_t hint) const
 {
-	for (std::size_t index = 0; index < chanel.ScaleKeys.size() - 1; ++index)
-	{
-		if (chanel.ScaleKeys[index + 1].TimeStamp >= time)
-			return index;
-	}
-	return 0u;
+	return FindKeyFrame(chanel.RotationKeys, time, hint);
+}
+
+std::size_t shade::Animation::GetScaleKeyFrame(const Channel& chanel, float time, std::size_t hint) const
+{
+	return FindKeyFrame(chanel.ScaleKeys, time, hint);
 }
 
 float shade::Animation::GetTimeFactor(float currentTime, float nextTime, float time) const
@@ -111,6 +135,126 @@ const shade::Animation::Channel* shade::Animation::GetAnimationCahnnel(const std
 	return nullptr;
 }
 
+std::uint32_t shade::Animation::GetAnimationCahnnelIndex(const std::string& name) const
+{
+	const auto it = m_AnimationChannels.find(name);
+	return (it != m_AnimationChannels.end()) ? static_cast<std::uint32_t>(it - m_AnimationChannels.begin()) : CHANNEL_NULL_INDEX;
+}
+
+const shade::Animation::Channel& shade::Animation::GetAnimationCahnnel(std::uint32_t index) const
+{
+	assert(index < m_AnimationChannels.size());
+	return m_AnimationChannels.values()[index].second;
+}
+
+std::shared_ptr<const shade::Animation::Binding> shade::Animation::GetBinding(const Skeleton& skeleton) const
+{
+	const Skeleton::Hierarchy& hierarchy = skeleton.GetHierarchy();
+
+	std::lock_guard<std::mutex> lock(m_BindingsMutex);
+
+	auto [entry, isNew] = m_Bindings.try_emplace(&skeleton);
+
+	// Skeletons aren't tracked by clip, so when a new one shows up bindings nobody holds anymore are dropped
+	// Binding of a skeleton which is still alive is rebuilt on its next request
+	if (isNew)
+	{
+		for (auto binding = m_Bindings.begin(); binding != m_Bindings.end();)
+			binding = (binding != entry && binding->second.use_count() == 1) ? m_Bindings.erase(binding) : std::next(binding);
+	}
+
+	std::shared_ptr<const Binding>& cached = entry->second;
+
+	// Existing binding is never modified, it can be read by other threads without lock
+	// Outdated binding is replaced in place, so a reused skeleton address never adds a second entry
+	if (!cached || !cached->IsValid(this, hierarchy))
+	{
+		std::shared_ptr<Binding> binding = std::make_shared<Binding>();
+		binding->Source				= this;
+		binding->ChannelsVersion	= m_ChannelsVersion.load(std::memory_order_acquire);
+		binding->HierarchyVersion	= hierarchy.Version;
+		binding->ArmatureChannel	= GetAnimationCahnnelIndex(skeleton.GetArmature()->Name);
+
+		binding->Channels.resize(hierarchy.GetBonesCount());
+		for (std::size_t i = 0; i < hierarchy.GetBonesCount(); ++i)
+			binding->Channels[i] = GetAnimationCahnnelIndex(hierarchy.Names[i]);
+
+		cached = std::move(binding);
+	}
+
+	return cached;
+}
+
+void shade::Animation::Sample(std::uint32_t index, float time, KeyFrameCursor* cursor, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const
+{
+	if (IsCompressed())
+		return m_CompressedClip.Sample(index, time, translation, rotation, scale);
+
+	const Channel& channel = GetAnimationCahnnel(index);
+
+	translation	= InterpolatePosition(channel, time, cursor);
+	rotation	= InterpolateRotation(channel, time, cursor);
+	scale		= InterpolateScale(channel, time, cursor);
+}
+
+void shade::Animation::Compress(const animation::CompressionSettings& settings, const Skeleton* skeleton)
+{
+	if (IsCompressed())
+		return;
+
+	AnimationChannels channels;
+
+	// Resampling slower than source keys loses them, so source rate is used unless other is set
+	const float fps = GetFps();
+	m_CompressedClip.Initialize(m_Duration, m_TicksPerSecond, (settings.SampleRate > 0.f) ? settings.SampleRate : ((std::isfinite(fps) && fps > 0.f) ? fps : 30.f));
+
+	for (const auto& [name, channel] : m_AnimationChannels)
+	{
+		// Armature channel is kept anyway, root motion reads it
+		const Skeleton::BoneNode* bone = (skeleton && skeleton->GetArmature()->Name != name) ? skeleton->GetBone(name) : nullptr;
+		const animation::CompressedClip::BindPose bindPose = (bone) ? animation::CompressedClip::BindPose{ bone->Translation, bone->Rotation, bone->Scale } : animation::CompressedClip::BindPose{};
+
+		// Error is measured against original keys too, not only against resampled frames
+		animation::CompressedClip::SourceKeys sourceKeys;
+		for (const auto& key : channel.PositionKeys)
+			sourceKeys.Translation.push_back({ key.TimeStamp, glm::vec4(key.Key, 0.f) });
+		for (const auto& key : channel.RotationKeys)
+		{
+			const glm::quat rotation = glm::normalize(key.Key);
+			sourceKeys.Rotation.push_back({ key.TimeStamp, glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w) });
+		}
+		for (const auto& key : channel.ScaleKeys)
+			sourceKeys.Scale.push_back({ key.TimeStamp, glm::vec4(key.Key, 0.f) });
+
+		KeyFrameCursor cursor;
+
+		const std::uint32_t index = m_CompressedClip.AddChannel(
+			[&](float time) { return InterpolatePosition(channel, time, &cursor); },
+			[&](float time) { return InterpolateRotation(channel, time, &cursor); },
+			[&](float time) { return InterpolateScale(channel, time, &cursor); },
+			settings.GetToleranceMultiplier(name), settings, (bone) ? &bindPose : nullptr, &sourceKeys);
+
+		// Keep only name, so the channel index matches the compressed one
+		if (index != animation::CompressedClip::CHANNEL_NULL_INDEX)
+			channels.emplace(name, Channel());
+	}
+
+	m_AnimationChannels = std::move(channels);
+
+	// Channel indices are changed, bindings which are in use stay alive and are rebuilt on next request
+	m_ChannelsVersion.fetch_add(1u, std::memory_order_acq_rel);
+}
+
+bool shade::Animation::IsCompressed() const
+{
+	return m_CompressedClip.GetFramesCount() != 0u;
+}
+
+const shade::animation::CompressedClip& shade::Animation::GetCompressedClip() const
+{
+	return m_CompressedClip;
+}
+
 float shade::Animation::GetTiksPerSecond() const // TODO: Rename Tics
 {
 	return m_TicksPerSecond;
@@ -133,8 +277,11 @@ void shade::Animation::SetDuration(float duration)
 
 float shade::Animation::GetFps() const
 {
+	if (IsCompressed())
+		return float(m_CompressedClip.GetFramesCount()) * m_TicksPerSecond / m_Duration;
+
 	float fps = 0;
-	for (auto [name, channel] : m_AnimationChannels)
+	for (auto& [name, channel] : m_AnimationChannels)
 		fps = std::max(fps, std::max(float(channel.PositionKeys.size()), std::max(float(channel.RotationKeys.size()), float(channel.ScaleKeys.size()))));
 	return fps * m_TicksPerSecond / m_Duration;
 }
@@ -144,6 +291,10 @@ void shade::Animation::Serialize(std::ostream& stream) const
 	serialize::Serializer::Serialize(stream, m_Duration);
 	serialize::Serializer::Serialize(stream, m_TicksPerSecond);
 	serialize::Serializer::Serialize(stream, m_AnimationChannels);
+	serialize::Serializer::Serialize(stream, IsCompressed());
+
+	if (IsCompressed())
+		serialize::Serializer::Serialize(stream, m_CompressedClip);
 }
 
 void shade::Animation::Deserialize(std::istream& stream)
@@ -152,6 +303,14 @@ void shade::Animation::Deserialize(std::istream& stream)
 	serialize::Serializer::Deserialize(stream, m_TicksPerSecond);
 	serialize::Serializer::Deserialize(stream, m_AnimationChannels);
 
+	// Files written before compression was introduced end right after channels
+	bool isCompressed = false;
+	if (stream.peek() != std::char_traits<char>::eof())
+		serialize::Serializer::Deserialize(stream, isCompressed);
+
+	if (isCompressed)
+		serialize::Serializer::Deserialize(stream, m_CompressedClip);
+
 	for (const auto& [name, value] : m_AnimationChannels)
 	{
 
@@ -5,6 +5,7 @@
 #include <shade/core/asset/Asset.h>
 //#include <shade/core/render/RenderAPI.h>
 #include <shade/core/animation/Skeleton.h>
+#include <shade/core/animation/CompressedClip.h>
 
 namespace shade
 {
@@ -37,29 +38,67 @@ namespace shade
 			std::vector<AnimationKey<glm::vec3>> ScaleKeys;
 		};
 
+		// Last used key frames of channel, playback keeps one per bone so forward sampling doesn't search keys from the start
+		struct KeyFrameCursor
+		{
+			std::uint32_t Position = 0u, Rotation = 0u, Scale = 0u;
+		};
+
 		using AnimationChannels		= ankerl::unordered_dense::map<std::string, Channel>;
 		using SynkMarkers			= ankerl::unordered_dense::map<std::string, std::vector<float>>;
+
+		static constexpr std::uint32_t CHANNEL_NULL_INDEX = ~0u;
+
+		// Channel index of every bone of a skeleton, resolved once so sampling doesn't hash bone names
+		// Binding is immutable once built, holders keep it alive while a newer one replaces it in cache
+		struct Binding
+		{
+			// Animation, its channels and skeleton hierarchy version this binding was built for
+			const Animation*			Source = nullptr;
+			std::uint64_t				ChannelsVersion = 0u;
+			std::uint64_t				HierarchyVersion = 0u;
+			// Channel index per bone in Skeleton::Hierarchy order, CHANNEL_NULL_INDEX if bone isn't animated
+			std::vector<std::uint32_t>	Channels;
+			std::uint32_t				ArmatureChannel = CHANNEL_NULL_INDEX;
+
+			SHADE_INLINE bool IsValid(const Animation* animation, const Skeleton::Hierarchy& hierarchy) const { return Source == animation && ChannelsVersion == animation->m_ChannelsVersion.load(std::memory_order_acquire) && HierarchyVersion == hierarchy.Version; }
+		};
 	public: 
 		virtual ~Animation() = default;
 		// Add a channel to the animation
 		void AddChannel(const std::string& name, const Channel& channel);
-		// Interpolate the position of the channel at the given time
-		glm::vec3 InterpolatePosition(const Channel& chanel, float time) const;
-		// Interpolate the rotation of the channel at the given time
-		glm::quat InterpolateRotation(const Channel& chanel, float time) const;
-		// Interpolate the scale of the channel at the given time
-		glm::vec3 InterpolateScale(const Channel& chanel, float time) const;
-		// Get the keyframe index of the position at the given time
-		std::size_t GetPositionKeyFrame(const Channel& chanel, float time) const;
-		// Get the keyframe index of the rotation at the given time
-		std::size_t GetRotationKeyFrame(const Channel& chanel, float time) const;
-		// Get the keyframe index of the scale at the given time
-		std::size_t GetScaleKeyFrame(const Channel& chanel, float time) const; 
+		// Interpolate the position of the channel at the given time, cursor is used as a search hint and updated if provided
+		glm::vec3 InterpolatePosition(const Channel& chanel, float time, KeyFrameCursor* cursor = nullptr) const;
+		// Interpolate the rotation of the channel at the given time, cursor is used as a search hint and updated if provided
+		glm::quat InterpolateRotation(const Channel& chanel, float time, KeyFrameCursor* cursor = nullptr) const;
+		// Interpolate the scale of the channel at the given time, cursor is used as a search hint and updated if provided
+		glm::vec3 InterpolateScale(const Channel& chanel, float time, KeyFrameCursor* cursor = nullptr) const;
+		// Get the keyframe index of the position at the given time, search starts from hint
+		std::size_t GetPositionKeyFrame(const Channel& chanel, float time, std::size_t hint = 0u) const;
+		// Get the keyframe index of the rotation at the given time, search starts from hint
+		std::size_t GetRotationKeyFrame(const Channel& chanel, float time, std::size_t hint = 0u) const;
+		// Get the keyframe index of the scale at the given time, search starts from hint
+		std::size_t GetScaleKeyFrame(const Channel& chanel, float time, std::size_t hint = 0u) const; 
 		// Get the time factor for interpolation
 		float GetTimeFactor(float currentTime, float nextTime, float time) const;
-		// Get the animation channels
+		// Get the animation channels, after compression they keep only names and indices, keys are empty
 		const AnimationChannels& GetAnimationCahnnels() const; 
 		const Channel* GetAnimationCahnnel(const std::string& name) const;
+		// Get the animation channel index by name, CHANNEL_NULL_INDEX if there is no such channel
+		std::uint32_t GetAnimationCahnnelIndex(const std::string& name) const;
+		// Get the animation channel by index from Binding
+		const Channel& GetAnimationCahnnel(std::uint32_t index) const;
+		// Get the binding of this animation to the skeleton, it's built on first request and cached
+		std::shared_ptr<const Binding> GetBinding(const Skeleton& skeleton) const;
+		// Sample the channel by index at the given time, works for both raw and compressed channels
+		void Sample(std::uint32_t index, float time, KeyFrameCursor* cursor, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const;
+		// Convert channels into compressed runtime format and release raw keys,
+		// channels of bones which keep the skeleton bind pose during whole animation are removed
+		void Compress(const animation::CompressionSettings& settings, const Skeleton* skeleton = nullptr);
+		// Check if the animation channels are compressed
+		bool IsCompressed() const;
+		// Get the compressed channels
+		const animation::CompressedClip& GetCompressedClip() const;
 		// Get the ticks per second of the animation
 		float GetTiksPerSecond() const; 
 		// Get the duration of the animation
@@ -78,9 +117,16 @@ namespace shade
 		friend class serialize::Serializer;
 	private:
 		AnimationChannels									m_AnimationChannels;
+		animation::CompressedClip							m_CompressedClip;
 		ankerl::unordered_dense::map<std::string, float>	m_SynkMarkers;
 		float				m_TicksPerSecond = 0.f;
 		float				m_Duration = 0.f;
+
+		// Bindings which aren't held by anyone are pruned when a new skeleton is bound
+		mutable std::unordered_map<const Skeleton*, std::shared_ptr<const Binding>>	m_Bindings;
+		mutable std::mutex										m_BindingsMutex;
+		// Incremented when channel indices change, bindings of older version are rebuilt
+		std::atomic<std::uint64_t>								m_ChannelsVersion = 1u;
 	};
 
 	template<>
@@ -2,6 +2,7 @@
 #include "AnimationController.h"
 #include <shade/core/asset/AssetManager.h>
 #include <glm/glm/gtx/common.hpp>
+#include <shade/core/render/RenderAPI.h>
 
 namespace shade
 {
@@ -27,45 +28,135 @@ namespace shade
 				}
 			};
 
-			template<typename BlendF>
-			void BasePoseBlendRecursevly(Pose* p0, const Pose* p1, const Pose* p2, const Skeleton::BoneNode* bone, const glm::mat4& parrentTransform, float blendFactor, const BoneMask& boneMask, std::uint32_t parentId)
+			// Normalized lerp along the shortest arc, it's close to slerp for pose blending and much cheaper
+			SHADE_INLINE glm::quat NLerp(const glm::quat& r1, const glm::quat& r2, float weight)
+			{
+				return glm::normalize(r1 * (1.f - weight) + r2 * ((glm::dot(r1, r2) < 0.f) ? -weight : weight));
+			}
+
+			SHADE_INLINE void BlendLocalTransform(Pose::LocalTransform& out, const Pose::LocalTransform& first, const Pose::LocalTransform& second, float weight)
 			{
-				const float blendFactorWithBoneMask = blendFactor * boneMask.GetWeight(bone->ID);
+				out.Translation = glm::mix(first.Translation, second.Translation, weight);
+				out.Rotation	= NLerp(first.Rotation, second.Rotation, weight);
+				out.Scale		= glm::mix(first.Scale, second.Scale, weight);
+			}
 
-				Pose::LocalTransform& localP0 = p0->GetBoneLocalTransform(bone->ID);
+			// Kernel reads local transform as 10 floats : translation [0, 3), rotation [3, 7), scale [7, 10)
+			static_assert(sizeof(Pose::LocalTransform) == sizeof(float) * 10 && offsetof(Pose::LocalTransform, Rotation) == sizeof(float) * 3 && offsetof(Pose::LocalTransform, Scale) == sizeof(float) * 7, "Unexpected Pose::LocalTransform layout!");
 
-				const Pose::LocalTransform& localP1 = p1->GetBoneLocalTransform(bone->ID);
-				const Pose::LocalTransform& localP2 = p2->GetBoneLocalTransform(bone->ID);
+			// Weight sources of blend kernel, per bone one reads 4 weights at once, uniform one keeps weight in register
+			struct PerBoneWeights
+			{
+				const float* Weights;
+				SHADE_INLINE __m128 Load(std::size_t i) const { return _mm_loadu_ps(Weights + i); }
+				SHADE_INLINE __m128 Broadcast(std::size_t i) const { return _mm_set1_ps(Weights[i]); }
+				SHADE_INLINE float operator[](std::size_t i) const { return Weights[i]; }
+			};
 
-				localP0.Translation = BlendF::Translation(localP1.Translation, localP2.Translation, blendFactorWithBoneMask);
-				localP0.Rotation	= BlendF::Rotation(localP1.Rotation, localP2.Rotation, blendFactorWithBoneMask);
-				localP0.Scale		= BlendF::Scale(localP1.Scale, localP2.Scale, blendFactorWithBoneMask);
+			struct UniformWeight
+			{
+				__m128 Weight; float Value;
+				SHADE_INLINE __m128 Load(std::size_t) const { return Weight; }
+				SHADE_INLINE __m128 Broadcast(std::size_t) const { return Weight; }
+				SHADE_INLINE float operator[](std::size_t) const { return Value; }
+			};
 
-				const glm::mat4 globalMatrix = parrentTransform * glm::translate(glm::identity<glm::mat4>(), localP0.Translation) * glm::toMat4(localP0.Rotation) * glm::scale(glm::identity<glm::mat4>(), localP0.Scale);
+			// Blend local transforms of bones [0, count), 4 bones per iteration.
+			// Rotations of 4 bones are transposed into x, y, z, w registers so nlerp and normalization run for all of them at once,
+			// translation and scale are blended per bone with one 4 wide operation each.
+			template<typename Weights>
+			void BlendLocalTransformsKernel(Pose::LocalTransform* out, const Pose::LocalTransform* first, const Pose::LocalTransform* second, const Weights& weights, std::size_t count)
+			{
+				const __m128 signMask = _mm_set1_ps(-0.f), one = _mm_set1_ps(1.f);
 
-				p0->GetBoneGlobalTransform(bone->ID) = { globalMatrix , parentId };
+				std::size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+				{
+					const float* a = reinterpret_cast<const float*>(first + i);
+					const float* b = reinterpret_cast<const float*>(second + i);
+					float* o = reinterpret_cast<float*>(out + i);
+
+					__m128 ax = _mm_loadu_ps(a + 3), ay = _mm_loadu_ps(a + 13), az = _mm_loadu_ps(a + 23), aw = _mm_loadu_ps(a + 33);
+					__m128 bx = _mm_loadu_ps(b + 3), by = _mm_loadu_ps(b + 13), bz = _mm_loadu_ps(b + 23), bw = _mm_loadu_ps(b + 33);
+					_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+					_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+					// Flip second rotation where dot is negative to take the shortest arc
+					const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+					const __m128 sign = _mm_and_ps(dot, signMask);
+					bx = _mm_xor_ps(bx, sign); by = _mm_xor_ps(by, sign); bz = _mm_xor_ps(bz, sign); bw = _mm_xor_ps(bw, sign);
+
+					const __m128 w = weights.Load(i);
+					__m128 rx = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), w));
+					__m128 ry = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), w));
+					__m128 rz = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), w));
+					__m128 rw = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), w));
+
+					const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw))));
+					const __m128 inverseLength = _mm_div_ps(one, length);
+					rx = _mm_mul_ps(rx, inverseLength); ry = _mm_mul_ps(ry, inverseLength); rz = _mm_mul_ps(rz, inverseLength); rw = _mm_mul_ps(rw, inverseLength);
+					_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+
+					// 4th lane of translation store is the first rotation component and 1st lane of scale store is the last one,
+					// both are overwritten by rotation store below. All loads are done before, so out may alias an input.
+					for (std::size_t k = 0; k < 4; ++k)
+					{
+						const __m128 weight = weights.Broadcast(i + k);
+						const std::size_t offset = k * 10;
+
+						const __m128 ta = _mm_loadu_ps(a + offset), tb = _mm_loadu_ps(b + offset);
+						const __m128 sa = _mm_loadu_ps(a + offset + 6), sb = _mm_loadu_ps(b + offset + 6);
+
+						_mm_storeu_ps(o + offset, _mm_add_ps(ta, _mm_mul_ps(_mm_sub_ps(tb, ta), weight)));
+						_mm_storeu_ps(o + offset + 6, _mm_add_ps(sa, _mm_mul_ps(_mm_sub_ps(sb, sa), weight)));
+					}
+
+					_mm_storeu_ps(o + 3, rx); _mm_storeu_ps(o + 13, ry); _mm_storeu_ps(o + 23, rz); _mm_storeu_ps(o + 33, rw);
+				}
 
-				for (const auto& child : bone->Children)
-					BasePoseBlendRecursevly<BlendF>(p0, p1, p2, child, globalMatrix, blendFactor, boneMask, bone->ID);
+				for (; i < count; ++i)
+					BlendLocalTransform(out[i], first[i], second[i], weights[i]);
 			}
-			template<typename BlendF>
+
+			void BlendLocalTransforms(Pose::LocalTransform* out, const Pose::LocalTransform* first, const Pose::LocalTransform* second, const float* weights, std::size_t count)
+			{
+				BlendLocalTransformsKernel(out, first, second, PerBoneWeights{ weights }, count);
+			}
+
+			void BlendLocalTransforms(Pose::LocalTransform* out, const Pose::LocalTransform* first, const Pose::LocalTransform* second, float weight, std::size_t count)
+			{
+				BlendLocalTransformsKernel(out, first, second, UniformWeight{ _mm_set1_ps(weight), weight }, count);
+			}
+
+			// Blend works on local transforms only, global ones are computed once for the pose which is finally consumed
 			void BasePoseBlend(Pose* p0, const Pose* p1, const Pose* p2, const Asset<Skeleton>& skeleton, float blendFactor, const BoneMask& boneMask)
 			{
-				p0->MarkHasInverseBindPose(false);
+				// TODO : Armature blend weight
+				BlendLocalTransform(p0->GetArmatureLocalTransform(), p1->GetArmatureLocalTransform(), p2->GetArmatureLocalTransform(), blendFactor);
+
+				// Bone IDs are assigned sequentially, so bones occupy [0, count) of local transforms
+				const std::size_t count = std::min({ p0->GetBoneLocalTransforms().size(), p1->GetBoneLocalTransforms().size(), p2->GetBoneLocalTransforms().size() });
 
-				const float blendFactorWithBoneMask = blendFactor; // TODO : Armature blend weight
+				if (boneMask.IsFull())
+				{
+					BlendLocalTransforms(p0->GetBoneLocalTransforms().data(), p1->GetBoneLocalTransforms().data(), p2->GetBoneLocalTransforms().data(), blendFactor, count);
+				}
+				else
+				{
+					// Dense mask covers bones [0, mask size), the rest are full
+					const std::size_t masked = std::min(count, boneMask.GetWeights().size());
+					const float* mask = boneMask.GetWeights().data();
 
-				Pose::LocalTransform& localP0		= p0->GetArmatureLocalTransform();
+					float* weights = PoseArena::Get().Allocate<float>(count);
+					for (std::size_t id = 0; id < masked; ++id)
+						weights[id] = blendFactor * mask[id];
 
-				const Pose::LocalTransform& localP1 = p1->GetArmatureLocalTransform();
-				const Pose::LocalTransform& localP2 = p2->GetArmatureLocalTransform();
+					std::fill(weights + masked, weights + count, blendFactor);
 
-				localP0.Translation = BlendF::Translation(localP1.Translation, localP2.Translation, blendFactorWithBoneMask);
-				localP0.Rotation = BlendF::Rotation(localP1.Rotation, localP2.Rotation, blendFactorWithBoneMask);
-				localP0.Scale = BlendF::Scale(localP1.Scale, localP2.Scale, blendFactorWithBoneMask);
+					BlendLocalTransforms(p0->GetBoneLocalTransforms().data(), p1->GetBoneLocalTransforms().data(), p2->GetBoneLocalTransforms().data(), weights, count);
+				}
 
-				BasePoseBlendRecursevly<BlendF>(p0, p1, p2, skeleton->GetRootNode(), glm::translate(glm::identity<glm::mat4>(), localP0.Translation) * glm::toMat4(localP0.Rotation) * glm::scale(glm::identity<glm::mat4>(), localP0.Scale), 
-					blendFactorWithBoneMask, boneMask, ~0);
+				p0->MarkGlobalTransformsDirty();
 			}
 
 			template<typename BlendF>
@@ -94,59 +185,51 @@ namespace shade
 			}
 
 
-			void ComputePoseRecursevly(animation::Pose* pose, const AnimationController::AnimationControlData& animationData, const Skeleton::BoneNode* bone, const glm::mat4& parentTransform, std::uint32_t parentId)
+			// Bones deeper than maxBoneDepth aren't sampled and keep bind pose
+			void ComputePose(animation::Pose* pose, AnimationController::AnimationControlData& animationData, const Asset<Skeleton>& skeleton, std::uint32_t maxBoneDepth)
 			{
-				glm::mat4 globalMatrix = parentTransform;
-
-				if (const Animation::Channel* channel = animationData.Animation->GetAnimationCahnnel(bone->Name))
-				{
-					Pose::LocalTransform& local = pose->GetBoneLocalTransform(bone->ID);
-					
-					local.Translation = animationData.Animation->InterpolatePosition(*channel, animationData.CurrentPlayTime);
-					local.Rotation = animationData.Animation->InterpolateRotation(*channel, animationData.CurrentPlayTime);
-					local.Scale = animationData.Animation->InterpolateScale(*channel, animationData.CurrentPlayTime);
-
-					globalMatrix *= glm::translate(glm::identity<glm::mat4>(), local.Translation) * glm::toMat4(local.Rotation) * glm::scale(glm::identity<glm::mat4>(), local.Scale);
+				const Skeleton::Hierarchy& hierarchy = skeleton->GetHierarchy();
 
-					pose->GetBoneGlobalTransform(bone->ID) = { globalMatrix, parentId };
-				}
-				else
+				if (!animationData.ChannelBinding || !animationData.ChannelBinding->IsValid(animationData.Animation.Raw(), hierarchy))
 				{
-					globalMatrix *= glm::translate(glm::identity<glm::mat4>(), bone->Translation) * glm::toMat4(bone->Rotation) * glm::scale(glm::identity<glm::mat4>(), bone->Scale);
-					
-					pose->GetBoneGlobalTransform(bone->ID) = { globalMatrix, parentId };
+					animationData.ChannelBinding = animationData.Animation->GetBinding(skeleton.Get());
+					animationData.Cursors.assign(hierarchy.GetBonesCount() + 1, Animation::KeyFrameCursor{});
 				}
 
-				for (const auto& child : bone->Children)
-					ComputePoseRecursevly(pose, animationData, child, globalMatrix, bone->ID);
-			}
-
-			void ComputePose(animation::Pose* pose, const AnimationController::AnimationControlData& animationData, const Asset<Skeleton>& skeleton)
-			{
-				glm::mat4 armatureMatrix = glm::identity<glm::mat4>();
-
-				pose->MarkHasInverseBindPose(false);
+				const Animation::Binding& binding = *animationData.ChannelBinding;
+				const float time = animationData.CurrentPlayTime;
 
 				Pose::LocalTransform& local = pose->GetArmatureLocalTransform();
 
-				if (const Animation::Channel* channel = animationData.Animation->GetAnimationCahnnel(skeleton->GetArmature()->Name))
+				if (binding.ArmatureChannel != Animation::CHANNEL_NULL_INDEX)
 				{
-					local.Translation = animationData.Animation->InterpolatePosition(*channel, animationData.CurrentPlayTime);
-					local.Rotation = animationData.Animation->InterpolateRotation(*channel, animationData.CurrentPlayTime);
-					local.Scale = animationData.Animation->InterpolateScale(*channel, animationData.CurrentPlayTime);
-
-					armatureMatrix = glm::translate(glm::identity<glm::mat4>(), local.Translation) * glm::toMat4(local.Rotation) * glm::scale(glm::identity<glm::mat4>(), local.Scale);
+					animationData.Animation->Sample(binding.ArmatureChannel, time, &animationData.Cursors.back(), local.Translation, local.Rotation, local.Scale);
 				}
 				else
 				{
 					local.Translation	= skeleton->GetArmature()->Translation;
 					local.Rotation		= skeleton->GetArmature()->Rotation;
 					local.Scale			= skeleton->GetArmature()->Scale;
+				}
 
-					armatureMatrix = glm::translate(glm::identity<glm::mat4>(), local.Translation) * glm::toMat4(local.Rotation) * glm::scale(glm::identity<glm::mat4>(), local.Scale);
+				for (std::size_t i = 0; i < hierarchy.GetBonesCount(); ++i)
+				{
+					Pose::LocalTransform& bone = pose->GetBoneLocalTransform(hierarchy.IDs[i]);
+
+					if (binding.Channels[i] != Animation::CHANNEL_NULL_INDEX && hierarchy.Depths[i] <= maxBoneDepth)
+					{
+						animationData.Animation->Sample(binding.Channels[i], time, &animationData.Cursors[i], bone.Translation, bone.Rotation, bone.Scale);
+					}
+					else
+					{
+						// Not animated or skipped by LOD bones keep bind pose, it's written into local transforms as well so blending sees it
+						bone.Translation	= hierarchy.Translations[i];
+						bone.Rotation		= hierarchy.Rotations[i];
+						bone.Scale			= hierarchy.Scales[i];
+					}
 				}
 
-				ComputePoseRecursevly(pose, animationData, skeleton->GetRootNode(), armatureMatrix, ~0);
+				pose->MarkGlobalTransformsDirty();
 			}
 		}
 	}
@@ -207,7 +290,7 @@ shade::animation::Pose* shade::animation::AnimationController::Blend(const Asset
 	}
 	else
 	{
-		utils::BasePoseBlend<utils::BaseBlend>(p0, p1, p2, skeleton, blendFactor, boneMask);
+		utils::BasePoseBlend(p0, p1, p2, skeleton, blendFactor, boneMask);
 	}
 
 	if (p1->HasRootMotion() && p2->HasRootMotion())
@@ -221,13 +304,14 @@ shade::animation::Pose* shade::animation::AnimationController::Blend(const Asset
 
 shade::animation::Pose* shade::animation::AnimationController::BlendTriangular(const Asset<Skeleton>& skeleton, const animation::Pose* aPose, const animation::Pose* bPose, const animation::Pose* cPose, float aBlend, float bBlend, float cBlend, const animation::BoneMask& boneMask)
 {
-	Pose* AB	= ReceiveAnimationPose(skeleton, Pose::Type::Pose, aPose->GetAnimationHash(), bPose->GetAnimationHash());
-	Pose* BC	= ReceiveAnimationPose(skeleton, Pose::Type::Pose, bPose->GetAnimationHash(), cPose->GetAnimationHash());
+	// Partial results are consumed right away, they don't need to outlive the frame
+	Pose* AB	= ReceiveFramePose(skeleton, aPose->GetAnimationHash(), bPose->GetAnimationHash());
+	Pose* BC	= ReceiveFramePose(skeleton, bPose->GetAnimationHash(), cPose->GetAnimationHash());
 	Pose* AB_BC = ReceiveAnimationPose(skeleton, Pose::Type::Pose, AB->GetAnimationHash(), BC->GetAnimationHash());
 
-	utils::BasePoseBlend<utils::BaseBlend>(AB, aPose, bPose, skeleton, aBlend, boneMask);
-	utils::BasePoseBlend<utils::BaseBlend>(BC, bPose, cPose, skeleton, bBlend, boneMask);
-	utils::BasePoseBlend<utils::BaseBlend>(AB_BC, AB, BC, skeleton, cBlend, boneMask);
+	utils::BasePoseBlend(AB, aPose, bPose, skeleton, aBlend, boneMask);
+	utils::BasePoseBlend(BC, bPose, cPose, skeleton, bBlend, boneMask);
+	utils::BasePoseBlend(AB_BC, AB, BC, skeleton, cBlend, boneMask);
 
 	return AB_BC;
 }
@@ -241,7 +325,7 @@ shade::animation::Pose* shade::animation::AnimationController::GenerateAdditiveP
 {
 	Pose* additivePose = ReceiveAnimationPose(skeleton, Pose::Type::AdditivePose, referencePose->GetAnimationHash(), basePose->GetAnimationHash());
 
-	for (std::size_t i = 0; i < additivePose->GetBoneLocalTransforms()->size(); ++i)
+	for (std::size_t i = 0; i < additivePose->GetBoneLocalTransforms().size(); ++i)
 	{
 		/*const glm::mat4& rMat = referencePose->GetBoneLocalTransform(i);
 		const glm::mat4& bMat = basePose->GetBoneLocalTransform(i);
@@ -253,8 +337,27 @@ shade::animation::Pose* shade::animation::AnimationController::GenerateAdditiveP
 
 shade::animation::Pose* shade::animation::AnimationController::CreatePose(const Asset<Skeleton>& skeleton, Pose::Type type, std::size_t hash)
 {
-	if (m_Poses.find(hash) == m_Poses.end()) m_Poses.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(skeleton, hash));
-	return &m_Poses.at(hash);
+	Pose& pose = m_Poses.try_emplace(hash, skeleton, hash).first->second;
+	// Pose keeps its timing and root motion between frames, transforms are taken from arena of evaluating thread once per frame
+	if (pose.GetFrame() != PoseArena::GetFrame()) pose.Acquire(PoseArena::Get());
+	return &pose;
+}
+
+shade::animation::Pose* shade::animation::AnimationController::ReceiveFramePose(const Asset<Skeleton>& skeleton, std::size_t hash)
+{
+	if (m_Frame != PoseArena::GetFrame())
+	{
+		m_Frame = PoseArena::GetFrame(); m_FramePosesCount = 0u;
+	}
+
+	if (m_FramePosesCount == m_FramePoses.size())
+		m_FramePoses.emplace_back(std::make_unique<Pose>(skeleton, hash));
+	else
+		*m_FramePoses[m_FramePosesCount] = Pose(skeleton, hash);
+
+	Pose* pose = m_FramePoses[m_FramePosesCount++].get();
+	pose->Acquire(PoseArena::Get());
+	return pose;
 }
 
 shade::animation::Pose* shade::animation::AnimationController::CalculatePose(animation::Pose* targetPose, AnimationControlData& animationData, const FrameTimer& deltaTime, float timeMultiplier)
@@ -338,7 +441,7 @@ shade::animation::Pose* shade::animation::AnimationController::CalculatePose(ani
 #endif // 0
 
 
-	utils::ComputePose(targetPose, animationData, targetPose->GetSkeleton());
+	utils::ComputePose(targetPose, animationData, targetPose->GetSkeleton(), m_MaxBoneDepth);
 
 	targetPose->SetDuration(animationData.Duration); targetPose->SetCurrentPlayTime(animationData.CurrentPlayTime);
 
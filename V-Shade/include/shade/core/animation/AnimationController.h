@@ -14,10 +14,29 @@ namespace shade
 	*/
 	namespace animation
 	{
+		namespace utils
+		{
+			// Blend local transforms of bones [0, count) with per bone weights, out may alias first or second
+			SHADE_API void BlendLocalTransforms(Pose::LocalTransform* out, const Pose::LocalTransform* first, const Pose::LocalTransform* second, const float* weights, std::size_t count);
+			// Same with one weight for all bones, used by full bone mask
+			SHADE_API void BlendLocalTransforms(Pose::LocalTransform* out, const Pose::LocalTransform* first, const Pose::LocalTransform* second, float weight, std::size_t count);
+
+			// Finalizer of splitmix64, every input bit affects every output bit
+			SHADE_INLINE constexpr std::uint64_t MixHash(std::uint64_t value)
+			{
+				value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+				value = (value ^ (value >> 27u)) * 0x94D049BB133111EBull;
+				return value ^ (value >> 31u);
+			}
+		}
+
+		// Order dependent combination, so equal or swapped arguments don't cancel each other like with xor
 		template<typename... Args>
 		std::size_t PointerHashCombine(Args&&... args)
 		{
-			return (static_cast<std::size_t>(std::decay_t<Args>(std::forward<Args>(args))) ^ ...);
+			std::uint64_t seed = 0u;
+			((seed = utils::MixHash(seed * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(static_cast<std::size_t>(std::decay_t<Args>(std::forward<Args>(args)))))), ...);
+			return static_cast<std::size_t>(seed);
 		}
 
 		class SHADE_API AnimationController
@@ -40,6 +59,10 @@ namespace shade
 				Asset<Animation>		Animation;
 				Animation::State		State  = Animation::State::Play;
 				Pose::RootMotion*		RootMotion = nullptr;
+				// Resolved channels of Animation for the skeleton, refreshed when animation or skeleton changes
+				std::shared_ptr<const Animation::Binding> ChannelBinding;
+				// Key frame cursors per bone in Skeleton::Hierarchy order, last one is armature's
+				std::vector<Animation::KeyFrameCursor> Cursors;
 				float					Start  = 0.f, End = 0.f, Duration = 0.f, CurrentPlayTime = 0.f, TicksPerSecond = 0.f;
 				bool					IsLoop = true;
 				bool					HasRootMotion = false;
@@ -89,22 +112,40 @@ namespace shade
 
 			std::pair<float, float> GetTimeMultiplier(float firstDuration, float secondDuration, float blendFactor) const;
 
+			// Bones deeper in hierarchy than this aren't sampled by animations and keep bind pose, used by animation LOD
+			SHADE_INLINE void SetMaxBoneDepth(std::uint32_t depth) { m_MaxBoneDepth = depth; }
+			SHADE_INLINE std::uint32_t GetMaxBoneDepth() const { return m_MaxBoneDepth; }
+
 		private:
 			AnimationController() = default;
-			std::unordered_map<std::size_t, animation::Pose> m_Poses; //NOTE: Thats can be a problem !!
+			// Poses which keep state between frames : play time, duration and root motion. Graph endpoints read them in later frames as well,
+			// so only headers live here, their transforms are taken from PoseArena every frame
+			std::unordered_map<std::size_t, animation::Pose> m_Poses;
+			// Intermediate poses of current frame which nothing reads later, headers are reused every frame
+			std::vector<std::unique_ptr<animation::Pose>> m_FramePoses;
+			std::size_t m_FramePosesCount = 0;
+			std::uint64_t m_Frame = ~0ull;
+			std::uint32_t m_MaxBoneDepth = ~0u;
 			
 			friend class SharedPointer<AnimationController>;
 		private:
 			animation::Pose* CreatePose(const Asset<Skeleton>& skeleton, Pose::Type type, std::size_t hash);
 			animation::Pose* CalculatePose(animation::Pose* targetPose, AnimationControlData& animationData, const FrameTimer& deltaTime, float timeMultiplier = 1.f);
 			animation::Pose* ReceiveAnimationPose(const Asset<Skeleton>& skeleton, Pose::Type type, std::size_t hash);
+			animation::Pose* ReceiveFramePose(const Asset<Skeleton>& skeleton, std::size_t hash);
 		
 			template<typename... Args>
 			inline animation::Pose* ReceiveAnimationPose(const Asset<Skeleton>& skeleton, Pose::Type type, Args&&... args)
 			{
-				(CreatePose(skeleton, type, animation::PointerHashCombine(type, args)), ...);
 				return CreatePose(skeleton, type, animation::PointerHashCombine(type, std::forward<Args>(args)...));
 			}
+
+			// Hash is the same as persistent pose of these arguments would have, so poses blended from it get the same hash
+			template<typename... Args>
+			inline animation::Pose* ReceiveFramePose(const Asset<Skeleton>& skeleton, Args&&... args)
+			{
+				return ReceiveFramePose(skeleton, animation::PointerHashCombine(Pose::Type::Pose, std::forward<Args>(args)...));
+			}
 		};
 	}
 
@@ -0,0 +1,76 @@
+#include "shade_pch.h"
+#include "AnimationLod.h"
+
+shade::animation::AnimationLod::Policy::Policy()
+{
+	// Near levels run at full rate, every next three levels halve update rate, far ones drop fingers and other leaf bones
+	for (std::size_t i = 0; i < LEVELS_COUNT; ++i)
+	{
+		Levels[i].UpdateRate	= 1u << (i / 3u);
+		Levels[i].MaxBoneDepth	= (i < LEVELS_COUNT * 6 / 10) ? ~0u : (i < LEVELS_COUNT - 1) ? 10u : 6u;
+	}
+}
+
+void shade::animation::AnimationLod::Update(AnimationGraph& graph, const FrameTimer& deltaTime)
+{
+	const bool hasResult = !m_Current.empty();
+
+	if (m_Policy.FreezeOffscreen && !m_IsVisible && hasResult)
+	{
+		// Time is frozen as well, interpolation resumes from the pose which was shown
+		m_Previous = m_Current; m_FramesSinceUpdate = m_Interval - 1u;
+
+		if (Pose* pose = graph.GetOutputPose()) Present(*pose, 1.f);
+		return;
+	}
+
+	const Level& level = m_Policy.Levels[m_Level];
+
+	m_AccumulatedTime += deltaTime.GetInSeconds<float>();
+
+	if (!hasResult || ++m_FramesSinceUpdate >= m_Interval)
+	{
+		auto& controller = graph.GetGraphContext()->As<AnimationGraphContext>().GetController();
+		if (controller) controller->SetMaxBoneDepth(level.MaxBoneDepth);
+
+		graph.ProcessBranch(FrameTimer(m_AccumulatedTime));
+
+		m_AccumulatedTime = 0.f; m_FramesSinceUpdate = 0u; m_Interval = std::max(level.UpdateRate, 1u);
+
+		if (const Pose* pose = graph.GetOutputPose()) StoreResult(*pose);
+		// Full rate, fresh result is shown as is
+		if (m_Interval == 1u) return;
+	}
+
+	if (Pose* pose = graph.GetOutputPose())
+	{
+		if (!m_Current.empty()) Present(*pose, static_cast<float>(m_FramesSinceUpdate + 1u) / static_cast<float>(m_Interval));
+	}
+}
+
+void shade::animation::AnimationLod::StoreResult(const Pose& pose)
+{
+	const auto locals = pose.GetBoneLocalTransforms();
+
+	std::swap(m_Previous, m_Current);
+
+	m_Current.assign(locals.begin(), locals.end());
+	m_Current.emplace_back(pose.GetArmatureLocalTransform());
+
+	// Nothing to interpolate from after skeleton change or first evaluation
+	if (m_Previous.size() != m_Current.size()) m_Previous = m_Current;
+}
+
+void shade::animation::AnimationLod::Present(Pose& pose, float factor)
+{
+	// Pose hasn't been evaluated this frame, so its transforms from arena are stale
+	if (pose.GetFrame() != PoseArena::GetFrame()) pose.Acquire(PoseArena::Get());
+
+	const auto locals = pose.GetBoneLocalTransforms();
+	const std::size_t count = std::min(locals.size(), m_Current.size() - 1u);
+
+	utils::BlendLocalTransforms(locals.data(), m_Previous.data(), m_Current.data(), factor, count);
+	utils::BlendLocalTransforms(&pose.GetArmatureLocalTransform(), &m_Previous.back(), &m_Current.back(), factor, 1u);
+
+	pose.MarkGlobalTransformsDirty();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <shade/core/animation/graphs/AnimationGraph.h>
+#include <shade/core/render/drawable/Drawable.h>
+
+namespace shade
+{
+	namespace animation
+	{
+		// Animation level of detail of a single graph instance.
+		// Renderer writes level (from camera distance) and visibility of the model, graph update of the next frame uses them to
+		// evaluate the graph only every n-th frame with accumulated time, sample bones only up to some depth and freeze offscreen characters.
+		// Between evaluations output pose is interpolated from two last results, so throttled characters move smoothly one interval behind.
+		class SHADE_API AnimationLod
+		{
+		public:
+			struct Level
+			{
+				// Graph is evaluated once per UpdateRate frames
+				std::uint32_t UpdateRate = 1u;
+				// Bones deeper in hierarchy keep bind pose
+				std::uint32_t MaxBoneDepth = ~0u;
+			};
+
+			static constexpr std::size_t LEVELS_COUNT = Drawable::MAX_LEVEL_OF_DETAIL;
+
+			struct Policy
+			{
+				Policy();
+				// Level index is the one Renderer::GetLodLevelBasedOnDistance returns for LEVELS_COUNT
+				std::array<Level, LEVELS_COUNT> Levels;
+				// Stop evaluating graph while model is out of camera frustum, last pose is kept
+				bool FreezeOffscreen = true;
+			};
+		public:
+			AnimationLod() = default;
+			~AnimationLod() = default;
+		public:
+			// Process graph for current frame according to LOD state, use it instead of AnimationGraph::ProcessBranch, graph instance has to be bound already
+			void Update(AnimationGraph& graph, const FrameTimer& deltaTime);
+
+			// Called by renderer once model has been processed
+			SHADE_INLINE void SetState(std::size_t level, bool isVisible) { m_Level = std::min(level, LEVELS_COUNT - 1); m_IsVisible = isVisible; }
+			SHADE_INLINE std::size_t GetLevel() const { return m_Level; }
+			SHADE_INLINE bool IsVisible() const { return m_IsVisible; }
+
+			SHADE_INLINE const Policy& GetPolicy() const { return m_Policy; }
+			SHADE_INLINE Policy& GetPolicy() { return m_Policy; }
+		private:
+			void StoreResult(const Pose& pose);
+			void Present(Pose& pose, float factor);
+		private:
+			Policy								m_Policy;
+			// Local transforms of two last evaluations, last element is armature transform
+			std::vector<Pose::LocalTransform>	m_Previous, m_Current;
+			std::size_t							m_Level = 0;
+			bool								m_IsVisible = true;
+			std::uint32_t						m_FramesSinceUpdate = 0, m_Interval = 1;
+			float								m_AccumulatedTime = 0.f;
+		};
+	}
+}
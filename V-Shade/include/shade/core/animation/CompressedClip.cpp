@@ -0,0 +1,337 @@
+#include "shade_pch.h"
+#include "CompressedClip.h"
+
+namespace
+{
+	// Three smallest components of normalized quaternion are within [-1/sqrt(2), 1/sqrt(2)]
+	constexpr float			QUAT_COMPONENT_RANGE	= 0.70710678f;
+	constexpr std::uint32_t	QUAT_COMPONENT_BITS		= 15u;
+	constexpr float			QUAT_COMPONENT_MAX		= float((1u << QUAT_COMPONENT_BITS) - 1u);
+	constexpr float			VECTOR_COMPONENT_MAX	= 65535.f;
+
+	// 2 bits of largest component index and 3 x 15 bits of others, spread over 3 words
+	void PackRotation(const glm::vec4& rotation, std::uint16_t* words)
+	{
+		std::uint32_t largest = 0u;
+		for (std::uint32_t i = 1u; i < 4u; ++i)
+			if (glm::abs(rotation[i]) > glm::abs(rotation[largest])) largest = i;
+
+		// q and -q are the same rotation, keep largest component positive so it can be restored from the others
+		const float sign = (rotation[largest] < 0.f) ? -1.f : 1.f;
+
+		std::uint64_t bits = largest;
+		for (std::uint32_t i = 0u, shift = 2u; i < 4u; ++i)
+		{
+			if (i == largest) continue;
+
+			const float normalized = glm::clamp(rotation[i] * sign / QUAT_COMPONENT_RANGE, -1.f, 1.f) * 0.5f + 0.5f;
+			bits |= std::uint64_t(normalized * QUAT_COMPONENT_MAX + 0.5f) << shift;
+			shift += QUAT_COMPONENT_BITS;
+		}
+
+		words[0] = std::uint16_t(bits);
+		words[1] = std::uint16_t(bits >> 16u);
+		words[2] = std::uint16_t(bits >> 32u);
+	}
+
+	glm::vec4 UnpackRotation(const std::uint16_t* words)
+	{
+		const std::uint64_t bits = std::uint64_t(words[0]) | (std::uint64_t(words[1]) << 16u) | (std::uint64_t(words[2]) << 32u);
+		const std::uint32_t largest = std::uint32_t(bits & 0x3u);
+
+		glm::vec4 rotation; float sum = 0.f;
+		for (std::uint32_t i = 0u, shift = 2u; i < 4u; ++i)
+		{
+			if (i == largest) continue;
+
+			const float normalized = float((bits >> shift) & std::uint64_t(QUAT_COMPONENT_MAX)) / QUAT_COMPONENT_MAX;
+			rotation[i] = (normalized * 2.f - 1.f) * QUAT_COMPONENT_RANGE;
+			sum += rotation[i] * rotation[i];
+			shift += QUAT_COMPONENT_BITS;
+		}
+		rotation[largest] = glm::sqrt(glm::max(0.f, 1.f - sum));
+
+		return rotation;
+	}
+
+	void PackVector(const glm::vec3& value, const glm::vec3& base, const glm::vec3& extent, std::uint16_t* words)
+	{
+		for (std::uint32_t i = 0u; i < 3u; ++i)
+			words[i] = (extent[i] > 0.f) ? std::uint16_t(glm::clamp((value[i] - base[i]) / extent[i], 0.f, 1.f) * VECTOR_COMPONENT_MAX + 0.5f) : 0u;
+	}
+
+	glm::vec3 UnpackVector(const glm::vec3& base, const glm::vec3& extent, const std::uint16_t* words)
+	{
+		return base + extent * glm::vec3(float(words[0]), float(words[1]), float(words[2])) / VECTOR_COMPONENT_MAX;
+	}
+
+	// Raw key keeps value bit exact, used when quantization alone exceeds tolerance
+	void PackRaw(const glm::vec4& value, std::uint16_t* words)
+	{
+		std::memcpy(words, &value[0], sizeof(float) * 4u);
+	}
+
+	glm::vec4 UnpackRaw(const std::uint16_t* words)
+	{
+		glm::vec4 value; std::memcpy(&value[0], words, sizeof(float) * 4u);
+		return value;
+	}
+
+	SHADE_INLINE std::uint32_t GetWordsPerKey(const shade::animation::CompressedClip::Track& track)
+	{
+		return (track.Type == shade::animation::CompressedClip::TrackType::Raw) ? shade::animation::CompressedClip::WORDS_PER_RAW_KEY : shade::animation::CompressedClip::WORDS_PER_KEY;
+	}
+
+	glm::vec4 Interpolate(const glm::vec4& first, const glm::vec4& second, float factor, bool isRotation)
+	{
+		if (isRotation)
+		{
+			// Keys are close to each other, so normalized lerp is enough and error bound was checked with it
+			const glm::vec4 end = (glm::dot(first, second) < 0.f) ? -second : second;
+			return glm::normalize(glm::mix(first, end, factor));
+		}
+
+		return glm::mix(first, second, factor);
+	}
+
+	float Error(const glm::vec4& first, const glm::vec4& second, bool isRotation)
+	{
+		// Angle between rotations from chord length, it keeps precision for small angles unlike acos of dot
+		if (isRotation)
+			return 4.f * glm::asin(glm::min(glm::length(first - ((glm::dot(first, second) < 0.f) ? -second : second)) * 0.5f, 1.f));
+
+		return glm::length(glm::vec3(first) - glm::vec3(second));
+	}
+
+	SHADE_INLINE glm::vec4 ToVec4(const glm::quat& rotation)	{ return glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w); }
+	SHADE_INLINE glm::quat ToQuat(const glm::vec4& rotation)	{ return glm::quat(rotation.w, rotation.x, rotation.y, rotation.z); }
+}
+
+float shade::animation::CompressionSettings::GetToleranceMultiplier(const std::string& bone) const
+{
+	const auto it = BoneTolerances.find(bone);
+	return (it != BoneTolerances.end()) ? it->second : 1.f;
+}
+
+void shade::animation::CompressedClip::Initialize(float duration, float ticksPerSecond, float sampleRate)
+{
+	m_Channels.clear();
+	m_Samples.clear();
+
+	const float framesPerTick = sampleRate / ((ticksPerSecond > 0.f) ? ticksPerSecond : sampleRate);
+
+	// Rate is adjusted a bit so the last frame lands exactly on the end of animation
+	m_FramesCount	= (duration > 0.f) ? static_cast<std::uint32_t>(glm::ceil(duration * framesPerTick)) + 1u : 1u;
+	m_FrameRate		= (duration > 0.f) ? float(m_FramesCount - 1u) / duration : 0.f;
+}
+
+std::uint32_t shade::animation::CompressedClip::AddChannel(const std::function<glm::vec3(float)>& translation, const std::function<glm::quat(float)>& rotation, const std::function<glm::vec3(float)>& scale, float toleranceMultiplier, const CompressionSettings& settings, const BindPose* bindPose, const SourceKeys* sourceKeys)
+{
+	std::vector<glm::vec4> translations(m_FramesCount), rotations(m_FramesCount), scales(m_FramesCount);
+
+	for (std::uint32_t frame = 0u; frame < m_FramesCount; ++frame)
+	{
+		const float time = (m_FrameRate > 0.f) ? float(frame) / m_FrameRate : 0.f;
+
+		translations[frame]	= glm::vec4(translation(time), 0.f);
+		rotations[frame]	= ToVec4(glm::normalize(rotation(time)));
+		scales[frame]		= glm::vec4(scale(time), 0.f);
+	}
+
+	Channel& channel = m_Channels.emplace_back();
+
+	channel.Translation	= CompressTrack(translations, (sourceKeys) ? &sourceKeys->Translation : nullptr, false, settings.TranslationTolerance * toleranceMultiplier);
+	channel.Rotation	= CompressTrack(rotations, (sourceKeys) ? &sourceKeys->Rotation : nullptr, true, settings.RotationTolerance * toleranceMultiplier);
+	channel.Scale		= CompressTrack(scales, (sourceKeys) ? &sourceKeys->Scale : nullptr, false, settings.ScaleTolerance * toleranceMultiplier);
+
+	// Constant tracks don't write samples, so static bone can be removed without touching them
+	if (bindPose &&
+		channel.Translation.Type == TrackType::Constant && Error(channel.Translation.Base, glm::vec4(bindPose->Translation, 0.f), false) <= settings.TranslationTolerance * toleranceMultiplier &&
+		channel.Rotation.Type == TrackType::Constant && Error(channel.Rotation.Base, ToVec4(bindPose->Rotation), true) <= settings.RotationTolerance * toleranceMultiplier &&
+		channel.Scale.Type == TrackType::Constant && Error(channel.Scale.Base, glm::vec4(bindPose->Scale, 0.f), false) <= settings.ScaleTolerance * toleranceMultiplier)
+	{
+		m_Channels.pop_back();
+		return CHANNEL_NULL_INDEX;
+	}
+
+	return static_cast<std::uint32_t>(m_Channels.size() - 1u);
+}
+
+shade::animation::CompressedClip::Track shade::animation::CompressedClip::CompressTrack(const std::vector<glm::vec4>& frames, const std::vector<SourceKey>* sourceKeys, bool isRotation, float tolerance)
+{
+	Track track;
+
+	const auto isConstant = [&](const glm::vec4& value) { return Error(value, frames.front(), isRotation) <= tolerance; };
+	// Single frame can't hold anything else
+	if (m_FramesCount < 2u || (std::all_of(frames.begin(), frames.end(), isConstant) &&
+		(!sourceKeys || std::all_of(sourceKeys->begin(), sourceKeys->end(), [&](const SourceKey& key) { return isConstant(key.Value); }))))
+	{
+		track.Type = TrackType::Constant;
+		track.Base = frames.front();
+		return track;
+	}
+
+	if (!isRotation)
+	{
+		glm::vec3 min = frames.front(), max = frames.front();
+		for (const glm::vec4& frame : frames)
+		{
+			min = glm::min(min, glm::vec3(frame));
+			max = glm::max(max, glm::vec3(frame));
+		}
+		// Source keys between frames can be out of frames range
+		if (sourceKeys)
+		{
+			for (const SourceKey& key : *sourceKeys)
+			{
+				min = glm::min(min, glm::vec3(key.Value));
+				max = glm::max(max, glm::vec3(key.Value));
+			}
+		}
+		track.Base		= glm::vec4(min, 0.f);
+		track.Extent	= max - min;
+	}
+
+	const std::uint32_t last = m_FramesCount - 1u;
+
+	std::uint32_t largestStride = 1u;
+	while (largestStride * 2u <= last) largestStride *= 2u;
+
+	std::vector<std::uint16_t> keys;
+
+	// Quantized keys are tried first, raw ones when quantization alone exceeds tolerance even with stride 1
+	for (const TrackType type : { TrackType::Animated, TrackType::Raw })
+	{
+		track.Type = type;
+
+		for (std::uint32_t stride = largestStride; stride; stride /= 2u)
+		{
+			track.Stride	= stride;
+			track.Count		= (last + stride - 1u) / stride + 1u;
+			track.Offset	= 0u;
+
+			const std::uint32_t wordsPerKey = GetWordsPerKey(track);
+			keys.resize(track.Count * wordsPerKey);
+			for (std::uint32_t key = 0u; key < track.Count; ++key)
+			{
+				const glm::vec4& frame = frames[std::min(key * stride, last)];
+
+				if (type == TrackType::Raw)
+					PackRaw(frame, &keys[key * wordsPerKey]);
+				else if (isRotation)
+					PackRotation(frame, &keys[key * wordsPerKey]);
+				else
+					PackVector(frame, track.Base, track.Extent, &keys[key * wordsPerKey]);
+			}
+
+			if (IsWithinTolerance(track, keys.data(), frames, sourceKeys, isRotation, tolerance))
+			{
+				track.Offset = static_cast<std::uint32_t>(m_Samples.size());
+				m_Samples.insert(m_Samples.end(), keys.begin(), keys.end());
+				return track;
+			}
+		}
+	}
+
+	// Raw keys with stride 1 match resampled frames exactly, so only source keys between frames can be missed
+	SHADE_CORE_WARNING("Animation track exceeds compression tolerance, sample rate is too low for its source keys!");
+
+	track.Offset = static_cast<std::uint32_t>(m_Samples.size());
+	m_Samples.insert(m_Samples.end(), keys.begin(), keys.end());
+
+	return track;
+}
+
+bool shade::animation::CompressedClip::IsWithinTolerance(const Track& track, const std::uint16_t* samples, const std::vector<glm::vec4>& frames, const std::vector<SourceKey>* sourceKeys, bool isRotation, float tolerance) const
+{
+	for (std::uint32_t frame = 0u; frame < frames.size(); ++frame)
+	{
+		if (Error(DecodeTrack(track, samples, isRotation, float(frame)), frames[frame], isRotation) > tolerance)
+			return false;
+	}
+
+	if (sourceKeys)
+	{
+		for (const SourceKey& key : *sourceKeys)
+		{
+			if (Error(DecodeTrack(track, samples, isRotation, key.Time * m_FrameRate), key.Value, isRotation) > tolerance)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+glm::vec4 shade::animation::CompressedClip::DecodeTrack(const Track& track, const std::uint16_t* samples, bool isRotation, float frame) const
+{
+	if (track.Type == TrackType::Constant)
+		return track.Base;
+
+	frame = glm::max(frame, 0.f);
+
+	// Last key holds the last frame, so the last segment can be shorter than stride
+	const std::uint32_t key = std::min(static_cast<std::uint32_t>(frame) / track.Stride, track.Count - 2u);
+	const float start = float(key * track.Stride), end = float(std::min((key + 1u) * track.Stride, m_FramesCount - 1u));
+	const float factor = glm::min((frame - start) / (end - start), 1.f);
+
+	const std::uint32_t wordsPerKey = GetWordsPerKey(track);
+	const std::uint16_t* first = samples + track.Offset + key * wordsPerKey, *second = first + wordsPerKey;
+
+	if (track.Type == TrackType::Raw)
+		return Interpolate(UnpackRaw(first), UnpackRaw(second), factor, isRotation);
+
+	if (isRotation)
+		return Interpolate(UnpackRotation(first), UnpackRotation(second), factor, true);
+
+	const glm::vec3 base = track.Base;
+	return Interpolate(glm::vec4(UnpackVector(base, track.Extent, first), 0.f), glm::vec4(UnpackVector(base, track.Extent, second), 0.f), factor, false);
+}
+
+void shade::animation::CompressedClip::Sample(std::uint32_t index, float time, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const
+{
+	assert(index < m_Channels.size());
+
+	const Channel& channel = m_Channels[index];
+	const float frame = time * m_FrameRate;
+
+	translation	= DecodeTrack(channel.Translation, m_Samples.data(), false, frame);
+	rotation	= ToQuat(DecodeTrack(channel.Rotation, m_Samples.data(), true, frame));
+	scale		= DecodeTrack(channel.Scale, m_Samples.data(), false, frame);
+}
+
+std::size_t shade::animation::CompressedClip::GetMemoryUsage() const
+{
+	return m_Channels.size() * sizeof(Channel) + m_Samples.size() * sizeof(std::uint16_t);
+}
+
+void shade::animation::CompressedClip::Serialize(std::ostream& stream) const
+{
+	serialize::Serializer::Serialize(stream, m_FramesCount);
+	serialize::Serializer::Serialize(stream, m_FrameRate);
+
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(m_Channels.size()));
+	if (!m_Channels.empty())
+		serialize::Serializer::Serialize(stream, m_Channels.front(), m_Channels.size());
+
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(m_Samples.size()));
+	if (!m_Samples.empty())
+		serialize::Serializer::Serialize(stream, m_Samples.front(), m_Samples.size());
+}
+
+void shade::animation::CompressedClip::Deserialize(std::istream& stream)
+{
+	std::uint32_t channels = 0u, samples = 0u;
+
+	serialize::Serializer::Deserialize(stream, m_FramesCount);
+	serialize::Serializer::Deserialize(stream, m_FrameRate);
+
+	serialize::Serializer::Deserialize(stream, channels);
+	m_Channels.resize(channels);
+	if (channels)
+		serialize::Serializer::Deserialize(stream, m_Channels.front(), m_Channels.size());
+
+	serialize::Serializer::Deserialize(stream, samples);
+	m_Samples.resize(samples);
+	if (samples)
+		serialize::Serializer::Deserialize(stream, m_Samples.front(), m_Samples.size());
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/math/Math.h>
+#include <glm/glm/gtx/quaternion.hpp>
+#include <shade/core/serializing/Serializer.h>
+
+namespace shade
+{
+	namespace animation
+	{
+		struct SHADE_API CompressionSettings
+		{
+			// Max error of bone local transform after compression, translation in model units, rotation in radians
+			float TranslationTolerance	= 0.0001f;
+			float RotationTolerance		= 0.0005f;
+			float ScaleTolerance		= 0.0001f;
+			// Source keys are resampled with this rate (samples per second) before key reduction, 0 means rate of source animation
+			float SampleRate			= 0.f;
+			// Tolerance multiplier per bone name, use values below 1 for bones with long chains under them (root, spine)
+			std::unordered_map<std::string, float> BoneTolerances;
+
+			float GetToleranceMultiplier(const std::string& bone) const;
+		};
+
+		// Runtime storage of animation channels.
+		// Tracks are resampled uniformly, constant tracks keep a single value, animated ones keep every n-th frame,
+		// n is chosen per track as the largest stride whose reconstruction stays within tolerance of resampled frames and source keys.
+		// Rotations are quantized as smallest three into 48 bits, translations and scales into 16 bits per component
+		// of their own range. Track which can't meet tolerance with quantization keeps raw floats.
+		// Keys of a track are stored next to each other and decoded without any search.
+		class SHADE_API CompressedClip
+		{
+		public:
+			enum class TrackType : std::uint8_t
+			{
+				Constant,
+				Animated,
+				Raw
+			};
+
+			struct Track
+			{
+				TrackType		Type = TrackType::Constant;
+				// Key is stored for every Stride frame, Count keys start at Offset in samples
+				std::uint32_t	Stride = 1u;
+				std::uint32_t	Count = 0u;
+				std::uint32_t	Offset = 0u;
+				// Value of constant track or range minimum of animated translation and scale
+				glm::vec4		Base = glm::vec4(0.f);
+				glm::vec3		Extent = glm::vec3(0.f);
+			};
+
+			struct Channel
+			{
+				Track Translation, Rotation, Scale;
+			};
+
+			// Key of source animation, time in ticks, rotation is stored as (x, y, z, w)
+			struct SourceKey
+			{
+				float		Time;
+				glm::vec4	Value;
+			};
+			// Original keys of channel, reconstruction error is measured against them as well as against resampled frames
+			struct SourceKeys
+			{
+				std::vector<SourceKey> Translation, Rotation, Scale;
+			};
+
+			// Bind pose local transform of bone, channel which keeps it during whole clip isn't stored
+			struct BindPose
+			{
+				glm::vec3 Translation;
+				glm::quat Rotation;
+				glm::vec3 Scale;
+			};
+
+			// Every quantized key takes 3 words : three quantized components or packed smallest three rotation
+			static constexpr std::uint32_t WORDS_PER_KEY = 3u;
+			// Every raw key takes 4 floats
+			static constexpr std::uint32_t WORDS_PER_RAW_KEY = 8u;
+			static constexpr std::uint32_t CHANNEL_NULL_INDEX = ~0u;
+		public:
+			CompressedClip() = default;
+			~CompressedClip() = default;
+		public:
+			// Set timeline of clip, time is measured in ticks as in source animation
+			void Initialize(float duration, float ticksPerSecond, float sampleRate);
+			// Resample, reduce and quantize source channel with given tolerances, sources are called in ascending time (ticks) order.
+			// Returns index of added channel or CHANNEL_NULL_INDEX if channel keeps bind pose and wasn't added
+			std::uint32_t AddChannel(const std::function<glm::vec3(float)>& translation, const std::function<glm::quat(float)>& rotation, const std::function<glm::vec3(float)>& scale, float toleranceMultiplier, const CompressionSettings& settings, const BindPose* bindPose = nullptr, const SourceKeys* sourceKeys = nullptr);
+
+			void Sample(std::uint32_t channel, float time, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) const;
+
+			SHADE_INLINE bool IsEmpty() const { return m_Channels.empty(); }
+			SHADE_INLINE std::uint32_t GetFramesCount() const { return m_FramesCount; }
+			SHADE_INLINE std::size_t GetChannelsCount() const { return m_Channels.size(); }
+			SHADE_INLINE const Channel& GetChannel(std::uint32_t index) const { return m_Channels[index]; }
+			// Size of channels and samples in bytes
+			std::size_t GetMemoryUsage() const;
+		private:
+			Track CompressTrack(const std::vector<glm::vec4>& frames, const std::vector<SourceKey>* sourceKeys, bool isRotation, float tolerance);
+			bool IsWithinTolerance(const Track& track, const std::uint16_t* samples, const std::vector<glm::vec4>& frames, const std::vector<SourceKey>* sourceKeys, bool isRotation, float tolerance) const;
+			glm::vec4 DecodeTrack(const Track& track, const std::uint16_t* samples, bool isRotation, float frame) const;
+
+			void Serialize(std::ostream& stream) const;
+			void Deserialize(std::istream& stream);
+		private:
+			friend class serialize::Serializer;
+		private:
+			std::vector<Channel>		m_Channels;
+			std::vector<std::uint16_t>	m_Samples;
+			std::uint32_t				m_FramesCount = 0u;
+			// Frames per tick
+			float						m_FrameRate = 0.f;
+		};
+	}
+
+	/* Serialize CompressedClip.*/
+	template<>
+	SHADE_INLINE void serialize::Serializer::Serialize(std::ostream& stream, const animation::CompressedClip& clip)
+	{
+		return clip.Serialize(stream);
+	}
+	/* Deserialize CompressedClip.*/
+	template<>
+	SHADE_INLINE void serialize::Serializer::Deserialize(std::istream& stream, animation::CompressedClip& clip)
+	{
+		return clip.Deserialize(stream);
+	}
+}
@@ -6,37 +6,73 @@
 shade::animation::Pose::Pose(const Asset<Skeleton>& skeleton, std::size_t animationHash, Type type) :
 	m_Skeleton(skeleton),
 	m_AnimationCombinationHash(animationHash),
-	m_GlobalTransforms(SharedPointer<std::vector<GlobalTransform>>::Create()),
-	m_LocalTransforms(SharedPointer<std::vector<LocalTransform>>::Create()),
 	m_Type(type)
 {
-	Reset();
 }
 
 void shade::animation::Pose::Reset()
 {
-	//m_GlobalTransforms->clear(); // mby dont need to clear, resize will do this ??
-	m_GlobalTransforms->resize(RenderAPI::MAX_BONES_PER_INSTANCE, GlobalTransform());
+	std::uninitialized_fill_n(m_GlobalTransforms, m_GlobalTransformsCount, GlobalTransform());
+	std::uninitialized_fill_n(m_LocalTransforms, m_LocalTransformsCount, LocalTransform());
+
+	m_IsGlobalTransformsDirty = false; m_HasInverseBindPose = false;
+}
+
+void shade::animation::Pose::Acquire(PoseArena& arena)
+{
+	// Both are indexed by bone ID over whole hierarchy, global ones are never shorter than uploaded palette
+	m_LocalTransformsCount	= (m_Skeleton) ? m_Skeleton->GetHierarchy().GetBonesCount() : 0u;
+	m_GlobalTransformsCount	= std::max<std::size_t>(m_LocalTransformsCount, RenderAPI::MAX_BONES_PER_INSTANCE);
+
+	m_GlobalTransforms	= arena.Allocate<GlobalTransform>(m_GlobalTransformsCount);
+	m_LocalTransforms	= arena.Allocate<LocalTransform>(m_LocalTransformsCount);
+	m_Frame				= PoseArena::GetFrame();
+
+	Reset();
+}
+
+void shade::animation::Pose::UpdateGlobalTransforms()
+{
+	if (!m_IsGlobalTransformsDirty || !m_Skeleton)
+		return;
 
-	//m_LocalTransforms->clear();
-	m_LocalTransforms->resize(RenderAPI::MAX_BONES_PER_INSTANCE);
+	auto toMatrix = [](const LocalTransform& local)
+	{
+		return glm::translate(glm::identity<glm::mat4>(), local.Translation) * glm::toMat4(local.Rotation) * glm::scale(glm::identity<glm::mat4>(), local.Scale);
+	};
+
+	const Skeleton::Hierarchy& hierarchy = m_Skeleton->GetHierarchy();
+	const glm::mat4 armatureMatrix = toMatrix(m_ArmatureTransform);
+
+	// Hierarchy order guarantees parents are ready before their children
+	for (std::size_t i = 0; i < hierarchy.GetBonesCount(); ++i)
+	{
+		const Skeleton::BoneID id = hierarchy.IDs[i], parentId = hierarchy.ParentIDs[i];
+
+		const glm::mat4& parentMatrix = (parentId != Skeleton::BONE_NULL_ID) ? GetBoneGlobalTransform(parentId).Transform : armatureMatrix;
+
+		GetBoneGlobalTransform(id) = { parentMatrix * toMatrix(GetBoneLocalTransform(id)), parentId };
+	}
+
+	m_IsGlobalTransformsDirty = false; m_HasInverseBindPose = false;
 }
 
 void shade::animation::Pose::RootMotion::Initialize(const Asset<Skeleton>& skeleton, const Asset<Animation>& aniamtion, float start, float end)
 {
-	if (const Animation::Channel* channel = aniamtion->GetAnimationCahnnel(skeleton->GetArmature()->Name))
+	const std::uint32_t channel = aniamtion->GetAnimationCahnnelIndex(skeleton->GetArmature()->Name);
+
+	if (channel != Animation::CHANNEL_NULL_INDEX)
 	{
 		////       
 
-		Translation.Start = aniamtion->InterpolatePosition(*channel, start);
-		Translation.End = aniamtion->InterpolatePosition(*channel, end);
+		glm::vec3 scale;
+
+		aniamtion->Sample(channel, start, nullptr, Translation.Start, Rotation.Start, scale);
+		aniamtion->Sample(channel, end, nullptr, Translation.End, Rotation.End, scale);
 
 		Translation.Current = Translation.Start;
 		Translation.Delta	= glm::vec3(0.f);
 
-		Rotation.Start = aniamtion->InterpolateRotation(*channel, start);
-		Rotation.End = aniamtion->InterpolateRotation(*channel, end);
-
 		//         !!!!!,    ,  !!
 
 	/*	Rotation.Current	= glm::identity<glm::quat>();
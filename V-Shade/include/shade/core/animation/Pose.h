@@ -3,6 +3,7 @@
 #include <shade/core/memory/Memory.h>
 #include <shade/core/animation/Skeleton.h>
 #include <shade/core/animation/Animation.h>
+#include <shade/core/animation/PoseArena.h>
 
 namespace shade
 {
@@ -62,16 +63,22 @@ namespace shade
 			virtual ~Pose() = default;
 		public:
 			void Reset();
-			SHADE_INLINE const	SharedPointer<std::vector<GlobalTransform>>& GetBoneGlobalTransforms()		const		{ return m_GlobalTransforms; }
-			SHADE_INLINE		SharedPointer<std::vector<GlobalTransform>>& GetBoneGlobalTransforms()					{ return m_GlobalTransforms; }
-			SHADE_INLINE const	SharedPointer<std::vector<LocalTransform>>& GetBoneLocalTransforms()			const	{ return m_LocalTransforms; }
-			SHADE_INLINE		SharedPointer<std::vector<LocalTransform>>& GetBoneLocalTransforms()					{ return m_LocalTransforms; }
+			// Take transforms storage for current frame from arena and reset it, pose itself lives across frames
+			void Acquire(PoseArena& arena);
+			// Frame of PoseArena when transforms were acquired, they are valid only during this frame
+			SHADE_INLINE		std::uint64_t GetFrame()												const	{ return m_Frame; }
 
-			SHADE_INLINE const	GlobalTransform& GetBoneGlobalTransform(std::size_t index)					const	{ assert(index < m_GlobalTransforms->size()); return m_GlobalTransforms.Get()[index]; }
-			SHADE_INLINE		GlobalTransform& GetBoneGlobalTransform(std::size_t index)							{ assert(index < m_GlobalTransforms->size()); return m_GlobalTransforms.Get()[index]; }
+			// Local transforms span bones of skeleton, global ones at least RenderAPI::MAX_BONES_PER_INSTANCE as they are uploaded as is
+			SHADE_INLINE		std::span<const GlobalTransform> GetBoneGlobalTransforms()				const	{ return { m_GlobalTransforms, m_GlobalTransformsCount }; }
+			SHADE_INLINE		std::span<GlobalTransform> GetBoneGlobalTransforms()							{ return { m_GlobalTransforms, m_GlobalTransformsCount }; }
+			SHADE_INLINE		std::span<const LocalTransform> GetBoneLocalTransforms()				const	{ return { m_LocalTransforms, m_LocalTransformsCount }; }
+			SHADE_INLINE		std::span<LocalTransform> GetBoneLocalTransforms()								{ return { m_LocalTransforms, m_LocalTransformsCount }; }
 
-			SHADE_INLINE const	LocalTransform& GetBoneLocalTransform(std::size_t index)						const	{ assert(index < m_LocalTransforms->size()); return m_LocalTransforms.Get()[index]; }
-			SHADE_INLINE		LocalTransform& GetBoneLocalTransform(std::size_t index)								{ assert(index < m_LocalTransforms->size()); return m_LocalTransforms.Get()[index]; }
+			SHADE_INLINE const	GlobalTransform& GetBoneGlobalTransform(std::size_t index)					const	{ assert(index < m_GlobalTransformsCount); return m_GlobalTransforms[index]; }
+			SHADE_INLINE		GlobalTransform& GetBoneGlobalTransform(std::size_t index)							{ assert(index < m_GlobalTransformsCount); return m_GlobalTransforms[index]; }
+
+			SHADE_INLINE const	LocalTransform& GetBoneLocalTransform(std::size_t index)						const	{ assert(index < m_LocalTransformsCount); return m_LocalTransforms[index]; }
+			SHADE_INLINE		LocalTransform& GetBoneLocalTransform(std::size_t index)								{ assert(index < m_LocalTransformsCount); return m_LocalTransforms[index]; }
 
 			SHADE_INLINE		Type GetType()															const	{ return m_Type; }
 			SHADE_INLINE		void SetType(Type type)															{ m_Type = type; }
@@ -125,11 +132,28 @@ namespace shade
 				m_HasInverseBindPose = isSet;
 			}
 
+			// Local transforms were changed, global ones will be recomputed on next UpdateGlobalTransforms
+			SHADE_INLINE void MarkGlobalTransformsDirty()
+			{
+				m_IsGlobalTransformsDirty = true; m_HasInverseBindPose = false;
+			}
+
+			SHADE_INLINE bool IsGlobalTransformsDirty() const
+			{
+				return m_IsGlobalTransformsDirty;
+			}
+			// Compute global transforms from local ones if they are outdated, only the pose which is consumed by renderer needs it
+			void UpdateGlobalTransforms();
+
 		private:
 			Asset<Skeleton>								m_Skeleton;
 			std::size_t									m_AnimationCombinationHash;
-			SharedPointer<std::vector<GlobalTransform>>	m_GlobalTransforms;
-			SharedPointer<std::vector<LocalTransform>>	m_LocalTransforms;
+			// Storage is owned by PoseArena of the thread which evaluated pose in m_Frame
+			GlobalTransform*							m_GlobalTransforms = nullptr;
+			LocalTransform*								m_LocalTransforms = nullptr;
+			std::size_t									m_GlobalTransformsCount = 0;
+			std::size_t									m_LocalTransformsCount = 0;
+			std::uint64_t								m_Frame = ~0ull;
 			LocalTransform								m_ArmatureTransform;
 
 			Type										m_Type;
@@ -137,6 +161,7 @@ namespace shade
 			float										m_CurrentPlayTime;
 			bool										m_HasRootMotion = false;
 			bool										m_HasInverseBindPose = false;
+			bool										m_IsGlobalTransformsDirty = false;
 			RootMotion									m_RootMotion;
 		};
 	}
@@ -0,0 +1,55 @@
+#include "shade_pch.h"
+#include "PoseArena.h"
+
+std::atomic<std::uint64_t> shade::animation::PoseArena::s_Frame = 0u;
+
+void shade::animation::PoseArena::BeginFrame()
+{
+	s_Frame.fetch_add(1u, std::memory_order_release);
+}
+
+std::uint64_t shade::animation::PoseArena::GetFrame()
+{
+	return s_Frame.load(std::memory_order_acquire);
+}
+
+shade::animation::PoseArena& shade::animation::PoseArena::Get()
+{
+	thread_local PoseArena arena;
+
+	if (arena.m_Frame != GetFrame())
+		arena.Rewind();
+
+	return arena;
+}
+
+std::size_t shade::animation::PoseArena::GetUsedSize() const
+{
+	return m_Chunk * CHUNK_SIZE + m_Offset;
+}
+
+void* shade::animation::PoseArena::Allocate(std::size_t size, std::size_t alignment)
+{
+	assert(size <= CHUNK_SIZE && alignment <= alignof(std::max_align_t) && "Pose arena allocation is too big !");
+
+	for (;;)
+	{
+		if (m_Chunk == m_Chunks.size())
+			m_Chunks.emplace_back(new std::byte[CHUNK_SIZE]);
+
+		const std::size_t offset = (m_Offset + alignment - 1u) & ~(alignment - 1u);
+
+		if (offset + size <= CHUNK_SIZE)
+		{
+			m_Offset = offset + size;
+			return m_Chunks[m_Chunk].get() + offset;
+		}
+
+		++m_Chunk; m_Offset = 0u;
+	}
+}
+
+void shade::animation::PoseArena::Rewind()
+{
+	m_Chunk = 0u; m_Offset = 0u; m_Frame = GetFrame();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+
+namespace shade
+{
+	namespace animation
+	{
+		// Linear allocator of per frame pose data, every thread has its own one so graphs evaluated in parallel don't contend.
+		// Memory is handed out by bumping offset inside fixed size chunks, arena is rewound when its thread allocates in a new frame.
+		// Chunks are kept for reuse, so after warm up frame doesn't allocate from heap at all.
+		class SHADE_API PoseArena
+		{
+		public:
+			static constexpr std::size_t CHUNK_SIZE = 256u * 1024u;
+		public:
+			PoseArena() = default;
+			~PoseArena() = default;
+			PoseArena(const PoseArena&) = delete;
+			PoseArena& operator=(const PoseArena&) = delete;
+		public:
+			// Start new animation frame, data allocated in previous one becomes invalid. Call once before graphs are evaluated
+			static void BeginFrame();
+			static std::uint64_t GetFrame();
+			// Get arena of calling thread, it's rewound on first request in a new frame
+			static PoseArena& Get();
+
+			// Allocate uninitialized storage for count objects of T
+			template<typename T>
+			T* Allocate(std::size_t count)
+			{
+				return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			}
+			// Bytes handed out in current frame
+			std::size_t GetUsedSize() const;
+		private:
+			void* Allocate(std::size_t size, std::size_t alignment);
+			void Rewind();
+		private:
+			std::vector<std::unique_ptr<std::byte[]>>	m_Chunks;
+			std::size_t									m_Chunk = 0, m_Offset = 0;
+			std::uint64_t								m_Frame = ~0ull;
+
+			static std::atomic<std::uint64_t>			s_Frame;
+		};
+	}
+}
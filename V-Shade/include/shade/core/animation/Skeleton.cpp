@@ -27,6 +27,8 @@ shade::Skeleton::BoneNode* shade::Skeleton::AddBone(const std::string& name, con
 	if (m_BoneNodes.size() == 1 && !m_RootNode)
 		m_RootNode = &bone;
 
+	m_IsHierarchyDirty.store(true, std::memory_order_release);
+
 	math::DecomposeMatrix(transform, bone.Translation, bone.Rotation, bone.Scale);
 	return &bone;
 }
@@ -38,6 +40,8 @@ shade::Skeleton::BoneNode* shade::Skeleton::AddNode(const shade::Skeleton::BoneN
 	if (m_BoneNodes.size() == 1)
 		m_RootNode = &_node;
 
+	m_IsHierarchyDirty.store(true, std::memory_order_release);
+
 	return &_node;
 }
 
@@ -99,6 +103,58 @@ const shade::Skeleton::BoneNodes& shade::Skeleton::GetBones() const
 	return m_BoneNodes;
 }
 
+const shade::Skeleton::Hierarchy& shade::Skeleton::GetHierarchy() const
+{
+	if (m_IsHierarchyDirty.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(m_HierarchyMutex);
+
+		if (m_IsHierarchyDirty.load(std::memory_order_relaxed))
+		{
+			BuildHierarchy();
+			m_IsHierarchyDirty.store(false, std::memory_order_release);
+		}
+	}
+
+	return m_Hierarchy;
+}
+
+void shade::Skeleton::BuildHierarchy() const
+{
+	static std::atomic<std::uint64_t> s_Version = 0u;
+
+	m_Hierarchy = Hierarchy{};
+	m_Hierarchy.Version = ++s_Version;
+
+	if (!m_RootNode) return;
+
+	m_Hierarchy.IDs.reserve(m_BoneNodes.size());		m_Hierarchy.ParentIDs.reserve(m_BoneNodes.size());
+	m_Hierarchy.Depths.reserve(m_BoneNodes.size());
+	m_Hierarchy.Translations.reserve(m_BoneNodes.size());	m_Hierarchy.Rotations.reserve(m_BoneNodes.size());
+	m_Hierarchy.Scales.reserve(m_BoneNodes.size());		m_Hierarchy.InverseBindPoses.reserve(m_BoneNodes.size());
+	m_Hierarchy.Names.reserve(m_BoneNodes.size());
+
+	// Explicit stack instead of recursion, children are pushed in reverse to keep their original order
+	std::vector<std::tuple<const BoneNode*, BoneID, std::uint32_t>> stack = { { m_RootNode, BONE_NULL_ID, 0u } };
+
+	while (!stack.empty())
+	{
+		const auto [bone, parentId, depth] = stack.back(); stack.pop_back();
+
+		m_Hierarchy.IDs.emplace_back(bone->ID);
+		m_Hierarchy.ParentIDs.emplace_back(parentId);
+		m_Hierarchy.Depths.emplace_back(depth);
+		m_Hierarchy.Translations.emplace_back(bone->Translation);
+		m_Hierarchy.Rotations.emplace_back(bone->Rotation);
+		m_Hierarchy.Scales.emplace_back(bone->Scale);
+		m_Hierarchy.InverseBindPoses.emplace_back(bone->InverseBindPose);
+		m_Hierarchy.Names.emplace_back(bone->Name);
+
+		for (auto child = bone->Children.rbegin(); child != bone->Children.rend(); ++child)
+			stack.emplace_back(*child, bone->ID, depth + 1u);
+	}
+}
+
 void DeserializeNode(std::istream& stream, shade::Skeleton& skeleton, shade::Skeleton::BoneNode** child = nullptr);
 void DeserializeChildren(std::istream& stream, shade::Skeleton& skeleton, std::vector<shade::Skeleton::BoneNode*>& children);
 
@@ -181,6 +237,8 @@ void shade::Skeleton::Deserialize(std::istream& stream)
 {
 	DeserializeArmature(stream, m_Armature);
 	DeserializeNode(stream, *this);
+	// Bake right after loading so the first animated frame doesn't pay for it
+	GetHierarchy();
 }
 
 void shade::Skeleton::Serialize(std::ostream& stream) const
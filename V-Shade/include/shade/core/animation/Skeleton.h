@@ -51,8 +51,28 @@ namespace shade
 
 		};
 		using BoneNodes = std::unordered_map<std::string, BoneNode>;
-	public:
-		
+		// Bones flattened in depth-first order, parent always comes before its children,
+		// so a pose can be evaluated by a single linear pass instead of walking BoneNode pointers.
+		// Arrays are indexed by position in this order, pose transforms are still indexed by bone ID.
+		struct Hierarchy
+		{
+			// Bone ID at each position
+			std::vector<BoneID>		IDs;
+			// Bone ID of the parent at each position, BONE_NULL_ID for the root
+			std::vector<BoneID>		ParentIDs;
+			// Distance from the root at each position, root is 0
+			std::vector<std::uint32_t> Depths;
+			// Bind pose local transforms
+			std::vector<glm::vec3>	Translations;
+			std::vector<glm::quat>	Rotations;
+			std::vector<glm::vec3>	Scales;
+			std::vector<glm::mat4>	InverseBindPoses;
+			std::vector<std::string> Names;
+			// Unique across all skeletons and changes on every rebuild, lets data bound to hierarchy detect that it's outdated
+			std::uint64_t			Version = 0u;
+
+			SHADE_INLINE std::size_t GetBonesCount() const { return IDs.size(); }
+		};
 	public:
 		// Destructor
 		virtual ~Skeleton() = default;
@@ -103,6 +123,10 @@ namespace shade
 		// Return:
 		// - a const reference to the map of bone nodes in the Skeleton
 		const BoneNodes& GetBones() const;
+		// Get the flattened bone hierarchy, it's rebuilt on first access after bones were added
+		// Return:
+		// - a const reference to the Hierarchy of the Skeleton
+		const Hierarchy& GetHierarchy() const;
 	private:
 		// Create a skeleton object with the given asset data, lifetime, and instantiation behaviour
 		Skeleton(SharedPointer<AssetData> assetData, LifeTime lifeTime, InstantiationBehaviour behaviour);
@@ -110,12 +134,18 @@ namespace shade
 		void Serialize(std::ostream& stream) const;
 		// Deserialize the skeleton object from the given input stream and return the number of bytes read
 		void Deserialize(std::istream& stream);
+		// Rebuild the flattened hierarchy from bone nodes
+		void BuildHierarchy() const;
 	private:
 		friend class serialize::Serializer;
 	private:
 		BoneNodes		m_BoneNodes;
 		BoneNode*		m_RootNode = nullptr;
 		BoneArmature	m_Armature;
+
+		mutable Hierarchy			m_Hierarchy;
+		mutable std::atomic<bool>	m_IsHierarchyDirty = true;
+		mutable std::mutex			m_HierarchyMutex;
 	};
 
 	template<>
@@ -144,28 +174,45 @@ namespace shade
 
 	namespace animation
 	{
+		// Blend weight per bone, indexed by bone ID. Bones out of range have weight 1, so empty mask is full one.
+		// Bone names aren't kept here, editor takes them from skeleton.
 		struct BoneMask
 		{
 			BoneMask(const Asset<Skeleton>& skeleton)
 			{
-				if (skeleton)
-				{
-					for (auto& [name, bone] : skeleton->GetBones())
-						Weights.emplace(bone.ID, std::pair<std::string, float>{ name, 1.0f });
-				}
+				if (skeleton) m_Weights.assign(skeleton->GetBones().size(), 1.0f);
 			}
 			~BoneMask() = default;
 			void Reset()
 			{
-				for (auto& [id, mask] : Weights)
-					mask.second = 1.0f;
+				std::fill(m_Weights.begin(), m_Weights.end(), 1.0f); m_PartialCount = 0;
 			}
-			float GetWeight(std::size_t id) const
+			SHADE_INLINE float GetWeight(std::size_t id) const
 			{
-				auto search = Weights.find(id);
-				return ((search != Weights.end()) ? search->second.second : 1.f);
+				return (id < m_Weights.size()) ? m_Weights[id] : 1.f;
 			}
-			std::unordered_map<std::size_t, std::pair<std::string, float>> Weights;
+			SHADE_INLINE void SetWeight(std::size_t id, float weight)
+			{
+				if (id >= m_Weights.size()) return;
+
+				m_PartialCount -= (m_Weights[id] != 1.f); m_PartialCount += (weight != 1.f);
+				m_Weights[id] = weight;
+			}
+			// All weights are 1, blend may skip the mask entirely
+			SHADE_INLINE bool IsFull() const { return !m_PartialCount; }
+			// Shared full mask for blends without one
+			static const BoneMask& GetFull()
+			{
+				static const BoneMask mask{ nullptr }; return mask;
+			}
+
+			SHADE_INLINE const std::vector<float>& GetWeights() const { return m_Weights; }
+
+			SHADE_INLINE bool operator==(const BoneMask& other) const { return m_Weights == other.m_Weights; }
+		private:
+			std::vector<float>	m_Weights;
+			// Count of weights which aren't 1
+			std::size_t			m_PartialCount = 0;
 		};
 	}
 
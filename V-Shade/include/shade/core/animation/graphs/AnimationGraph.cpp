@@ -5,15 +5,24 @@
 shade::animation::AnimationGraph::AnimationGraph(SharedPointer<AssetData> assetData, LifeTime lifeTime, InstantiationBehaviour behaviour, graphs::GraphContext* context) : BaseAsset(assetData, lifeTime, behaviour),
 BaseNode(context, 0u, nullptr)
 {
-	context->GetNodes().emplace(this, graphs::NodesPack{});
-	context->SetContextRootNode(this);
-	Initialize();
+	Attach();
 }
 
 shade::animation::AnimationGraph::AnimationGraph(graphs::GraphContext* context, const std::string& name) : BaseNode(context, 0u, nullptr, name)
 {
-	context->GetNodes().emplace(this, graphs::NodesPack{});
-	context->SetContextRootNode(this);
+	Attach();
+}
+
+void shade::animation::AnimationGraph::Attach()
+{
+	if (!m_pGraphContext)
+	{
+		m_pOwnedContext = std::make_unique<AnimationGraphContext>();
+		m_pGraphContext = m_pOwnedContext.get(); m_InstanceSlot = m_pGraphContext->AcquireInstanceSlot();
+	}
+
+	m_pGraphContext->GetNodes().emplace(this, graphs::NodesPack{});
+	m_pGraphContext->SetContextRootNode(this);
 	Initialize();
 }
 
@@ -22,6 +31,12 @@ void shade::animation::AnimationGraph::Initialize()
 	SetRootNode(CreateNode<OutputPoseNode>());
 }
 
+shade::animation::Pose* shade::animation::AnimationGraph::GetOutputPose(graphs::GraphInstance* pInstance)
+{
+	graphs::GraphInstance::Scope scope(*GetGraphContext(), pInstance);
+	return GetOutputPose();
+}
+
 void shade::animation::AnimationGraph::ProcessGraph(const shade::FrameTimer& deltaTime)
 {
 	ProcessBranch(deltaTime);
@@ -245,6 +260,9 @@ void shade::animation::AnimationGraph::Deserialize(std::istream& stream)
 	// Deserialize Graph context
 	serialize::Serializer::Deserialize(stream, *GetGraphContext());
 
+	GetGraphContext()->CompileEvaluationOrders();
+	GetGraphContext()->BeginEvaluation();
+
 	for (auto [node, pack] : GetGraphContext()->GetNodes())
 	{
 		// Try to process state once it was created to get all animtions created and played 
@@ -27,7 +27,7 @@ namespace shade
 
 		public:
 			/// @brief Constructs an AnimationGraph with the given context and optional name.
-			/// @param context The context to be used for the graph.
+			/// @param context The context to be used for the graph, graph creates and owns its context if it's nullptr.
 			/// @param name The optional name of the graph. Default is "Animation graph".
 			AnimationGraph(graphs::GraphContext* context, const std::string& name = "Animation graph");
 
@@ -52,6 +52,11 @@ namespace shade
 				return GetRootNode()->As<OutputPoseNode>().GetFinalPose();
 			}
 
+			/// @brief Gets the output pose of the graph for a given instance.
+			/// @param pInstance The graph instance, nullptr to get the pose of the graph's own state.
+			/// @return A pointer to the current Pose object, or nullptr if there is no output pose.
+			Pose* GetOutputPose(graphs::GraphInstance* pInstance);
+
 			/// @brief Initializes the AnimationGraph.
 			virtual void Initialize() override;
 
@@ -184,6 +189,12 @@ namespace shade
 			/// @brief Map of input nodes by name.
 			std::unordered_map<std::string, BaseNode*> m_InputNodes; 
 
+			/// @brief Context created by the graph when none has been given.
+			std::unique_ptr<AnimationGraphContext> m_pOwnedContext;
+
+			/// @brief Registers the graph as root of its context, creates own context if there's none.
+			void Attach();
+
 		private:
 			// Constructor for asset manager only
 			/// @brief Constructor for creating an AnimationGraph with asset data.
@@ -94,10 +94,27 @@ namespace shade
 		public:
 			///@brief Current entity
 			Asset<Skeleton> Skeleton;
-			///@brief AnimationController
-			mutable SharedPointer<AnimationController> Controller;
+			///@brief AnimationController, used when no graph instance is bound
+			mutable SharedPointer<AnimationController> Controller = AnimationController::Create();
 			///@brief For animation synchronizing
 			mutable SynchronizingGroups SyncGroups;
+
+			///@brief Gets controller of the graph instance bound to the current thread, or own one
+			SHADE_INLINE SharedPointer<AnimationController>& GetController() const;
 		};
+
+		/// @brief Runtime state of animation graph for a single entity, poses are owned by its controller
+		struct AnimationGraphInstance : public graphs::GraphInstance
+		{
+		public:
+			///@brief AnimationController
+			SharedPointer<AnimationController> Controller = AnimationController::Create();
+		};
+
+		SHADE_INLINE SharedPointer<AnimationController>& AnimationGraphContext::GetController() const
+		{
+			graphs::GraphInstance* pInstance = GetBoundInstance();
+			return (pInstance) ? pInstance->As<AnimationGraphInstance>().Controller : Controller;
+		}
 	}
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ shade::animation::AdditivePose::AdditivePose(graphs::GraphContext* context, grap
 
 void shade::animation::AdditivePose::Evaluate(const FrameTimer& delatTime)
 {
-	auto& controller = GetGraphContext()->As<AnimationGraphContext>().Controller;
+	auto& controller = GetGraphContext()->As<AnimationGraphContext>().GetController();
 	auto& skeleton = GetGraphContext()->As<AnimationGraphContext>().Skeleton;
 
 	const Pose* rPose = GET_ENDPOINT<graphs::Connection::Input, NodeValueType::Pose>(0);
@@ -19,10 +19,6 @@ namespace shade
 
 			virtual void OnConnect(graphs::Connection::Type connectionType, NodeValueType type, graphs::EndpointIdentifier endpoint) override {};
 			bool m_IsAddative = false;
-		private:
-
-
-			AnimationController::AnimationControlData m_AnimationData;
 		};
 	}
 }
\ No newline at end of file
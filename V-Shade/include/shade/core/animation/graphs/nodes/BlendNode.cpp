@@ -3,7 +3,7 @@
 
 void shade::animation::BlendNode::Evaluate(const FrameTimer& deltaTime)
 {
-	auto& controller = GetGraphContext()->As<AnimationGraphContext>().Controller;
+	auto& controller = GetGraphContext()->As<AnimationGraphContext>().GetController();
 	auto& skeleton   = GetGraphContext()->As<AnimationGraphContext>().Skeleton;
 
 	const Pose* source		= GET_ENDPOINT<graphs::Connection::Input, NodeValueType::Pose>(2);
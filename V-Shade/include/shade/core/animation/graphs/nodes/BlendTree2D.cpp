@@ -48,7 +48,7 @@ void shade::animation::BlendTree2D::RemoveInputPose(const graphs::EndpointIdenti
 
 void shade::animation::BlendTree2D::Evaluate(const FrameTimer& delatTime)
 {
-    auto& controller = GetGraphContext()->As<AnimationGraphContext>().Controller;
+    auto& controller = GetGraphContext()->As<AnimationGraphContext>().GetController();
     const auto& skeleton = GetGraphContext()->As<AnimationGraphContext>().Skeleton;
 
     StackArray<Pose*, 20>   validPoses;  std::vector<glm::vec2> points;
@@ -73,7 +73,7 @@ void shade::animation::BlendTree2D::Evaluate(const FrameTimer& delatTime)
             if (weights[i + 1] <= 0.f)
                 continue;
 
-            basePose = controller->Blend(skeleton, basePose, validPoses[i + 1], weights[i + 1], BoneMask{ nullptr });
+            basePose = controller->Blend(skeleton, basePose, validPoses[i + 1], weights[i + 1], BoneMask::GetFull());
         }
 
         GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, basePose);
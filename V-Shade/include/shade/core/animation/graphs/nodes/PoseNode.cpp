@@ -27,30 +27,31 @@ namespace shade
 // Rename to Animation track ! ! !
 void shade::animation::PoseNode::Evaluate(const FrameTimer& deltaTime)
 {
-	auto& controller	= GetGraphContext()->As<AnimationGraphContext>().Controller;
+	auto& controller	= GetGraphContext()->As<AnimationGraphContext>().GetController();
 	auto& skeleton		= GetGraphContext()->As<AnimationGraphContext>().Skeleton;
 	auto& syncPools		= GetGraphContext()->As<AnimationGraphContext>().SyncGroups;
+	auto& animationData	= GetAnimationData();
 
-	if (m_AnimationData.Animation)
+	if (animationData.Animation)
 	{
-		if (auto syncGroup = utils::GetSyncGroup(m_AnimationData.SyncGroupName.c_str(), syncPools, this))
+		if (auto syncGroup = utils::GetSyncGroup(animationData.SyncGroupName.c_str(), syncPools, this))
 		{
 			//Check if we are not leader and leader exists !
 			if (syncGroup->pLeader && syncGroup->pLeader != this)
 			{
 				const auto& leaderAnimationData			= syncGroup->pLeader->As<PoseNode>().GetAnimationData();
-				const auto& followerAnimationData		= m_AnimationData;
+				const auto& followerAnimationData		= animationData;
 
 				/*float leaderCurrentTime		= leaderAnimationData.CurrentTime;
 				const auto& leaderMarkers	= leaderAnimationData.SyncMarkers;*/
 				
-				const auto [TimeMultiplier1, TimeMultiplier2] = controller->GetTimeMultiplier(syncGroup->pLeader->As<PoseNode>().GetAnimationData().Duration, m_AnimationData.Duration, 1.0);
+				const auto [TimeMultiplier1, TimeMultiplier2] = controller->GetTimeMultiplier(syncGroup->pLeader->As<PoseNode>().GetAnimationData().Duration, animationData.Duration, 1.0);
 
 
 
 
 
-				GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, m_AnimationData, deltaTime, TimeMultiplier1));
+				GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, animationData, deltaTime, TimeMultiplier1));
 				return;
 				// So here should be all magic with sync 
 				// 1. We dont need transition sync data i belive, maby just current transition time to make a proper synk
@@ -68,7 +69,7 @@ void shade::animation::PoseNode::Evaluate(const FrameTimer& deltaTime)
 				case state_machine::TransitionStatus::Start:
 				{
 					if (syncData.Preferences.ResetFromStart)
-						m_AnimationData.CurrentPlayTime = m_AnimationData.Start + syncData.Preferences.Offset;
+						animationData.CurrentPlayTime = animationData.Start + syncData.Preferences.Offset;
 				}
 				case state_machine::TransitionStatus::InProcess:
 				{
@@ -76,8 +77,8 @@ void shade::animation::PoseNode::Evaluate(const FrameTimer& deltaTime)
 					{
 					case state_machine::SyncStyle::SourceFrozen:
 
-						m_AnimationData.State = Animation::State::Pause;
-						GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, m_AnimationData, deltaTime, syncData.TimeMultiplier));
+						animationData.State = Animation::State::Pause;
+						GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, animationData, deltaTime, syncData.TimeMultiplier));
 						break;
 
 					case state_machine::SyncStyle::SourceToDestinationTimeSync:
@@ -89,22 +90,22 @@ void shade::animation::PoseNode::Evaluate(const FrameTimer& deltaTime)
 					case state_machine::SyncStyle::KeyFrameSync: break;
 
 					default:
-						//m_AnimationData.State = Animation::State::Play;
-						GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, m_AnimationData, deltaTime, syncData.TimeMultiplier));
+						//animationData.State = Animation::State::Play;
+						GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, animationData, deltaTime, syncData.TimeMultiplier));
 						break;
 					}
 					break;
 				}
 				case state_machine::TransitionStatus::End: // When transition end or non transition occurs
 				{
-					GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, m_AnimationData, deltaTime, syncData.TimeMultiplier));
+					GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, animationData, deltaTime, syncData.TimeMultiplier));
 					break;
 				}
 			}
 		}
 		else
 		{
-			GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, m_AnimationData, deltaTime));
+			GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, controller->ProcessPose(skeleton, animationData, deltaTime));
 		}
 	}
 	
@@ -112,9 +113,11 @@ void shade::animation::PoseNode::Evaluate(const FrameTimer& deltaTime)
 // TODO:          0       
 void shade::animation::PoseNode::ResetAnimationData(const Asset<Animation>& animation)
 {
-	bool has = m_AnimationData.HasRootMotion;
-	m_AnimationData = AnimationController::AnimationControlData(animation);
-	m_AnimationData.HasRootMotion = has;
+	bool has = m_InstanceState.AnimationData.HasRootMotion;
+	m_InstanceState.AnimationData = AnimationController::AnimationControlData(animation);
+	m_InstanceState.AnimationData.HasRootMotion = has;
+	// Graph instances keep their own copy of playback state
+	if (m_pGraphContext) m_pGraphContext->InvalidateInstances();
 	/*auto oldState = m_AnimationData.State;
 
 	m_AnimationData.State = Animation::State::Play;
@@ -124,7 +127,8 @@ void shade::animation::PoseNode::ResetAnimationData(const Asset<Animation>& anim
 
 void shade::animation::PoseNode::ResetAnimationData(const AnimationController::AnimationControlData& data)
 {
-	m_AnimationData = data;
+	m_InstanceState.AnimationData = data;
+	if (m_pGraphContext) m_pGraphContext->InvalidateInstances();
 	/*auto oldState = m_AnimationData.State;
 
 	m_AnimationData.State = Animation::State::Play;
@@ -134,18 +138,18 @@ void shade::animation::PoseNode::ResetAnimationData(const AnimationController::A
 
 const shade::animation::AnimationController::AnimationControlData& shade::animation::PoseNode::GetAnimationData() const
 {
-	return m_AnimationData;
+	return GetInstanceState(m_InstanceState).AnimationData;
 }
 
 shade::animation::AnimationController::AnimationControlData& shade::animation::PoseNode::GetAnimationData()
 {
-	return m_AnimationData;
+	return GetInstanceState(m_InstanceState).AnimationData;
 }
 
 void shade::animation::PoseNode::SerializeBody(std::ostream& stream) const
 {
 	SHADE_CORE_INFO("Serialize '{0}' body section...", GetName());
-	serialize::Serializer::Serialize(stream, m_AnimationData);
+	serialize::Serializer::Serialize(stream, m_InstanceState.AnimationData);
 }
 
 void shade::animation::PoseNode::DeserializeBody(std::istream& stream)
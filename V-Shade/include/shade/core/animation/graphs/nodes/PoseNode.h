@@ -43,7 +43,13 @@ namespace shade
 			virtual void SerializeBody(std::ostream& stream) const override;
 			virtual void DeserializeBody(std::istream& stream) override;
 
-			AnimationController::AnimationControlData m_AnimationData;
+			/// @brief Playback state, every graph instance plays the animation on its own.
+			struct InstanceState : public graphs::NodeInstanceState
+			{
+				AnimationController::AnimationControlData AnimationData;
+			};
+
+			InstanceState m_InstanceState;
 		};
 	}
 }
\ No newline at end of file
@@ -27,12 +27,12 @@ bool shade::animation::state_machine::OutputTransitionNode::ShouldTransit() cons
 
 void shade::animation::state_machine::OutputTransitionNode::SetTransitionReverse(bool set)
 {
-	m_IsReverse = set;
+	GetState().IsReverse = set;
 }
 
 void shade::animation::state_machine::OutputTransitionNode::ReverseTransition()
 {
-	m_IsReverse = !m_IsReverse;
+	GetState().IsReverse = !GetState().IsReverse;
 }
 
 void shade::animation::state_machine::OutputTransitionNode::SerializeBody(std::ostream& stream) const
@@ -265,15 +265,17 @@ void shade::animation::state_machine::StateMachineNode::Initialize()
 
 void shade::animation::state_machine::StateMachineNode::Evaluate(const FrameTimer& deltaTime)
 {
+	MachineInstanceState& state = GetState();
+
 	if (StateNode* pState = GetCurrentState())
 	{
-		if (m_pActiveTransition)
+		if (state.pActiveTransition)
 		{
-			OutputTransitionNode& transition = m_pActiveTransition->GetRootNode()->As<OutputTransitionNode>();
+			OutputTransitionNode& transition = state.pActiveTransition->GetRootNode()->As<OutputTransitionNode>();
 				
-			if (m_pActiveTransition->CanBeInterrupted())
+			if (state.pActiveTransition->CanBeInterrupted())
 			{
-				StateNode* dstState = m_pActiveTransition->GetTransitionData().DestinationState;
+				StateNode* dstState = state.pActiveTransition->GetTransitionData().DestinationState;
 
 				// Go through all state transitions
 				for (TransitionNode* pTransition : dstState->GetTransitions())
@@ -289,7 +291,7 @@ void shade::animation::state_machine::StateMachineNode::Evaluate(const FrameTime
 					}
 				}
 
-				StateNode* srcState = m_pActiveTransition->GetTransitionData().SourceState;
+				StateNode* srcState = state.pActiveTransition->GetTransitionData().SourceState;
 
 				// Go through all state transitions
 				for (TransitionNode* pTransition : srcState->GetTransitions())
@@ -305,15 +307,15 @@ void shade::animation::state_machine::StateMachineNode::Evaluate(const FrameTime
 				}
 			}
 			// When transition active, set blended pose to state machine 
-			if (Pose* blendPose = Transit(m_pActiveTransition, deltaTime, nullptr))
+			if (Pose* blendPose = Transit(state.pActiveTransition, deltaTime, nullptr))
 			{
 				GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(0, blendPose);
 			}
 			else
 			{
 				// When transition has been done, set current state and pose to state machine 
-				SetCurrentState(!transition.IsReverse() ? m_pActiveTransition->GetTransitionData().DestinationState : m_pActiveTransition->GetTransitionData().SourceState);
-				m_pActiveTransition = nullptr;
+				SetCurrentState(!transition.IsReverse() ? state.pActiveTransition->GetTransitionData().DestinationState : state.pActiveTransition->GetTransitionData().SourceState);
+				state.pActiveTransition = nullptr;
 				transition.SetTransitionReverse(false); 
 			}
 		}
@@ -331,8 +333,8 @@ void shade::animation::state_machine::StateMachineNode::Evaluate(const FrameTime
 				// If we has to transit
 				if (pTransition->ShouldTransit())
 				{
-					m_pActiveTransition = pTransition;
-					m_pActiveTransition->GetRootNode()->As<OutputTransitionNode>().ResetTransitionAccumulator();
+					state.pActiveTransition = pTransition;
+					state.pActiveTransition->GetRootNode()->As<OutputTransitionNode>().ResetTransitionAccumulator();
 					return;
 				}
 			}
@@ -347,7 +349,6 @@ shade::animation::Pose* shade::animation::state_machine::StateMachineNode::Trans
 	OutputTransitionNode& transition		= pTransition->GetRootNode()->As<OutputTransitionNode>();
 	TransitionNode::Data& transitionData	= pTransition->GetTransitionData();
 
-	pTransition->SetInterrupted(transition.GetEndpoint<graphs::Connection::Input>(4)->As<NodeValueType::Bool>());
 	// If accumulator more than duration that means transition has been done, or duration is 0 so transition should be immediately
 	if ((transition.IsReverse() && transition.GetTransitionAccumulator() <= 0.f) || (!transition.IsReverse() && transition.GetTransitionAccumulator() > transition.GetTransitionDuration()) || !transition.GetTransitionDuration())
 	{
@@ -360,7 +361,7 @@ shade::animation::Pose* shade::animation::state_machine::StateMachineNode::Trans
 	}
 	else // We need make a transition
 	{
-		auto& controller = GetGraphContext()->As<AnimationGraphContext>().Controller;
+		auto& controller = GetGraphContext()->As<AnimationGraphContext>().GetController();
 		auto& skeleton = GetGraphContext()->As<AnimationGraphContext>().Skeleton;
 
 		const animation::Pose* sPose = transitionData.SourceState->GetOutputPose();
@@ -438,7 +439,7 @@ shade::animation::Pose* shade::animation::state_machine::StateMachineNode::Trans
 
 			transition.ProcessTransitionAccumulator(deltaTime);
 
-			return (transitionData.DestinationState == GetRootNode()) ? controller->Blend(skeleton, dPose, sPose, blendFactor, animation::BoneMask{ nullptr }) : controller->Blend(skeleton, sPose, dPose, blendFactor, animation::BoneMask{ nullptr });
+			return (transitionData.DestinationState == GetCurrentState()) ? controller->Blend(skeleton, dPose, sPose, blendFactor, animation::BoneMask::GetFull()) : controller->Blend(skeleton, sPose, dPose, blendFactor, animation::BoneMask::GetFull());
 			
 		}
 		else if(sPose)
@@ -550,7 +551,7 @@ shade::animation::Pose* shade::animation::state_machine::StateMachineNode::Trans
 //		if (statePose && entryPointPose)
 //		{
 //			GET_ENDPOINT<graphs::Connection::Output, NodeValueType::Pose>(1,
-//				context.Controller->Blend(context.Skeleton, statePose, entryPointPose, m_EntryPointClampMax, animation::BoneMask{ nullptr }));
+//				context.Controller->Blend(context.Skeleton, statePose, entryPointPose, m_EntryPointClampMax, animation::BoneMask::GetFull()));
 //		}
 //		else
 //		{
@@ -742,8 +743,8 @@ shade::animation::Pose* shade::animation::state_machine::StateMachineNode::Trans
 //	transition.ProcessTransitionAccumulator(deltaTime);
 //
 //	return (transitionData.DestinationState == GetRootNode()) ?
-//		controller->Blend(skeleton, dPose, sPose, blendFactor, animation::BoneMask{ nullptr }) :
-//		controller->Blend(skeleton, sPose, dPose, blendFactor, animation::BoneMask{ nullptr });
+//		controller->Blend(skeleton, dPose, sPose, blendFactor, animation::BoneMask::GetFull()) :
+//		controller->Blend(skeleton, sPose, dPose, blendFactor, animation::BoneMask::GetFull());
 //}
 
 void shade::animation::state_machine::StateNode::Serialize(std::ostream& stream) const
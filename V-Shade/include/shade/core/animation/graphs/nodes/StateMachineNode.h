@@ -87,7 +87,7 @@ namespace shade
 				/// @return True if the transition is in reverse, false otherwise.
 				SHADE_INLINE bool IsReverse() const 
 				{
-					return m_IsReverse; 
+					return GetState().IsReverse; 
 				}
 
 				/// @brief Gets the transition duration.
@@ -106,11 +106,18 @@ namespace shade
 				/// @return The current transition accumulator value.
 				SHADE_INLINE float GetTransitionAccumulator()
 				{
-					return m_TimeAccumulator;
+					return GetState().TimeAccumulator;
 				}
 				SHADE_INLINE float GetTransitionAccumulator() const
 				{
-					return m_TimeAccumulator;
+					return GetState().TimeAccumulator;
+				}
+
+				/// @brief Checks if the transition can be interrupted.
+				/// @return True if the transition can be interrupted, false otherwise.
+				SHADE_INLINE bool CanBeInterrupted() const
+				{
+					return GET_ENDPOINT<graphs::Connection::Input, NodeValueType::Bool>(4);
 				}
 
 				/// @brief Gets the control points of the curve used in the transition.
@@ -130,21 +137,22 @@ namespace shade
 				/// @brief Resets the transition accumulator to its initial value.
 				SHADE_INLINE void ResetTransitionAccumulator()
 				{
-					m_TimeAccumulator = 0.f;
+					GetState().TimeAccumulator = 0.f;
 				}
 
 				/// @brief Sets the transition accumulator to a specific time.
 				/// @param time The time to set the accumulator to.
 				SHADE_INLINE void SetTransitionAccumulator(float time)
 				{
-					m_TimeAccumulator = time;
+					GetState().TimeAccumulator = time;
 				}
 
 				/// @brief Processes the transition accumulator, advancing it based on deltaTime.
 				/// @param deltaTime The time elapsed since the last frame.
 				SHADE_INLINE void ProcessTransitionAccumulator(const FrameTimer& deltaTime)
 				{
-					m_TimeAccumulator += !m_IsReverse ? deltaTime.GetInSeconds<float>() : -deltaTime.GetInSeconds<float>();
+					InstanceState& state = GetState();
+					state.TimeAccumulator += !state.IsReverse ? deltaTime.GetInSeconds<float>() : -deltaTime.GetInSeconds<float>();
 				}
 
 				/// @brief Sets whether the transition should be in reverse.
@@ -154,10 +162,22 @@ namespace shade
 				/// @brief Reverses the transition process.
 				void ReverseTransition();
 			private:
-				float m_TimeAccumulator = 0.f;                      ///< Accumulator for the transition time.
+				/// @brief Transition progress, kept per graph instance.
+				struct InstanceState : public graphs::NodeInstanceState
+				{
+					float TimeAccumulator = 0.f;                    ///< Accumulator for the transition time.
+					bool IsReverse = false;                         ///< Indicates if the transition is reversed.
+				};
+
+				/// @brief Gets transition progress of the bound graph instance.
+				SHADE_INLINE InstanceState& GetState() const
+				{
+					return GetInstanceState(m_InstanceState);
+				}
+			private:
+				InstanceState m_InstanceState;                      ///< Transition progress used when no graph instance is bound.
 				std::vector<float> m_CurveControlPoints = { 0.5f };  ///< Control points for the transition curve.
 				SyncStyle m_SyncStyle = SyncStyle::Async;          ///< Synchronization style for the transition.
-				bool m_IsReverse = false;                          ///< Indicates if the transition is reversed.
 			private:
 				friend class StateMachineNode;                      ///< Friend class for state machine integration.
 
@@ -225,18 +245,10 @@ namespace shade
 				/// @return True if the transition can be interrupted, false otherwise.
 				SHADE_INLINE bool CanBeInterrupted() const
 				{
-					return m_CanBeInterrupted;
-				}
-
-				/// @brief Sets whether the transition can be interrupted.
-				/// @param is Boolean indicating if the transition can be interrupted.
-				SHADE_INLINE void SetInterrupted(bool is)
-				{
-					m_CanBeInterrupted = is;
+					return GetRootNode()->As<OutputTransitionNode>().CanBeInterrupted();
 				}
 			private:
 				Data m_TransitionData;                         ///< Data containing source and destination states.
-				bool m_CanBeInterrupted = false;               ///< Indicates if the transition can be interrupted.
 
 				virtual void SerializeBody(std::ostream& stream) const override;
 
@@ -310,14 +322,14 @@ namespace shade
 				/// @param data Reference to the TransitionSyncData to set.
 				SHADE_INLINE void  SetTransitionSyncData(const TransitionSyncData& data) 
 				{ 
-					m_TransitionSyncData = data;
+					GetState().SyncData = data;
 				}
 
 				/// @brief Gets the synchronization data for the transition.
 				/// @return Reference to the TransitionSyncData.
 				SHADE_INLINE TransitionSyncData& GetTransitionSyncData() 
 				{ 
-					return m_TransitionSyncData; 
+					return GetState().SyncData; 
 				}
 
 				/// @brief Gets the output pose of the state.
@@ -333,10 +345,21 @@ namespace shade
 				{
 					return GetRootNode()->As<OutputPoseNode>().GetFinalPose();
 				}
+			protected:
+				/// @brief Runtime state, kept per graph instance.
+				struct InstanceState : public graphs::NodeInstanceState
+				{
+					TransitionSyncData SyncData;					///< Synchronization data for the transition.
+				};
+
+				/// @brief Gets runtime state of the bound graph instance.
+				virtual SHADE_INLINE InstanceState& GetState() const
+				{
+					return GetInstanceState(m_InstanceState);
+				}
 			private:
 				std::vector<TransitionNode*> m_Transitions;			///< List of transitions from this state.
-				StateNode* m_pPreviousState = nullptr;				///< Pointer to the previous state.
-				TransitionSyncData m_TransitionSyncData;			///< Synchronization data for the transition.
+				InstanceState m_InstanceState;						///< Runtime state used when no graph instance is bound.
 
 				virtual void Serialize(std::ostream& stream) const override;
 
@@ -390,16 +413,39 @@ namespace shade
 					return GetOutputPose();
 				}
 
+				/// @brief Gets current state, graph instance starts from the root state.
+				/// @return Pointer to the current state.
 				SHADE_INLINE StateNode* GetCurrentState()
 				{
-					return &GetRootNode()->As<StateNode>();
+					StateNode* pState = GetState().pCurrentState;
+					return (pState) ? pState : &GetRootNode()->As<StateNode>();
 				}
+
+				/// @brief Sets current state, without bound graph instance it becomes the root state.
+				/// @param state Pointer to the state.
 				SHADE_INLINE void SetCurrentState(StateNode* state)
 				{
-					SetRootNode(state);
+					if (GetGraphContext()->GetBoundInstance())
+						GetState().pCurrentState = state;
+					else
+						SetRootNode(state);
 				}
 			private:
-				TransitionNode* m_pActiveTransition = nullptr;    ///< Pointer to the currently active transition.
+				/// @brief Runtime state of state machine, kept per graph instance.
+				struct MachineInstanceState : public StateNode::InstanceState
+				{
+					TransitionNode* pActiveTransition = nullptr;		///< Pointer to the currently active transition.
+					bool IsTransitionHasBeenInterrupted = false;		///< Flag indicating if the transition was interrupted.
+					StateNode* pCurrentState = nullptr;				///< Current state, root state is used while it's not set.
+				};
+
+				/// @brief Gets runtime state of the bound graph instance.
+				virtual SHADE_INLINE MachineInstanceState& GetState() const override
+				{
+					return GetInstanceState(m_MachineState);
+				}
+
+				MachineInstanceState m_MachineState;				///< Runtime state used when no graph instance is bound.
 			private:
 				/// @brief Handles the transition between states within the state machine.
 				/// @param pTransition Pointer to the TransitionNode to process.
@@ -409,7 +455,6 @@ namespace shade
 				Pose* Transit(TransitionNode* pTransition, const FrameTimer& deltaTime, Pose* pPTPose = nullptr);
 				
 			private:
-				bool	m_IsTransitionHasBeenInterrupted = false;    ///< Flag indicating if the transition was interrupted.
 				virtual void Serialize(std::ostream& stream) const override;
 				virtual void Deserialize(std::istream& stream) override;
 			};
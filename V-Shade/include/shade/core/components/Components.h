@@ -10,6 +10,7 @@
 #include <shade/core/environment/SpotLight.h>
 #include <shade/core/physics/RigidBody.h>
 #include <shade/core/animation/graphs/AnimationGraph.h>
+#include <shade/core/animation/AnimationLod.h>
 
 namespace shade
 {
@@ -28,7 +29,10 @@ namespace shade
 	struct AnimationGraphComponent
 	{
 		Asset<animation::AnimationGraph> AnimationGraph;
-		animation::AnimationGraphContext GraphContext;
+		// Runtime state of the graph for this entity, graph asset itself is shared by all entities using it
+		SharedPointer<animation::AnimationGraphInstance> Instance;
+		// Update rate and bone depth by distance to camera, state is filled by SceneRenderer
+		animation::AnimationLod Lod;
 	};
 
 }
\ No newline at end of file
@@ -1,2 +1,11 @@
 #include "shade_pch.h"
-#include "Common.h"
\ No newline at end of file
+#include "Common.h"
+
+shade::ecs::TypeID shade::ecs::internal::TypeIndexImpl::Get(const TypeHash& hash)
+{
+	static std::mutex mutex;
+	static std::unordered_map<TypeHash, TypeID> indices;
+
+	std::lock_guard<std::mutex> lock{ mutex };
+	return indices.emplace(hash, indices.size()).first->second;
+}
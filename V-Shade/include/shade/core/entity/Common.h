@@ -115,6 +115,11 @@ namespace shade
 					return value++;
 				}
 			};
+			/* Dense family index registry, lives in engine module so every module gets the same index for the same type */
+			struct SHADE_API TypeIndexImpl
+			{
+				[[nodiscard]] static TypeID Get(const TypeHash& hash);
+			};
 		}
 
 		template<typename Type, class = void>
@@ -141,5 +146,37 @@ namespace shade
 			static const TypeHash value = (TypeHash)typeid(Type).hash_code();
 			return value;
 		}
+
+		/* Get dense index of specific type, resolved once per type and used to index component pools directly */
+		template<typename Type>
+		[[nodiscard]] static TypeID Index()
+		{
+			static const TypeID value = internal::TypeIndexImpl::Get(Hash<Type>());
+			return value;
+		}
+
+		/* Components access declaration, const component means read only access */
+		struct Access
+		{
+			std::vector<TypeID> Read;
+			std::vector<TypeID> Write;
+
+			template<typename... Component>
+			[[nodiscard]] static Access Of()
+			{
+				Access access;
+				((std::is_const_v<Component> ? access.Read : access.Write).push_back(Index<std::remove_const_t<Component>>()), ...);
+				return access;
+			}
+			/* Return true if both can't run at the same time, one of them writes component which other one reads or writes */
+			[[nodiscard]] bool IsConflicting(const Access& other) const
+			{
+				auto overlaps = [](const std::vector<TypeID>& left, const std::vector<TypeID>& right)
+					{
+						return std::any_of(left.begin(), left.end(), [&](TypeID id) { return std::find(right.begin(), right.end(), id) != right.end(); });
+					};
+				return overlaps(Write, other.Write) || overlaps(Write, other.Read) || overlaps(Read, other.Write);
+			}
+		};
 	}
 }
\ No newline at end of file
@@ -108,6 +108,13 @@ namespace shade
 				//static const TypeHash hash = Hash<Component>();
 				return m_Manager->GetComponentRaw<Component>(m_Handle);
 			}
+			/* Get component handle which stays valid after other components are added or removed */
+			template<typename Component>
+			ComponentHandle<Component, EntityID> GetComponentHandle()
+			{
+				assert(IsValid() && " Entity isn't valid !");
+				return m_Manager->GetComponentHandle<Component>(m_Handle);
+			}
 			/* Remove component from entity */
 			template<typename Component>
 			void RemoveComponent()
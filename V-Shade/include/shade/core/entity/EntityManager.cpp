@@ -62,6 +62,20 @@ std::size_t shade::ecs::EntityManager::EntitiesCount() const
 	//return (m_Destroyed == ecs::null) ? m_Entities.size() : m_Entities.size() - (EntityTraits<EntityID>::ToID(m_Destroyed - 1));
 }
  
+bool shade::ecs::EntityManager::BeginAccess(const Access& access)
+{
+	std::lock_guard<std::mutex> lock{ m_AccessMutex };
+	const bool isConflicting = std::any_of(m_ActiveAccesses.begin(), m_ActiveAccesses.end(), [&access](const Access* other) { return access.IsConflicting(*other); });
+	m_ActiveAccesses.push_back(&access);
+	return !isConflicting;
+}
+
+void shade::ecs::EntityManager::EndAccess(const Access& access)
+{
+	std::lock_guard<std::mutex> lock{ m_AccessMutex };
+	m_ActiveAccesses.erase(std::remove(m_ActiveAccesses.begin(), m_ActiveAccesses.end(), &access), m_ActiveAccesses.end());
+}
+
 bool shade::ecs::EntityManager::IsValidEntity(const EntityID& entity) const
 {
 	const auto position = EntityTraits<EntityID>::ToID(entity);
@@ -80,11 +94,11 @@ void shade::ecs::EntityManager::DestroyEntity(const EntityID& entity)
 	std::get<0>(m_Entities[handle]) = EntityTraits<EntityID>::EntityType(EntityTraits<EntityID>::ToIntegral(m_Destroyed) | (EntityTraits<EntityID>::ToIntegral(version) << EntityTraits<EntityID>::EntityShift));
 	m_Destroyed = EntityTraits<EntityID>::EntityType(entity);
 	/* Remove entity from all pools and destroy all related components */
-	for (auto position = m_Pools.begin(); position != m_Pools.end(); ++position)
+	for (auto& pData : m_Pools)
 	{
-		if (auto& pData = position->second; pData && pData->Contains(handle))
+		if (pData && pData->Contains(handle))
 		{
-			auto system = m_Systems.find(pData->GetID());
+			auto system = m_Systems.find(pData->GetHash());
 			if (system != m_Systems.end())
 				pData->m_Destroy(handle, pData.get(), system->second.get());
 			else
@@ -67,7 +67,7 @@ namespace shade
 
 			/* Manager */
 		public: 
-			using Pools = std::unordered_map<TypeHash, std::shared_ptr<Storage<EntityID>>>; // shared_ptr should be unique_ptr
+			using Pools = std::vector<std::shared_ptr<Storage<EntityID>>>; // Indexed by Index<Component>(), shared_ptr should be unique_ptr
 			using Systems = std::unordered_map<TypeID, std::shared_ptr<BasicSystem>>; // shared_ptr should be unique_ptr
 			//  0 = Handle, 1 = Parent Handle, 2 = Childs
 			using EntityData = std::tuple<EntityID, EntityID, std::vector<EntityID>>;
@@ -98,14 +98,13 @@ namespace shade
 			template<typename Component>
 			bool HasComponentPool() const 
 			{
-				static const TypeHash hash = Hash<Component>();
-				return (m_Pools.find(hash) != m_Pools.end());
+				return _GetStorage<Component>() != nullptr;
 			}
 			/* Return view class that allow us to iterate through all entites with given set of components */
 			template<typename... Component>
 			BasicView<EntityID, Component...> View() 
 			{
-				return BasicView<EntityID, Component...>(_GetCandidate<EntityID, Component...>(), &m_Pools, this); 
+				return BasicView<EntityID, Component...>({ _GetStorage<std::remove_const_t<Component>>()... }, this);
 			}
 			template<typename Component>
 			void RegisterSystem(void(*onCreate)(Component&), void(*onUpdate)(Component&), void(*onDestroy)(Component&))
@@ -119,13 +118,18 @@ namespace shade
 				static const TypeID index = TypeInfo<Component>::ID();
 				if (HasComponentPool<Component>() && m_Systems.find(index) != m_Systems.end())
 				{
-					auto& components = static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(index).get())->m_Components;
-					for (auto& component : components)
-						static_cast<System<Component>*>(m_Systems.at(index).get())->OnUpdate(*static_cast<Component*>(component.get()));
+					_GetStorage<Component>()->ForEach([&](const EntityID& entity, Component& component)
+						{
+							static_cast<System<Component>*>(m_Systems.at(index).get())->OnUpdate(component);
+						});
 				}
 			}
 			/* Return count of valid entities */
 			std::size_t EntitiesCount() const;
+			/* Register components access of running parallel view, return false if it conflicts with one which is already running */
+			bool BeginAccess(const Access& access);
+			/* Unregister components access of finished parallel view */
+			void EndAccess(const Access& access);
 		protected:
 			// TODO: HasComponents!
 			/* Return true if entiti has give component */
@@ -133,21 +137,22 @@ namespace shade
 			bool HasComponent(const EntityID& entity) const
 			{
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
-				return (HasComponentPool<Component>() && static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Contains(handle));
+				const auto storage = _GetStorage<Component>();
+				return (storage && storage->Contains(handle));
 			}
 			/* Add component to entity */
 			template<typename Component, typename... Args>
 			Component& AddComponent(const EntityID& entity, Args&&... args)
 			{
-				static const TypeHash hash = Hash<Component>();
+				const TypeID index = Index<Component>();
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
 				if (!HasComponentPool<Component>())
 				{
-					m_Pools.insert({ hash, std::make_shared<ComponentStorage<Component, EntityID>>() });
+					if (index >= m_Pools.size()) m_Pools.resize(index + 1);
+					m_Pools[index] = std::make_shared<ComponentStorage<Component, EntityID>>();
 				}
 
-				auto& component = static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Add(handle, std::forward<Args>(args)...);
+				auto& component = _GetStorage<Component>()->Add(handle, std::forward<Args>(args)...);
 
 				/*if (m_Systems.find(index) != m_Systems.end())
 					static_cast<System<Component>*>(m_Systems.at(index).get())->OnCreate(component);*/
@@ -160,9 +165,8 @@ namespace shade
 			{
 				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
 
-				return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Get(handle);
+				return _GetStorage<Component>()->Get(handle);
 			}
 			/* Get component from entity */
 			template<typename Component>
@@ -170,9 +174,8 @@ namespace shade
 			{
 				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
 
-				return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Get(handle);
+				return _GetStorage<Component>()->Get(handle);
 			}
 			/* Get component from entity */
 			template<typename Component>
@@ -180,18 +183,16 @@ namespace shade
 			{
 				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
 
-				return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->GetRaw(handle);
+				return _GetStorage<Component>()->GetRaw(handle);
 			}
 			template<typename Component>
 			Component& GetComponent(const EntityID& entity) const
 			{
 				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
 
-				return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Get(handle);
+				return _GetStorage<Component>()->Get(handle);
 			}
 			/* Get component from entity */
 			template<typename Component>
@@ -199,9 +200,17 @@ namespace shade
 			{
 				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
-				static const TypeHash hash = Hash<Component>();
 
-				return static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->GetRaw(handle);
+				return _GetStorage<Component>()->GetRaw(handle);
+			}
+			/* Get stable component handle from entity */
+			template<typename Component>
+			ComponentHandle<Component, EntityID> GetComponentHandle(const EntityID& entity)
+			{
+				assert(HasComponentPool<Component>() && "Entity doesn't have the component !");
+				const auto handle = EntityTraits<EntityID>::ToID(entity);
+
+				return _GetStorage<Component>()->GetHandle(handle);
 			}
 			/* Remove component from entity */
 			template<typename Component>
@@ -211,11 +220,10 @@ namespace shade
 				const auto handle = EntityTraits<EntityID>::ToID(entity);
 				static const TypeHash hash = Hash<Component>();
 
-				auto& component = GetComponent<Component>(entity);
 				if (m_Systems.find(hash) != m_Systems.end())
-					static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Remove(handle, m_Systems.at(hash).get());
+					_GetStorage<Component>()->Remove(handle, m_Systems.at(hash).get());
 				else
-					static_cast<ComponentStorage<Component, EntityID>*>(m_Pools.at(hash).get())->Remove(handle);
+					_GetStorage<Component>()->Remove(handle);
 
 			}
 			
@@ -241,22 +249,18 @@ namespace shade
 
 			EntityData* _EntitiesBegin() noexcept;
 			EntityData* _EntitiesEnd() noexcept;
-			/* Return lowest SparseSet or nullptr */
-			template<typename Entity, typename... Component>
-			const SparseSet<Entity>* _GetCandidate() const
+			/* Return typed storage of given component or nullptr, single array index */
+			template<typename Component>
+			ComponentStorage<Component, EntityID>* _GetStorage() const
 			{
-				if ((HasComponentPool<Component>() && ...))
-				{
-					return (std::min)({ static_cast<const SparseSet<Entity>*>(m_Pools.at(Hash<Component>()).get())... }, [](const auto& left, const auto& right)
-						{
-							return left->GetSize() < right->GetSize();
-						});
-				}
-				return static_cast<SparseSet<Entity>*>(nullptr);
+				const TypeID index = Index<Component>();
+				return (index < m_Pools.size()) ? static_cast<ComponentStorage<Component, EntityID>*>(m_Pools[index].get()) : nullptr;
 			}
 		private:
 			Pools m_Pools;
 			Systems m_Systems;
+			std::vector<const Access*> m_ActiveAccesses;
+			std::mutex m_AccessMutex;
 			EntityID m_Destroyed = ecs::null;
 			std::vector<EntityData>	m_Entities;
 			std::size_t m_EntitiesCount = 0u;
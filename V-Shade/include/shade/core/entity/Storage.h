@@ -17,14 +17,45 @@ namespace shade
 			virtual ~Storage() = default;
 		public:
 			TypeID GetID() const { return m_Id; }
-			TypeID GetHash() const { return m_Hash; }
+			TypeHash GetHash() const { return m_Hash; }
 		protected:
 			const TypeID m_Id;
 			const TypeHash m_Hash;
 			/* Destroy callback for single entity */
 			void (*m_Destroy)(const Entity&, Storage<Entity>*, BasicSystem*) = nullptr;
 		};
-		/* Component storage class */
+		template<typename ComponentType, typename Entity>
+		class ComponentStorage;
+
+		/* Stable reference to component, resolves through storage on every access so it survives storage growth and swap-and-pop removal */
+		template<typename ComponentType, typename Entity>
+		class ComponentHandle
+		{
+		public:
+			ComponentHandle(ComponentStorage<ComponentType, Entity>* storage = nullptr, const Entity& entity = ecs::null) :
+				m_Storage(storage), m_Entity(entity) {}
+			~ComponentHandle() = default;
+		public:
+			/* Return true if entity still has the component */
+			bool IsValid() const { return m_Storage && m_Storage->Contains(m_Entity); }
+			/* Get component */
+			ComponentType& Get() { assert(IsValid() && "Component handle isn't valid !"); return m_Storage->Get(m_Entity); }
+			/* Get component */
+			const ComponentType& Get() const { assert(IsValid() && "Component handle isn't valid !"); return m_Storage->Get(m_Entity); }
+			/* Get entity which component belongs to */
+			const Entity& GetEntity() const { return m_Entity; }
+
+			ComponentType& operator*() { return Get(); }
+			ComponentType* operator->() { return &Get(); }
+			const ComponentType& operator*() const { return Get(); }
+			const ComponentType* operator->() const { return &Get(); }
+			operator bool() const { return IsValid(); }
+		private:
+			ComponentStorage<ComponentType, Entity>* m_Storage;
+			Entity m_Entity;
+		};
+
+		/* Component storage class, components are stored by value in pages and kept in the same order as SparseSet packed array */
 		template<typename ComponentType, typename Entity>
 		class ComponentStorage : public Storage<Entity>
 		{
@@ -37,54 +68,96 @@ namespace shade
 			using SetTraits = SparseSet<Entity>;
 			using StorageTraits = Storage<Entity>;
 		public:
-			ComponentStorage() : Storage<Entity>(Hash<ComponentType>(), Hash<ComponentType>(),
+			/* Components count per page, pages are never reallocated so growing storage doesn't move existing components */
+			static constexpr std::size_t PageSize = 1024u;
+		public:
+			ComponentStorage() : Storage<Entity>(Index<ComponentType>(), Hash<ComponentType>(),
 				[](const Entity& entity, Storage<Entity>* storage, BasicSystem* system)
 				{	/* Capture type */
 					static_cast<ComponentStorage<ComponentType, Entity>*>(storage)->Remove(entity, system);
 				}) {}
-				virtual ~ComponentStorage() = default; // TODO !
+			virtual ~ComponentStorage()
+			{
+				for (std::size_t position = 0; position < SetTraits::GetSize(); ++position)
+					std::destroy_at(&At(position));
+
+				for (auto page : m_Pages)
+					::operator delete(page, std::align_val_t{ alignof(ComponentType) });
+			}
+			ComponentStorage(const ComponentStorage&) = delete;
+			ComponentStorage& operator=(const ComponentStorage&) = delete;
 		public:
 			/* Link component with given id */
 			template<typename... Args>
 			ComponentType& Add(const Entity& entity, Args&&... args)
 			{
 				assert(!Contains(entity) && "Entity has the component !");
-				m_Components.emplace_back(std::make_shared<ComponentType>(std::forward<Args>(args)...));
+				const std::size_t position = SetTraits::GetSize();
+				if (position / PageSize >= m_Pages.size())
+					m_Pages.emplace_back(static_cast<ComponentType*>(::operator new(sizeof(ComponentType) * PageSize, std::align_val_t{ alignof(ComponentType) })));
+
+				ComponentType* component = std::construct_at(&At(position), std::forward<Args>(args)...);
 				SetTraits::Push(entity);
-				return *m_Components.back().get();
+				return *component;
 			}
 			/* Unlink component from given id */
 			void Remove(const Entity& entity, BasicSystem* system = nullptr)
 			{
 				assert(Contains(entity) && "Entity doesn't have the component !");
-				if (system) static_cast<System<ComponentType>*>(system)->OnDestroy(*m_Components[SetTraits::GetPosition(entity)].get());
-				auto other = std::move(m_Components.back());
-				m_Components[SetTraits::GetPosition(entity)] = std::move(other);
-				m_Components.pop_back();
+				const std::size_t position = SetTraits::GetPosition(entity), last = SetTraits::GetSize() - 1;
+				if (system) static_cast<System<ComponentType>*>(system)->OnDestroy(At(position));
+				/* Keep the same swap-and-pop order as SparseSet::Pop */
+				if (position != last)
+					At(position) = std::move(At(last));
+				std::destroy_at(&At(last));
 				SetTraits::Pop(entity);
 			}
 			/* Get component which linked with given id */
 			ComponentType& Get(const Entity& entity)
 			{
 				assert(Contains(entity) && "Entity doesn't have the component !");
-				return *m_Components[SetTraits::GetPosition(entity)].get();
+				return At(SetTraits::GetPosition(entity));
 			}
 			/* Get component which linked with given id */
 			const ComponentType& Get(const Entity& entity) const
 			{
 				assert(Contains(entity) && "Entity doesn't have the component !");
-				return *m_Components[SetTraits::GetPosition(entity)].get();
+				return At(SetTraits::GetPosition(entity));
 			}
 			/* Get component which linked with given id */
 			ComponentType* GetRaw(const Entity& entity)
 			{
 				assert(Contains(entity) && "Entity doesn't have the component !");
-				return m_Components[SetTraits::GetPosition(entity)].get();
+				return &At(SetTraits::GetPosition(entity));
+			}
+			/* Get handle which stays valid while entity has the component */
+			ComponentHandle<ComponentType, Entity> GetHandle(const Entity& entity)
+			{
+				assert(Contains(entity) && "Entity doesn't have the component !");
+				return ComponentHandle<ComponentType, Entity>(this, entity);
+			}
+			/* Get component by position in tightly packed array */
+			ComponentType& At(std::size_t position) { return m_Pages[position / PageSize][position % PageSize]; }
+			/* Get component by position in tightly packed array */
+			const ComponentType& At(std::size_t position) const { return m_Pages[position / PageSize][position % PageSize]; }
+			/* Execute for each component in packed order, page by page */
+			template<typename Function>
+			void ForEach(Function function)
+			{
+				const Entity* entities = SetTraits::GetData();
+				for (std::size_t page = 0, position = 0; page < m_Pages.size() && position < SetTraits::GetSize(); ++page)
+				{
+					ComponentType* components = m_Pages[page];
+					for (const std::size_t last = (std::min)(position + PageSize, SetTraits::GetSize()); position < last; ++position)
+						function(entities[position], components[position % PageSize]);
+				}
 			}
 			/* Return true if id is in storage */
 			bool Contains(const Entity& entity) const { return SetTraits::Contains(entity); }
+			/* Sorting only packed array would desync components */
+			void Sort() = delete;
 		private:
-			std::vector<std::shared_ptr<ComponentType>> m_Components;
+			std::vector<ComponentType*> m_Pages;
 		};
 	}
 }
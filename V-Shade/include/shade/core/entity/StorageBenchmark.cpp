@@ -0,0 +1,113 @@
+#include "shade_pch.h"
+#include "StorageBenchmark.h"
+#include <shade/core/entity/Storage.h>
+
+namespace
+{
+	/* Transform and rigid body sized payload */
+	struct BenchmarkComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.f);
+		glm::vec3 Velocity	= glm::vec3(0.f);
+	};
+
+	/* Previous storage layout, one shared_ptr allocation per component kept in SparseSet packed order */
+	template<typename ComponentType, typename Entity>
+	class SharedPointerStorage : public shade::ecs::SparseSet<Entity>
+	{
+		using SetTraits = shade::ecs::SparseSet<Entity>;
+	public:
+		template<typename... Args>
+		ComponentType& Add(const Entity& entity, Args&&... args)
+		{
+			m_Components.emplace_back(std::make_shared<ComponentType>(std::forward<Args>(args)...));
+			SetTraits::Push(entity);
+			return *m_Components.back().get();
+		}
+		void Remove(const Entity& entity)
+		{
+			auto other = std::move(m_Components.back());
+			m_Components[SetTraits::GetPosition(entity)] = std::move(other);
+			m_Components.pop_back();
+			SetTraits::Pop(entity);
+		}
+		ComponentType& Get(const Entity& entity) { return *m_Components[SetTraits::GetPosition(entity)].get(); }
+
+		template<typename Function>
+		void ForEach(Function function)
+		{
+			const Entity* entities = SetTraits::GetData();
+			for (std::size_t position = 0; position < m_Components.size(); ++position)
+				function(entities[position], *m_Components[position].get());
+		}
+	private:
+		std::vector<std::shared_ptr<ComponentType>> m_Components;
+	};
+
+	template<typename Storage>
+	void Populate(Storage& storage, const shade::ecs::StorageBenchmark::Settings& settings)
+	{
+		std::mt19937 generator(settings.Seed);
+		std::uniform_real_distribution<float> velocity(-1.f, 1.f);
+
+		for (shade::ecs::EntityID entity = 0; entity < settings.EntitiesCount; ++entity)
+			storage.Add(entity).Velocity = glm::vec3(velocity(generator), velocity(generator), velocity(generator));
+
+		// Remove and add back random entities, so both storages end up in the same shuffled packed order
+		std::vector<shade::ecs::EntityID> churn(settings.EntitiesCount);
+		std::iota(churn.begin(), churn.end(), shade::ecs::EntityID(0));
+		std::shuffle(churn.begin(), churn.end(), generator);
+		churn.resize(static_cast<std::size_t>(float(settings.EntitiesCount) * std::clamp(settings.ChurnFraction, 0.f, 1.f)));
+
+		for (const shade::ecs::EntityID entity : churn)
+			storage.Remove(entity);
+		for (const shade::ecs::EntityID entity : churn)
+			storage.Add(entity).Velocity = glm::vec3(velocity(generator), velocity(generator), velocity(generator));
+	}
+
+	template<typename Storage>
+	void Measure(Storage& storage, const shade::ecs::StorageBenchmark::Settings& settings, double& iterate, double& get)
+	{
+		std::chrono::duration<double, std::milli> elapsed(0.0);
+
+		for (std::size_t iteration = 0; iteration < settings.IterationsCount; ++iteration)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			storage.ForEach([](const shade::ecs::EntityID& entity, BenchmarkComponent& component)
+				{
+					component.Transform[3] += glm::vec4(component.Velocity, 0.f);
+				});
+			elapsed += std::chrono::steady_clock::now() - start;
+		}
+		iterate = elapsed.count() / double(settings.IterationsCount);
+
+		elapsed = std::chrono::duration<double, std::milli>(0.0);
+		for (std::size_t iteration = 0; iteration < settings.IterationsCount; ++iteration)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (shade::ecs::EntityID entity = 0; entity < settings.EntitiesCount; ++entity)
+				storage.Get(entity).Transform[3] -= glm::vec4(storage.Get(entity).Velocity, 0.f);
+			elapsed += std::chrono::steady_clock::now() - start;
+		}
+		get = elapsed.count() / double(settings.IterationsCount);
+	}
+}
+
+shade::ecs::StorageBenchmark::Result shade::ecs::StorageBenchmark::Run(const Settings& settings)
+{
+	Result result{ .EntitiesCount = settings.EntitiesCount };
+	if (!settings.EntitiesCount || !settings.IterationsCount) return result;
+
+	{
+		SharedPointerStorage<BenchmarkComponent, EntityID> storage;
+		Populate(storage, settings);
+		Measure(storage, settings, result.SharedPointerIterateMilliseconds, result.SharedPointerGetMilliseconds);
+	}
+	{
+		ComponentStorage<BenchmarkComponent, EntityID> storage;
+		Populate(storage, settings);
+		Measure(storage, settings, result.PagedIterateMilliseconds, result.PagedGetMilliseconds);
+	}
+
+	return result;
+}
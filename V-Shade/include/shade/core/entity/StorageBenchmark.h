@@ -0,0 +1,35 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+
+namespace shade
+{
+	namespace ecs
+	{
+		/* Compares shared_ptr per component storage with paged by value storage, both are churned the same way before measuring */
+		class SHADE_API StorageBenchmark
+		{
+		public:
+			struct Settings
+			{
+				std::size_t EntitiesCount	= 10000u;
+				std::size_t IterationsCount = 100u;
+				/* Part of entities which are removed and added again before measuring, so packed order isn't sequential */
+				float		ChurnFraction	= 0.25f;
+				std::uint32_t Seed			= 0u;
+			};
+			struct Result
+			{
+				std::size_t EntitiesCount = 0u;
+				/* Per iteration over all components */
+				double SharedPointerIterateMilliseconds = 0.0;
+				double PagedIterateMilliseconds			= 0.0;
+				/* Per lookup pass by entity over all components */
+				double SharedPointerGetMilliseconds		= 0.0;
+				double PagedGetMilliseconds				= 0.0;
+			};
+		public:
+			static Result Run(const Settings& settings);
+			static Result Run(std::size_t entitiesCount) { Settings settings; settings.EntitiesCount = entitiesCount; return Run(settings); }
+		};
+	}
+}
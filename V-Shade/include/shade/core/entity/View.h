@@ -1,6 +1,7 @@
 #pragma once
 #include <shade/core/entity/Storage.h>
 #include <shade/core/entity/EntityManager.h>
+#include <shade/core/threads/JobSystem.h>
 
 namespace shade
 {
@@ -15,7 +16,8 @@ namespace shade
 		public:
 			using OtherPools = std::array<const SparseSet<Entity>*, (sizeof...(Component) - 1)>;
 			using Candidate = SparseSet<Entity>;
-			using Pools = std::unordered_map<TypeHash, std::shared_ptr<Storage<Entity>>>; // Was unique_ptr
+			/* Typed storages resolved once at view construction */
+			using Storages = std::tuple<ComponentStorage<std::remove_const_t<Component>, Entity>*...>;
 			/* View iterator to to iterate through all valid entities with given set of components */
 			template<typename Entity>
 			class BasicViewIterator
@@ -68,8 +70,8 @@ namespace shade
 			using iterator = BasicViewIterator<Entity>;
 			using const_iterator = BasicViewIterator<const Entity>;
 		public:
-			BasicView(const SparseSet<Entity>* candidate = nullptr, const Pools* pools = nullptr, EntityManager* manager = nullptr) :
-				m_Candidate(candidate), m_Pools(pools), m_Manager(manager)
+			BasicView(const Storages& storages = {}, EntityManager* manager = nullptr) :
+				m_Storages(storages), m_Candidate(GetCandidate(storages)), m_OtherPools(PrepareOtherPools(m_Candidate, storages)), m_Manager(manager)
 			{}
 			virtual ~BasicView() = default;
 			/* Execute for each entity with given set of components */
@@ -77,20 +79,56 @@ namespace shade
 			void Each(Function function)
 			{
 				for (auto& entity : *this)
-					function(entity, m_Manager->GetComponent<Component>(entity)...);
+					function(entity, std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(m_Storages)->Get(static_cast<Entity>(entity))...);
 			}
+			/* Execute for each entity with given set of components in parallel, candidate packed array is split into chunks of grainSize.
+			   Const components are declared as read only, running view which conflicts with another running one is asserted.
+			   Adding or removing components and entities inside function is not allowed. */
+			template<typename Function>
+			void ParallelEach(Function function, std::size_t grainSize = 64)
+			{
+				if (!m_Candidate) return;
+
+				const Access access = GetAccess();
+				const bool isConflicting = !m_Manager->BeginAccess(access);
+				assert(!isConflicting && "Parallel view conflicts with running one, components access overlaps !");
+
+				const Entity* entities = m_Candidate->GetData();
+				try
+				{
+					thread::JobSystem::GetGlobal().ParallelFor(m_Candidate->GetSize(), grainSize, [&](std::size_t first, std::size_t last)
+						{
+							for (std::size_t position = first; position < last; ++position)
+							{
+								if (!InOtherPools(entities[position])) continue;
+
+								ecs::Entity entity(entities[position], m_Manager);
+								function(entity, std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(m_Storages)->Get(entities[position])...);
+							}
+						});
+				}
+				catch (...)
+				{
+					m_Manager->EndAccess(access); throw;
+				}
+
+				m_Manager->EndAccess(access);
+			}
+			/* Return components access of view */
+			[[nodiscard]] static Access GetAccess() { return Access::Of<Component...>(); }
 		public:
 			/* Begin of view iterator */
-			iterator begin() noexcept { return iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+			iterator begin() noexcept { return iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, m_OtherPools); };
 			/* End of view iterator */
-			iterator end() noexcept { return iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+			iterator end() noexcept { return iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, m_OtherPools); };
 			/* Const begin of view iterator */
-			const_iterator cbegin() const noexcept { return const_iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+			const_iterator cbegin() const noexcept { return const_iterator(_EntitiesBegin(), _EntitiesEnd(), m_Manager, m_OtherPools); };
 			/* Const end of view iterator */
-			const_iterator cend() const noexcept { return const_iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, PrepareOtherPools(m_Candidate, m_Pools)); };
+			const_iterator cend() const noexcept { return const_iterator(_EntitiesEnd(), _EntitiesEnd(), m_Manager, m_OtherPools); };
 		private:
+			const Storages m_Storages;
 			const Candidate* m_Candidate;
-			const Pools* m_Pools;
+			const OtherPools m_OtherPools;
 			EntityManager* const m_Manager;
 		private:
 			const Entity* _EntitiesBegin() const noexcept { return (m_Candidate) ? m_Candidate->GetData() : nullptr; };
@@ -98,12 +136,29 @@ namespace shade
 			Entity* _EntitiesBegin() noexcept { return const_cast<Entity*>(const_cast<const BasicView*>(this)->_EntitiesBegin()); };
 			Entity* _EntitiesEnd()  noexcept { return const_cast<Entity*>(const_cast<const BasicView*>(this)->_EntitiesEnd()); };
 
+			/* Check if entity exist in other needed pools*/
+			[[nodiscard]] bool InOtherPools(const Entity& entity) const
+			{
+				return std::all_of(m_OtherPools.cbegin(), m_OtherPools.cend(), [&entity](const SparseSet<Entity>* current) { return current->Contains(entity); });
+			}
+			/* Return lowest SparseSet or nullptr if any of pools doesn't exist */
+			[[nodiscard]] static const Candidate* GetCandidate(const Storages& storages)
+			{
+				if ((std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(storages) && ...))
+				{
+					return (std::min)({ static_cast<const Candidate*>(std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(storages))... }, [](const auto& left, const auto& right)
+						{
+							return left->GetSize() < right->GetSize();
+						});
+				}
+				return nullptr;
+			}
 			/* Prepare pools of needed components */
-			[[nodiscard]] OtherPools PrepareOtherPools(const Candidate* candidate, const Pools* pools) const
+			[[nodiscard]] static OtherPools PrepareOtherPools(const Candidate* candidate, const Storages& storages)
 			{
 				std::size_t position = 0; OtherPools others{};
 				if (candidate)
-					((static_cast<const SparseSet<Entity>*>((*pools).at(Hash<Component>()).get()) == candidate ? nullptr : (others[position] = static_cast<const SparseSet<Entity>*>((*pools).at(Hash<Component>()).get()), others[position++])), ...);
+					((static_cast<const Candidate*>(std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(storages)) == candidate ? nullptr : (others[position] = static_cast<const Candidate*>(std::get<ComponentStorage<std::remove_const_t<Component>, Entity>*>(storages)), others[position++])), ...);
 				return others;
 			}
 		};
@@ -2,10 +2,79 @@
 #include "GraphContext.h"
 #include <shade/core/graphs/nodes/BaseNode.h>
 
+namespace
+{
+	// Graph instance bound to the current thread, every thread evaluates its own instances
+	static thread_local shade::graphs::GraphInstance* s_pBoundInstance = nullptr;
+}
+
+shade::graphs::GraphInstance::Scope::Scope(GraphContext& context, GraphInstance* pInstance) :
+	m_pPrevious(s_pBoundInstance)
+{
+	if (pInstance && (pInstance->m_pContext != &context || pInstance->m_TopologyVersion != context.GetTopologyVersion()))
+		pInstance->Build(context);
+
+	s_pBoundInstance = pInstance;
+}
+
+shade::graphs::GraphInstance::Scope::~Scope()
+{
+	s_pBoundInstance = m_pPrevious;
+}
+
+shade::graphs::GraphInstance* shade::graphs::GraphInstance::GetBound()
+{
+	return s_pBoundInstance;
+}
+
+void shade::graphs::GraphInstance::Build(const GraphContext& context)
+{
+	m_pContext = &context; m_TopologyVersion = context.GetTopologyVersion();
+
+	m_Endpoints.clear(); m_Endpoints.resize(context.GetInstanceSlotsCount());
+	m_States.clear(); m_States.resize(context.GetInstanceSlotsCount());
+
+	// Connected endpoints share one value in the definition, copies have to be shared the same way
+	ankerl::unordered_dense::map<const NodeValue*, NodeValues::Value> copies;
+
+	auto copy = [&copies](const NodeValues::Value& value) -> NodeValues::Value
+	{
+		if (!value) return value;
+
+		auto [entry, isCreated] = copies.try_emplace(value.get());
+
+		if (isCreated)
+		{
+			entry->second = std::make_shared<NodeValue>(*value);
+			// Poses are owned by instance controller, so pointers from the definition are never valid here
+			if (value->GetType() == NodeValueType::Pose) entry->second->Initialize<NodeValueType::Pose>(nullptr);
+		}
+
+		return entry->second;
+	};
+
+	for (const auto& [pNode, pack] : context.GetNodes())
+	{
+		NodeEndpoints& endpoints = m_Endpoints[pNode->GetInstanceSlot()];
+
+		for (std::size_t type = 0; type < endpoints.size(); ++type)
+		{
+			for (const auto& [value, defaultValue] : pNode->m_Endpoints[type])
+				endpoints[type].Emplace(copy(value), copy(defaultValue));
+		}
+	}
+}
+
+shade::graphs::GraphInstance* shade::graphs::GraphContext::GetBoundInstance() const
+{
+	GraphInstance* pInstance = GraphInstance::GetBound();
+	return (pInstance && pInstance->GetContext() == this) ? pInstance : nullptr;
+}
+
 void shade::graphs::GraphContext::InitializeNode(BaseNode* pNode, BaseNode* pParrent)
 {
 	// Add the node to the Nodes map and initialize it.
-	Nodes.emplace(pNode, NodesPack{}).first->first->Initialize();
+	Nodes.emplace(pNode, NodesPack{}).first->first->Initialize(); ++TopologyVersion;
 }
 
 shade::graphs::GraphContext::~GraphContext()
@@ -54,7 +123,7 @@ bool shade::graphs::GraphContext::RemoveNode(BaseNode* pNode)
 	// Shutdown the node and deallocate its memory.
 	pNode->Shutdown();
 	SDELETE pNode;
-	Nodes.erase(node);
+	Nodes.erase(node); ++TopologyVersion;
 
 	return true;
 }
@@ -66,7 +135,7 @@ void shade::graphs::GraphContext::RemoveAll()
 		pNode->Shutdown();
 		SDELETE pNode;
 	}
-	Nodes.clear(); pRoot = nullptr;
+	Nodes.clear(); pRoot = nullptr; ++TopologyVersion;
 	
 }
 
@@ -88,7 +157,50 @@ void shade::graphs::GraphContext::Drop()
 		}
 	}
 
-	pRoot = nullptr;
+	pRoot = nullptr; ++TopologyVersion;
+}
+
+void shade::graphs::GraphContext::CompileEvaluationOrder(const BaseNode* pNode, std::vector<BaseNode*>& order) const
+{
+	order.clear();
+
+	// Iterative post order walk over input connections, node is emitted once all nodes it depends on are emitted
+	ankerl::unordered_dense::set<const BaseNode*> visited = { pNode };
+	std::vector<std::pair<const BaseNode*, std::size_t>> stack = { { pNode, 0 } };
+
+	while (!stack.empty())
+	{
+		const BaseNode* node = stack.back().first;
+		const std::vector<Connection>* connections = GetConnections(node);
+
+		if (connections && stack.back().second < connections->size())
+		{
+			const BaseNode* pConnectedFrom = (*connections)[stack.back().second++].PConnectedFrom;
+
+			if (visited.emplace(pConnectedFrom).second) stack.emplace_back(pConnectedFrom, 0);
+		}
+		else
+		{
+			if (node != pNode) order.emplace_back(const_cast<BaseNode*>(node));
+			stack.pop_back();
+		}
+	}
+}
+
+void shade::graphs::GraphContext::CompileEvaluationOrders()
+{
+	// Lists are up to date on almost every evaluation, so lock is taken only after topology has changed
+	if (CompiledVersion.load(std::memory_order_acquire) == TopologyVersion) return;
+
+	// Several instances of the graph can be evaluated concurrently, the first one compiles lists for all of them
+	std::lock_guard lock(CompileMutex);
+
+	if (CompiledVersion.load(std::memory_order_relaxed) == TopologyVersion) return;
+
+	for (auto& [pNode, pack] : Nodes)
+		CompileEvaluationOrder(pNode, pNode->m_EvaluationOrder);
+
+	CompiledVersion.store(TopologyVersion, std::memory_order_release);
 }
 
 shade::graphs::BaseNode* shade::graphs::GraphContext::FindInternalNode(BaseNode* pParrent, NodeIdentifier identifier)
@@ -136,6 +248,7 @@ bool shade::graphs::GraphContext::ConnectNodes(BaseNode* pConnectedTo, EndpointI
 	// Create the connection between the nodes.
 	if (CreateConnection(pConnectedTo, connectedToEndpoint, pConnectedFrom, connectedFromEndpoint))
 	{
+		pConnectedTo->MarkDirty();
 		// Connect the values and notify the nodes of the connection.
 		if (ConnectValues(inputValue, outputValue))
 		{
@@ -165,6 +278,7 @@ bool shade::graphs::GraphContext::DisconnectNodes(BaseNode* pConnectedTo, Endpoi
 		// Remove the connection and notify the nodes of the disconnection.
 		if (RemoveConnection(pConnectedTo, connectedToEndpoint, pConnectedFrom, connectedFromEndpoint))
 		{
+			pConnectedTo->MarkDirty();
 			pConnectedTo->OnDisconnect(Connection::Type::Input, connectedToValue->get()->GetType(), connectedToEndpoint);
 			pConnectedFrom->OnDisconnect(Connection::Type::Output, connectedFromValue->get()->GetType(), connectedFromEndpoint);
 
@@ -192,6 +306,7 @@ bool shade::graphs::GraphContext::DisconnectEndpoint(BaseNode* pConnectedTo, End
 		// Remove the connection and notify the nodes of the disconnection.
 		if (RemoveConnection(pConnectedTo, connectedToEndpoint, connection->PConnectedFrom, connection->ConnectedFromEndpoint))
 		{
+			pConnectedTo->MarkDirty();
 			pConnectedTo->OnDisconnect(Connection::Type::Input, connectedToValue->get()->GetType(), connectedToEndpoint);
 			connection->PConnectedFrom->OnDisconnect(Connection::Type::Output, connectedFromValue->get()->GetType(), connection->ConnectedFromEndpoint);
 
@@ -302,4 +417,7 @@ void shade::graphs::GraphContext::Deserialize(std::istream& stream)
 			ConnectNodes(FindNode(connectedToIdentifier), connectedToEndpoint, FindNode(connectedFromIdentifier), connectedFromEndpoint);
 		}
 	}
+
+	// Loaded graph is evaluated right away, so its lists are compiled here instead of on first evaluation
+	CompileEvaluationOrders();
 }
\ No newline at end of file
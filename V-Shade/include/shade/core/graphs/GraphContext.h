@@ -46,6 +46,118 @@ namespace shade
 			std::vector<BaseNode*>  InternalNodes;
 		};
 
+		/// @brief Input and output endpoints of a graph node.
+		using NodeEndpoints = std::array<NodeValues, static_cast<std::size_t>(Connection::Type::MAX_ENUM)>;
+
+		struct GraphContext;
+
+		/// @brief Base for node specific runtime state, like play time or active transition, which is kept per graph instance.
+		struct NodeInstanceState
+		{
+			virtual ~NodeInstanceState() = default;
+		};
+
+		/// @brief Runtime state of a graph for one of its users.
+		/// Nodes and connections are the graph definition and are shared by all instances, an instance keeps only values of endpoints,
+		/// evaluation bookkeeping and node specific state, all indexed by node instance slot.
+		class SHADE_API GraphInstance
+		{
+		public:
+			SHADE_CAST_HELPER(GraphInstance)
+
+			/// @brief Evaluation state of a single node.
+			struct NodeState
+			{
+				/// @brief Evaluation stamp when the node has been evaluated last time.
+				std::uint64_t EvaluatedStamp = 0;
+
+				/// @brief Input values of last evaluation, used by pure nodes only.
+				std::vector<NodeValue> InputsSnapshot;
+
+				/// @brief Flag to force evaluation of pure node.
+				bool IsDirty = true;
+
+				/// @brief Node specific state, created from node's own one on first access.
+				std::shared_ptr<NodeInstanceState> Runtime;
+			};
+
+			/// @brief Binds instance to the current thread while the scope is alive, nodes of its graph work with the instance state instead of their own one.
+			class SHADE_API Scope
+			{
+			public:
+				/// @brief Binds instance, it's rebuilt from the graph definition if the graph has been changed since last binding.
+				/// @param context Context of the graph.
+				/// @param pInstance Instance to bind, nullptr lets the graph work with its own state.
+				Scope(GraphContext& context, GraphInstance* pInstance);
+				~Scope();
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+			private:
+				GraphInstance* m_pPrevious;
+			};
+		public:
+			GraphInstance() = default;
+			virtual ~GraphInstance() = default;
+
+			/// @brief Gets instance bound to the current thread.
+			/// @return Pointer to the instance, or nullptr if none is bound.
+			static GraphInstance* GetBound();
+
+			/// @brief Gets context the instance has been built for.
+			/// @return Pointer to the context, or nullptr if the instance hasn't been bound yet.
+			SHADE_INLINE const GraphContext* GetContext() const
+			{
+				return m_pContext;
+			}
+
+			/// @brief Gets evaluation state of a node.
+			/// @param slot Instance slot of the node.
+			/// @return Reference to the node state.
+			SHADE_INLINE NodeState& GetNodeState(std::uint32_t slot)
+			{
+				return m_States[slot];
+			}
+
+			/// @brief Gets endpoints of a node, connected endpoints share values the same way as in the definition.
+			/// @param slot Instance slot of the node.
+			/// @return Reference to the node endpoints.
+			SHADE_INLINE NodeEndpoints& GetEndpoints(std::uint32_t slot)
+			{
+				return m_Endpoints[slot];
+			}
+
+			/// @brief Starts new evaluation of the instance.
+			SHADE_INLINE void BeginEvaluation()
+			{
+				++m_EvaluationStamp;
+			}
+
+			/// @brief Gets stamp of current evaluation.
+			/// @return The evaluation stamp.
+			SHADE_INLINE std::uint64_t GetEvaluationStamp() const
+			{
+				return m_EvaluationStamp;
+			}
+
+		private:
+			/// @brief Copies endpoint values of all nodes and resets evaluation and node specific state.
+			/// @param context Context of the graph.
+			void Build(const GraphContext& context);
+
+			/// @brief Context the instance has been built for.
+			const GraphContext* m_pContext = nullptr;
+
+			/// @brief Topology version of the context the instance has been built for.
+			std::uint64_t m_TopologyVersion = 0;
+
+			/// @brief Incremented on every evaluation of the instance.
+			std::uint64_t m_EvaluationStamp = 0;
+
+			std::vector<NodeEndpoints> m_Endpoints;
+			std::vector<NodeState> m_States;
+		};
+
 		/// @brief Structure representing the context of a graph.
 		struct GraphContext
 		{
@@ -88,6 +200,63 @@ namespace shade
 				pRoot = pNode;
 			}
 
+			/// @brief Starts new evaluation of the graph, every node is evaluated at most once within it.
+			SHADE_INLINE void BeginEvaluation()
+			{
+				if (GraphInstance* pInstance = GetBoundInstance())
+					pInstance->BeginEvaluation();
+				else
+					++EvaluationStamp;
+			}
+
+			/// @brief Gets stamp of current evaluation.
+			/// @return The evaluation stamp.
+			SHADE_INLINE std::uint64_t GetEvaluationStamp() const
+			{
+				const GraphInstance* pInstance = GetBoundInstance();
+				return (pInstance) ? pInstance->GetEvaluationStamp() : EvaluationStamp;
+			}
+
+			/// @brief Gets version of graph topology, it changes whenever connections or nodes are removed or added.
+			/// @return The topology version.
+			SHADE_INLINE std::uint64_t GetTopologyVersion() const
+			{
+				return TopologyVersion;
+			}
+
+			/// @brief Forces all instances of the graph to be rebuilt from the definition on next binding.
+			SHADE_INLINE void InvalidateInstances()
+			{
+				++TopologyVersion;
+			}
+
+			/// @brief Gets instance of this graph bound to the current thread.
+			/// @return Pointer to the instance, or nullptr if nodes work with their own state.
+			SHADE_API GraphInstance* GetBoundInstance() const;
+
+			/// @brief Reserves slot for a new node in the state of graph instances.
+			/// @return The slot index.
+			SHADE_INLINE std::uint32_t AcquireInstanceSlot()
+			{
+				return InstanceSlotsCount++;
+			}
+
+			/// @brief Gets count of reserved instance slots.
+			/// @return The count of slots.
+			SHADE_INLINE std::uint32_t GetInstanceSlotsCount() const
+			{
+				return InstanceSlotsCount;
+			}
+
+			/// @brief Collects all upstream nodes of a given node in topological order, every node appears once and after all nodes it depends on.
+			/// @param pNode Pointer to the node whose branch is compiled, the node itself isn't included.
+			/// @param order Output evaluation list.
+			SHADE_API void CompileEvaluationOrder(const BaseNode* pNode, std::vector<BaseNode*>& order) const;
+
+			/// @brief Compiles evaluation lists of all nodes if topology has changed since last compilation.
+			/// @note Safe to call from several threads evaluating different instances of the graph.
+			SHADE_API void CompileEvaluationOrders();
+
 			/// @brief Removes a node from the graph context.
 			/// @param pNode Pointer to the node to be removed.
 			/// @return True if the node was successfully removed, otherwise false.
@@ -245,6 +414,7 @@ namespace shade
 				if (IsEndpointFree(pConnectedTo, connectedToEndpoint) && !FindConnection(pConnectedTo, connectedToEndpoint, pConnectedFrom, connectedFromEndpoint))
 				{
 					Nodes.at(pConnectedTo).Connections.emplace_back(Connection{ pConnectedTo, connectedToEndpoint, pConnectedFrom, connectedFromEndpoint });
+					++TopologyVersion;
 					return true; // Return true if the connection was created
 				}
 
@@ -280,6 +450,7 @@ namespace shade
 				if (connection != connections.end())
 				{
 					connections.erase(connection); // Remove the connection if found
+					++TopologyVersion;
 					return true; // Return true if the connection was removed
 				}
 
@@ -347,6 +518,21 @@ namespace shade
 			/// @brief First created node.
 			BaseNode* pRoot = nullptr;
 
+			/// @brief Incremented on every graph evaluation without bound instance.
+			std::uint64_t EvaluationStamp = 0;
+
+			/// @brief Incremented on every change of nodes or connections, compiled evaluation lists and graph instances are rebuilt when it differs.
+			std::uint64_t TopologyVersion = 1;
+
+			/// @brief Topology version evaluation lists have been compiled for.
+			std::atomic<std::uint64_t> CompiledVersion = 0;
+
+			/// @brief Serializes compilation between instances evaluated concurrently.
+			std::mutex CompileMutex;
+
+			/// @brief Count of instance slots given to nodes, slots of removed nodes aren't reused.
+			std::uint32_t InstanceSlotsCount = 0;
+
 			/// @brief Serializes node's connections to the given output stream.
 			/// @param stream The output stream to serialize to.
 			/// @return The number of bytes written.
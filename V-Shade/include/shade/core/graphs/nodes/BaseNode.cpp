@@ -6,6 +6,7 @@ shade::graphs::BaseNode::BaseNode(GraphContext* context, NodeIdentifier identifi
 	m_pGraphContext(context), m_NodeIdentifier(identifier), m_Name(name), m_pParrentNode(pParentNode),
 	m_pRootParrentNode(pParentNode ? (pParentNode->GetParrentRootGraph() ? nullptr : pParentNode) : nullptr)
 {
+	if (m_pGraphContext) m_InstanceSlot = m_pGraphContext->AcquireInstanceSlot();
 }
 
 shade::graphs::BaseNode::~BaseNode()
@@ -68,19 +69,53 @@ void shade::graphs::BaseNode::OnDisconnect(Connection::Type connectionType, Node
 
 void shade::graphs::BaseNode::ProcessBranch(const FrameTimer& deltaTime)
 {
-	//1. If there no connections we need to Evaluate node and go back to parrent
-	//2. If there some connections we need go till end of branch
 	assert(m_pGraphContext != nullptr);
 
-	auto connections = m_pGraphContext->GetConnections(this);
+	// Top level graph starts new evaluation, nodes evaluated in previous one become stale
+	if (!HasParrent())
+	{
+		m_pGraphContext->CompileEvaluationOrders();
+		m_pGraphContext->BeginEvaluation();
+	}
+
+	for (BaseNode* pNode : m_EvaluationOrder)
+		pNode->EvaluateOnce(deltaTime);
+
+	EvaluateOnce(deltaTime);
+}
+
+void shade::graphs::BaseNode::EvaluateOnce(const FrameTimer& deltaTime)
+{
+	// Node can feed several consumers, but it's evaluated only once per evaluation
+	GraphInstance::NodeState& state = GetNodeState();
+
+	if (state.EvaluatedStamp == m_pGraphContext->GetEvaluationStamp()) return;
+
+	state.EvaluatedStamp = m_pGraphContext->GetEvaluationStamp();
 
-	if (connections)
+	if (!IsPure() || HasInputsChanged(state)) Evaluate(deltaTime);
+}
+
+bool shade::graphs::BaseNode::HasInputsChanged(GraphInstance::NodeState& state)
+{
+	const NodeValues& inputs = GetEndpoints()[Connection::Type::Input];
+
+	bool hasChanged = state.IsDirty || state.InputsSnapshot.size() != inputs.GetSize();
+
+	for (std::size_t i = 0; !hasChanged && i < inputs.GetSize(); ++i)
+		hasChanged = !(state.InputsSnapshot[i] == *inputs[i]);
+
+	if (hasChanged)
 	{
-		for (auto& connection : *connections)
-			connection.PConnectedFrom->ProcessBranch(deltaTime);
+		state.InputsSnapshot.resize(inputs.GetSize());
+
+		for (std::size_t i = 0; i < inputs.GetSize(); ++i)
+			state.InputsSnapshot[i] = *inputs[i];
+
+		state.IsDirty = false;
 	}
 
-	Evaluate(deltaTime);
+	return hasChanged;
 }
 
 void shade::graphs::BaseNode::SerializeBody(std::ostream& stream) const
@@ -50,8 +50,19 @@ namespace shade
 
 			/// @brief Function for processing the branch of nodes
 			/// @param deltaTime The time elapsed since the last processing
+			/// @note Upstream nodes are evaluated from a flat list compiled once per connections change, every node is evaluated at most once per graph evaluation.
 			void ProcessBranch(const FrameTimer& deltaTime);
 
+			/// @brief Marks the node to be evaluated on next processing even if its inputs haven't changed.
+			SHADE_INLINE void MarkDirty()
+			{
+				GetNodeState().IsDirty = true;
+			}
+
+			/// @brief Checks if output of the node depends only on its inputs.
+			/// @return True if the node is pure, such node is evaluated only when its inputs change.
+			virtual bool IsPure() const { return false; }
+
 			/// @brief Connects nodes based on their endpoints.
 			/// @param connectedToEndpoint The endpoint identifier to connect to.
 			/// @param pConnectedFrom The node being connected from.
@@ -218,6 +229,12 @@ namespace shade
 			{
 				return m_pGraphContext;
 			}
+			/// @brief Gets slot of the node in the state of graph instances.
+			/// @return The slot index.
+			SHADE_INLINE std::uint32_t GetInstanceSlot() const
+			{
+				return m_InstanceSlot;
+			}
 			/// @brief Retrieves the root parent graph.
 			/// @return Const pointer to the root parent graph.
 			SHADE_INLINE const BaseNode* GetParrentRootGraph() const { return m_pRootParrentNode; }
@@ -262,7 +279,8 @@ namespace shade
 			template<typename Connection::Type T>
 			SHADE_INLINE NodeValues::Value GetEndpoint(EndpointIdentifier index)
 			{
-				return ((index < m_Endpoints[static_cast<std::size_t>(T)].GetSize()) ? m_Endpoints[static_cast<std::size_t>(T)].At(index) : nullptr);
+				NodeEndpoints& endpoints = GetEndpoints();
+				return ((index < endpoints[static_cast<std::size_t>(T)].GetSize()) ? endpoints[static_cast<std::size_t>(T)].At(index) : nullptr);
 			}
 
 			/// @brief Template function for getting the value of a specific endpoint (const version).
@@ -272,21 +290,23 @@ namespace shade
 			template<typename Connection::Type T>
 			SHADE_INLINE const NodeValues::Value GetEndpoint(EndpointIdentifier index) const
 			{
-				return ((index < m_Endpoints[static_cast<std::size_t>(T)].GetSize()) ? m_Endpoints[static_cast<std::size_t>(T)].At(index) : NodeValues::Value());
+				const NodeEndpoints& endpoints = GetEndpoints();
+				return ((index < endpoints[static_cast<std::size_t>(T)].GetSize()) ? endpoints[static_cast<std::size_t>(T)].At(index) : NodeValues::Value());
 			}
 
-			/// @brief Getter for all endpoints.
+			/// @brief Getter for all endpoints, they belong to the graph instance bound to the current thread if there is one.
 			/// @return Reference to the array of endpoints.
-			SHADE_INLINE std::array<NodeValues, static_cast<std::size_t>(Connection::Type::MAX_ENUM)>& GetEndpoints()
+			SHADE_INLINE NodeEndpoints& GetEndpoints()
 			{
-				return m_Endpoints;
+				GraphInstance* pInstance = (m_pGraphContext) ? m_pGraphContext->GetBoundInstance() : nullptr;
+				return (pInstance) ? pInstance->GetEndpoints(m_InstanceSlot) : m_Endpoints;
 			}
 
 			/// @brief Getter for all endpoints (const version).
 			/// @return Const reference to the array of endpoints.
-			SHADE_INLINE const std::array<NodeValues, static_cast<std::size_t>(Connection::Type::MAX_ENUM)>& GetEndpoints() const
+			SHADE_INLINE const NodeEndpoints& GetEndpoints() const
 			{
-				return m_Endpoints;
+				return const_cast<BaseNode*>(this)->GetEndpoints();
 			}
 
 			/*/// @brief Getter for all endpoints.
@@ -321,6 +341,7 @@ namespace shade
 				requires IsNodeValueType<typename FromNodeValueTypeToType<ValueType>::Type>
 			SHADE_INLINE EndpointIdentifier REGISTER_ENDPOINT(Args&&... args)
 			{
+				if (m_pGraphContext) m_pGraphContext->InvalidateInstances();
 				return m_Endpoints[static_cast<std::size_t>(ConnectionType)].Emplace<ValueType>(std::forward<Args>(args)...);
 			}
 
@@ -329,6 +350,7 @@ namespace shade
 			template<typename Connection::Type ConnectionType>
 			SHADE_INLINE void REMOVE_ENDPOINT(EndpointIdentifier index)
 			{
+				if (m_pGraphContext) m_pGraphContext->InvalidateInstances();
 				m_Endpoints[static_cast<std::size_t>(ConnectionType)].Remove(index);
 			}
 
@@ -341,10 +363,12 @@ namespace shade
 				requires IsNodeValueType<typename FromNodeValueTypeToType<ValueType>::Type>
 			SHADE_INLINE typename FromNodeValueTypeToType<ValueType>::Type& GET_ENDPOINT(EndpointIdentifier index, Args&&... args)
 			{
+				NodeValues::Value& value = GetEndpoints()[static_cast<std::size_t>(ConnectionType)].At(index);
+
 				if constexpr (sizeof...(args) > 0)
-					m_Endpoints[static_cast<std::size_t>(ConnectionType)].At(index)->Initialize<ValueType>(std::forward<Args>(args)...);
+					value->Initialize<ValueType>(std::forward<Args>(args)...);
 
-				return m_Endpoints[static_cast<std::size_t>(ConnectionType)].At(index)->As<ValueType>();
+				return value->As<ValueType>();
 			}
 
 			/// @brief Template function for getting the value of a specific endpoint (const version)
@@ -355,10 +379,10 @@ namespace shade
 				requires IsNodeValueType<typename FromNodeValueTypeToType<ValueType>::Type>
 			SHADE_INLINE const typename FromNodeValueTypeToType<ValueType>::Type& GET_ENDPOINT(EndpointIdentifier index) const
 			{
-				return m_Endpoints[static_cast<std::size_t>(ConnectionType)].At(index)->As<ValueType>();
+				return GetEndpoints()[static_cast<std::size_t>(ConnectionType)].At(index)->As<ValueType>();
 			}
 
-			/// @brief Helper function for getting the pointer to an endpoint value
+			/// @brief Helper function for getting the pointer to an endpoint value of the graph definition, used to connect endpoints
 			/// @tparam T The type of the connection (Input or Output)
 			/// @param index The index of the endpoint
 			/// @return A pointer to the endpoint value or nullptr if index is out of bounds
@@ -411,8 +435,51 @@ namespace shade
 			/// @brief Screen position of node, uses only in editor.
 			glm::vec2 m_ScreenPosition = glm::vec2(0.f);
 
-			/// @brief Array of node values for input and output connections.
-			std::array<NodeValues, static_cast<std::size_t>(Connection::Type::MAX_ENUM)> m_Endpoints;
+			/// @brief Array of node values for input and output connections, the graph definition which graph instances are built from.
+			NodeEndpoints m_Endpoints;
+
+			/// @brief Upstream nodes of the branch in evaluation order, compiled by context once per topology change.
+			std::vector<BaseNode*> m_EvaluationOrder;
+
+			/// @brief Slot of the node in the state of graph instances.
+			std::uint32_t m_InstanceSlot = 0;
+
+			/// @brief Evaluation state used when no graph instance is bound.
+			GraphInstance::NodeState m_NodeState;
+
+			/// @brief Gets evaluation state of the node in the bound graph instance, or its own one.
+			/// @return Reference to the node state.
+			SHADE_INLINE GraphInstance::NodeState& GetNodeState() const
+			{
+				GraphInstance* pInstance = (m_pGraphContext) ? m_pGraphContext->GetBoundInstance() : nullptr;
+				return (pInstance) ? pInstance->GetNodeState(m_InstanceSlot) : const_cast<GraphInstance::NodeState&>(m_NodeState);
+			}
+
+			/// @brief Gets node specific runtime state of the bound graph instance, it's copied from the node's own state on first access.
+			/// @tparam T The type of the state.
+			/// @param own The state used when no graph instance is bound.
+			/// @return Reference to the state.
+			template<typename T>
+			SHADE_INLINE T& GetInstanceState(const T& own) const
+			{
+				GraphInstance* pInstance = (m_pGraphContext) ? m_pGraphContext->GetBoundInstance() : nullptr;
+
+				if (!pInstance) return const_cast<T&>(own);
+
+				std::shared_ptr<NodeInstanceState>& runtime = pInstance->GetNodeState(m_InstanceSlot).Runtime;
+				if (!runtime) runtime = std::make_shared<T>(own);
+
+				return static_cast<T&>(*runtime);
+			}
+
+			/// @brief Evaluates the node once per context evaluation, pure node only when its inputs have changed.
+			/// @param deltaTime The time elapsed since the last evaluation.
+			void EvaluateOnce(const FrameTimer& deltaTime);
+
+			/// @brief Compares inputs with values of last evaluation and keeps current ones.
+			/// @param state Evaluation state of the node.
+			/// @return True if any input has changed or node is dirty.
+			bool HasInputsChanged(GraphInstance::NodeState& state);
 
 			/// @brief Serializes the base node to the given output stream.
 			/// @param stream The output stream to serialize to.
@@ -438,6 +505,8 @@ namespace shade
 			BaseNode* CreateNodeByType(NodeType type);
 
 			friend class serialize::Serializer;
+			friend class GraphInstance;
+			friend struct GraphContext;
 		};
 	}
 
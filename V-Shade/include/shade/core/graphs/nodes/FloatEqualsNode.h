@@ -24,6 +24,7 @@ namespace shade
 
 			virtual void OnConnect(Connection::Type connectionType, NodeValueType type, EndpointIdentifier endpoint) override {};
 			virtual void Evaluate(const FrameTimer& deltaTime) override;
+			virtual bool IsPure() const override { return true; }
 		private:
 			float m_Compare = 0;
 		};
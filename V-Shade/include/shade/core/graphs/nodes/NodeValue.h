@@ -190,6 +190,16 @@ namespace shade
 			return *this;
 		}
 
+		/**
+		 * @brief Compares type and value with other NodeValue.
+		 * @param other - The value to compare with.
+		 * @return True if both type and value are equal.
+		 */
+		SHADE_INLINE bool operator==(const NodeValue& other) const
+		{
+			return m_Type == other.m_Type && m_Value == other.m_Value;
+		}
+
 	private:
 		/**
 		 * @brief Template function to get the value of a specific type.
@@ -310,6 +320,18 @@ namespace shade
 			return m_Values.size() - 1;
 		}
 
+		/**
+		 * @brief Emplaces already created current and default values.
+		 * @param value - The current value, can be shared with endpoint of another node.
+		 * @param defaultValue - The value current one is reset to.
+		 * @return The index at which the values are emplaced.
+		 */
+		std::size_t Emplace(const Value& value, const Value& defaultValue)
+		{
+			m_Values.emplace_back(value, defaultValue);
+			return m_Values.size() - 1;
+		}
+
 		/**
 		* @brief Removes the NodeValue at the specified index.
 		* @param index - The index of the NodeValue to remove.
@@ -1,18 +1,34 @@
 #include "shade_pch.h"
 #include "PhysicsManager.h"
 #include <shade/utils/Utils.h>
+#include <shade/core/threads/JobSystem.h>
 
 bool shade::physic::PhysicsManager::m_IsSimulating = true;
 std::size_t shade::physic::PhysicsManager::m_IterationCount = 5;
 shade::physic::scalar_t shade::physic::PhysicsManager::deltaDT = 0;
 shade::physic::PhysicsManager::CashedContactData shade::physic::PhysicsManager::m_ContactsData;
+shade::SharedPointer<shade::physic::BroadPhase> shade::physic::PhysicsManager::m_BroadPhase;
+std::unordered_map<shade::ecs::EntityID, shade::physic::PhysicsManager::BroadPhaseProxy> shade::physic::PhysicsManager::m_Proxies;
+std::vector<shade::physic::PhysicsManager::BroadPhaseBody> shade::physic::PhysicsManager::m_Bodies;
+std::vector<shade::physic::BroadPhase::Pair> shade::physic::PhysicsManager::m_Pairs;
+std::size_t shade::physic::PhysicsManager::m_StepIndex = 0;
+std::vector<std::vector<shade::physic::PhysicsManager::NarrowPhaseContact>> shade::physic::PhysicsManager::m_NarrowPhaseBuffers;
+std::size_t shade::physic::PhysicsManager::m_VelocityIterationCount = 4;
+std::vector<shade::physic::PhysicsManager::SolverContact> shade::physic::PhysicsManager::m_SolverContacts;
+std::vector<std::uint32_t> shade::physic::PhysicsManager::m_IslandParents;
+std::vector<shade::physic::PhysicsManager::Island> shade::physic::PhysicsManager::m_Islands;
 
 void shade::physic::PhysicsManager::Init()
 {
+	SetBroadPhase(BroadPhase::Type::SweepAndPrune);
 }
 
 void shade::physic::PhysicsManager::ShutDown()
 {
+	m_BroadPhase = nullptr;
+	m_Proxies.clear(); m_Bodies.clear(); m_Pairs.clear(); m_NarrowPhaseBuffers.clear();
+	m_ContactsData.Clear();
+	m_SolverContacts.clear(); m_IslandParents.clear(); m_Islands.clear();
 }
 
 void shade::physic::PhysicsManager::Step(SharedPointer<Scene>& scene, const FrameTimer& deltaTime)
@@ -24,8 +40,6 @@ void shade::physic::PhysicsManager::Step(SharedPointer<Scene>& scene, const Fram
 	// 4. Solve collision
 	scalar_t dt	= deltaTime.GetInSeconds<scalar_t>() / scalar_t(m_IterationCount);
 
-	SetIterationCount(5);
-
 	if (m_IsSimulating)
 	{
 		// If delta time lower than 1 seconds 
@@ -33,17 +47,19 @@ void shade::physic::PhysicsManager::Step(SharedPointer<Scene>& scene, const Fram
 		{
 			auto view = scene->View<RigidBodyComponent, TransformComponent>();
 
-			// Clear contacts data
-			m_ContactsData.Clear();
-
 			for (std::size_t i = 0; i < m_IterationCount; i++)
 			{
-				view.Each([&](ecs::Entity& entity, RigidBodyComponent& body, TransformComponent& transform)
+				view.ParallelEach([&](ecs::Entity& entity, RigidBodyComponent& body, TransformComponent& transform)
 					{
-						Integrate(body, transform, dt, deltaDT);
-					});
-
-				DetectCollisions(view, dt);
+						// Sleeping bodies are woken by their island, by applied forces or when they were moved
+						if (!body.IsSleep())
+							Integrate(body, transform, dt, deltaDT);
+						else
+							body.UpdateSleeping(transform);
+					}, 128);
+
+				UpdateBroadPhase(view);
+				DetectCollisions(dt);
 			}
 			// Keep tracking delta time from previous frame
 			deltaDT = dt;
@@ -61,6 +77,30 @@ void shade::physic::PhysicsManager::SetIterationCount(std::size_t count)
 	m_IterationCount = count;
 }
 
+void shade::physic::PhysicsManager::SetVelocityIterationCount(std::size_t count)
+{
+	m_VelocityIterationCount = count;
+}
+
+void shade::physic::PhysicsManager::SetBroadPhase(BroadPhase::Type type)
+{
+	m_BroadPhase = BroadPhase::Create(type);
+	// Proxies are recreated on next step
+	m_Proxies.clear();
+	m_ContactsData.Clear();
+}
+
+shade::physic::BroadPhase::Type shade::physic::PhysicsManager::GetBroadPhaseType()
+{
+	return (m_BroadPhase) ? m_BroadPhase->GetType() : BroadPhase::Type::SweepAndPrune;
+}
+
+const shade::physic::BroadPhase::Statistic& shade::physic::PhysicsManager::GetBroadPhaseStatistic()
+{
+	static const BroadPhase::Statistic empty;
+	return (m_BroadPhase) ? m_BroadPhase->GetStatistic() : empty;
+}
+
 void shade::physic::PhysicsManager::Integrate(RigidBody& body, Transform& transform, scalar_t deltaTime, scalar_t deltaDT)
 {
 	body.ApplayGravity({ 0.0, -9.80 / scalar_t(m_IterationCount), 0.0 });
@@ -68,61 +108,244 @@ void shade::physic::PhysicsManager::Integrate(RigidBody& body, Transform& transf
 	body.ClearForces();
 }
 
-void shade::physic::PhysicsManager::IntegrateContact(const CollisionShape::Manifold& contact, const RigidBody& bodyA, const RigidBody& bodyB)
+shade::physic::AABB shade::physic::PhysicsManager::GetBoundingBox(const RigidBody& body)
+{
+	AABB box{ body.m_Extensions.front().MinHalfExtWorldSpace, body.m_Extensions.front().MaxHalfExtWorldSpace };
+
+	for (const auto& ext : body.m_Extensions)
+		box = box.Union({ ext.MinHalfExtWorldSpace, ext.MaxHalfExtWorldSpace });
+
+	return box;
+}
+
+void shade::physic::PhysicsManager::UpdateBroadPhase(ecs::BasicView<ecs::EntityID, RigidBodyComponent, TransformComponent>& bodies)
 {
-	m_ContactsData.IntegrateContact(contact, bodyA, bodyB);
+	if (!m_BroadPhase)
+		m_BroadPhase = BroadPhase::Create(BroadPhase::Type::SweepAndPrune);
+
+	m_StepIndex++; m_Bodies.clear();
+
+	// Index in m_Bodies is used as proxy user data, so pairs come in view order
+	bodies.Each([&](ecs::Entity& entity, RigidBodyComponent& body, TransformComponent& transform)
+		{
+			if (!body.m_CollisionShapes || body.m_Extensions.empty())
+				return;
+
+			const std::uint32_t index = static_cast<std::uint32_t>(m_Bodies.size());
+			const AABB box = GetBoundingBox(body);
+			const ecs::EntityID id = entity;
+
+			auto proxy = m_Proxies.find(id);
+			if (proxy != m_Proxies.end())
+			{
+				m_BroadPhase->UpdateProxy(proxy->second.Proxy, box, index);
+				proxy->second.Step = m_StepIndex;
+			}
+			else
+			{
+				m_Proxies.emplace(id, BroadPhaseProxy{ m_BroadPhase->CreateProxy(box, index), m_StepIndex });
+			}
+
+			m_Bodies.emplace_back(BroadPhaseBody{ &body, &transform, id });
+		});
+
+	// Remove proxies of entities which were destroyed or lost their colliders
+	for (auto proxy = m_Proxies.begin(); proxy != m_Proxies.end();)
+	{
+		if (proxy->second.Step != m_StepIndex)
+		{
+			m_BroadPhase->DestroyProxy(proxy->second.Proxy);
+			proxy = m_Proxies.erase(proxy);
+		}
+		else
+		{
+			proxy++;
+		}
+	}
+
+	m_BroadPhase->FindPairs(m_Pairs);
 }
 
-shade::StackArray<shade::physic::CollisionShape::Manifold, 4u> shade::physic::PhysicsManager::GetStableContacts(const RigidBody& bodyA, const RigidBody& bodyB)
+void shade::physic::PhysicsManager::DetectCollisions(scalar_t deltaTime)
 {
-	return std::move(m_ContactsData.GetReducedContacts(bodyA, bodyB));
+	NarrowPhase();
+	ResolveContacts(deltaTime);
 }
 
-void shade::physic::PhysicsManager::DetectCollisions(ecs::BasicView<ecs::EntityID, RigidBodyComponent, TransformComponent>& bodies, scalar_t deltaTime)
+void shade::physic::PhysicsManager::NarrowPhase()
 {
-	// We don't have proper iterator + 1 realization, so that's why we use copy of i iterator and incrementing copy+ 1 and asigning to j
-	// Try implement += iterator and use m_Current < m_last and i and j < view.end(); to do not overjump 
+	// Every pair only reads bodies and transforms, so pairs are tested independently
+	m_NarrowPhaseBuffers.resize((m_Pairs.size() + NarrowPhaseGrainSize - 1) / NarrowPhaseGrainSize);
 
-	for (auto iterA = bodies.begin(); iterA != bodies.end(); iterA++)
-	{
-		auto bodyA = iterA->GetComponentRaw<RigidBodyComponent>(); auto& tbA = iterA->GetComponent<TransformComponent>();
-		
-		for (auto iterB = ecs::BasicView<ecs::EntityID, RigidBodyComponent, TransformComponent>::iterator(iterA)++; iterB != bodies.end(); iterB++)
+	thread::JobSystem::GetGlobal().ParallelFor(m_Pairs.size(), NarrowPhaseGrainSize, [](std::size_t first, std::size_t last)
 		{
-			auto bodyB = iterB->GetComponentRaw<RigidBodyComponent>(); auto& tbB = iterB->GetComponent<TransformComponent>();
-			// 1. AABB Test (Narrow phase)
-			// 2. OBB Test  (Middle phase)
-			// 3. Test full collision and generate contact points
-			// 4. Resolve position and impulses
-			if (*bodyA || *bodyB)
+			std::vector<NarrowPhaseContact>& buffer = m_NarrowPhaseBuffers[first / NarrowPhaseGrainSize];
+			buffer.clear();
+
+			for (std::size_t i = first; i < last; ++i)
 			{
-				// Broad Phase
-				if (bodyA->AABB_X_AABB(tbA.GetModelMatrix(), *bodyB, tbB.GetModelMatrix()))
+				RigidBody& bodyA = *m_Bodies[m_Pairs[i].A].Body; const auto& tbA = *m_Bodies[m_Pairs[i].A].Transform;
+				RigidBody& bodyB = *m_Bodies[m_Pairs[i].B].Body; const auto& tbB = *m_Bodies[m_Pairs[i].B].Transform;
+
+				// 1. AABB Test (Broad phase)
+				// 2. OBB Test  (Middle phase)
+				// 3. Test full collision and generate contact points
+				// Pair is skipped if there is no awake dynamic body
+				if ((bodyA && !bodyA.IsSleep()) || (bodyB && !bodyB.IsSleep()))
 				{
-					// Middle Pahse
-					if (bodyA->OBB_X_OBB(tbA.GetModelMatrix(), *bodyB, tbB.GetModelMatrix()))
+					// Broad phase box covers all colliders, so test them one by one
+					if (bodyA.AABB_X_AABB(tbA.GetModelMatrix(), bodyB, tbB.GetModelMatrix()))
 					{
-						//Narrow Phase
-						auto result = bodyA->TestCollision(tbA.GetModelMatrix(), *bodyB, tbB.GetModelMatrix());
-
-						if (result.HasCollision)
+						// Middle Pahse
+						if (bodyA.OBB_X_OBB(tbA.GetModelMatrix(), bodyB, tbB.GetModelMatrix()))
 						{
-							IntegrateContact(result, *bodyA, *bodyB);
-
-							StackArray<CollisionShape::Manifold, 4> contacts = GetStableContacts(*bodyA, *bodyB);
+							//Narrow Phase
+							auto result = bodyA.TestCollision(tbA.GetModelMatrix(), bodyB, tbB.GetModelMatrix());
 
-							PositionSolver(result, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyA, tbA }, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyB, tbB }, deltaTime);
-							ImpulseSolver(contacts, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyA, tbA }, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyB, tbB }, deltaTime);
-
-							for (auto& contact : contacts)
-							{
-								bodyA->m_CollisionContancts.PushFront(contact.ContactPointA_L);
-								bodyB->m_CollisionContancts.PushFront(contact.ContactPointB_L);
-							}
+							if (result.HasCollision)
+								buffer.emplace_back(NarrowPhaseContact{ static_cast<std::uint32_t>(i), result });
 						}
 					}
 				}
 			}
+		});
+}
+
+void shade::physic::PhysicsManager::ResolveContacts(scalar_t deltaTime)
+{
+	m_SolverContacts.clear();
+
+	// Buffers are merged in pair order, so result doesn't depend on threads count
+	for (const auto& buffer : m_NarrowPhaseBuffers)
+	{
+		for (const NarrowPhaseContact& contact : buffer)
+		{
+			const BroadPhase::Pair& pair = m_Pairs[contact.Pair];
+			auto bodyA = m_Bodies[pair.A].Body; auto& tbA = *m_Bodies[pair.A].Transform;
+			auto bodyB = m_Bodies[pair.B].Body; auto& tbB = *m_Bodies[pair.B].Transform;
+
+			CashedContactData::ContactManifold& contacts = m_ContactsData.IntegrateContact({ m_Bodies[pair.A].Entity, m_Bodies[pair.B].Entity }, contact.Manifold, tbA.GetModelMatrix(), tbB.GetModelMatrix(), m_StepIndex);
+
+			PositionSolver(contact.Manifold, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyA, tbA }, std::pair<RigidBodyComponent&, TransformComponent&>{*bodyB, tbB }, deltaTime);
+
+			for (auto& point : contacts)
+			{
+				bodyA->m_CollisionContancts.PushFront(point.Manifold.ContactPointA_L);
+				bodyB->m_CollisionContancts.PushFront(point.Manifold.ContactPointB_L);
+			}
+
+			m_SolverContacts.emplace_back(SolverContact{ pair.A, pair.B, &contacts });
+		}
+	}
+	// Pairs which stopped touching lose their accumulated impulses
+	m_ContactsData.RemoveStale(m_StepIndex);
+
+	BuildIslands();
+
+	// Islands don't share dynamic bodies, static ones are only read by solver
+	thread::JobSystem::GetGlobal().ParallelFor(m_Islands.size(), 1u, [deltaTime](std::size_t first, std::size_t last)
+		{
+			for (std::size_t i = first; i < last; ++i)
+				SolveIsland(m_Islands[i], deltaTime);
+		});
+}
+
+std::uint32_t shade::physic::PhysicsManager::FindIsland(std::uint32_t body)
+{
+	while (m_IslandParents[body] != body)
+	{
+		m_IslandParents[body] = m_IslandParents[m_IslandParents[body]];
+		body = m_IslandParents[body];
+	}
+	return body;
+}
+
+void shade::physic::PhysicsManager::BuildIslands()
+{
+	m_IslandParents.resize(m_Bodies.size());
+	for (std::uint32_t i = 0; i < m_IslandParents.size(); ++i)
+		m_IslandParents[i] = i;
+
+	// Static bodies don't link islands, otherwise whole scene becomes one island through the ground
+	for (const SolverContact& contact : m_SolverContacts)
+	{
+		if (*m_Bodies[contact.A].Body && *m_Bodies[contact.B].Body)
+		{
+			const std::uint32_t a = FindIsland(contact.A), b = FindIsland(contact.B);
+			// Lower root wins, so islands are the same for the same input
+			if (a != b) m_IslandParents[glm::max(a, b)] = glm::min(a, b);
+		}
+	}
+
+	m_Islands.clear();
+	std::vector<std::uint32_t> islandIndices(m_Bodies.size(), ~0u);
+
+	for (std::uint32_t i = 0; i < m_Bodies.size(); ++i)
+	{
+		if (!*m_Bodies[i].Body) continue;
+
+		const std::uint32_t root = FindIsland(i);
+		if (islandIndices[root] == ~0u)
+		{
+			islandIndices[root] = static_cast<std::uint32_t>(m_Islands.size());
+			m_Islands.emplace_back();
+		}
+		m_Islands[islandIndices[root]].Bodies.emplace_back(i);
+	}
+
+	for (std::uint32_t i = 0; i < m_SolverContacts.size(); ++i)
+	{
+		const SolverContact& contact = m_SolverContacts[i];
+		const std::uint32_t dynamic = (*m_Bodies[contact.A].Body) ? contact.A : contact.B;
+		m_Islands[islandIndices[FindIsland(dynamic)]].Contacts.emplace_back(i);
+	}
+}
+
+void shade::physic::PhysicsManager::SolveIsland(Island& island, scalar_t deltaTime)
+{
+	bool isAwake = false, canSleep = true;
+	for (const std::uint32_t index : island.Bodies)
+	{
+		const RigidBody& body = *m_Bodies[index].Body;
+		isAwake  |= !body.IsSleep();
+		canSleep &= (body.m_TimeToSleep >= TimeToSleep);
+	}
+
+	// Island at rest costs nothing until something touches it
+	if (!isAwake) return;
+
+	auto makePair = [](std::uint32_t index) { return std::pair<RigidBodyComponent&, TransformComponent&>{ *m_Bodies[index].Body, *m_Bodies[index].Transform }; };
+
+	for (const std::uint32_t index : island.Contacts)
+	{
+		const SolverContact& contact = m_SolverContacts[index];
+		WarmStart(*contact.Contacts, makePair(contact.A), makePair(contact.B));
+	}
+
+	for (std::size_t iteration = 0; iteration < m_VelocityIterationCount; ++iteration)
+	{
+		for (const std::uint32_t index : island.Contacts)
+		{
+			const SolverContact& contact = m_SolverContacts[index];
+			ImpulseSolver(*contact.Contacts, makePair(contact.A), makePair(contact.B), deltaTime);
+		}
+	}
+
+	// Whole island sleeps or wakes together
+	for (const std::uint32_t index : island.Bodies)
+	{
+		RigidBody& body = *m_Bodies[index].Body;
+		if (canSleep)
+		{
+			if (!body.IsSleep())
+				body.m_SleepTransform = m_Bodies[index].Transform->GetModelMatrix();
+
+			body.SetSleep(true);
+			body.LinearVelocity *= 0.0; body.AngularVelocity *= 0.0;
+		}
+		else if (body.IsSleep())
+		{
+			body.WakeUp();
 		}
 	}
 }
@@ -144,62 +367,87 @@ void shade::physic::PhysicsManager::PositionSolver(const CollisionShape::Manifol
 	if (bBody) trbB.Move( resolution);
 }
 
-void shade::physic::PhysicsManager::ImpulseSolver(const StackArray<CollisionShape::Manifold, 4>& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB, scalar_t deltaTime)
+void shade::physic::PhysicsManager::WarmStart(CashedContactData::ContactManifold& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB)
+{
+	auto& [aBody, aTransform] = bodyA;
+	auto& [bBody, bTransform] = bodyB;
+
+	const scalar_t aInvMass = aBody ? aBody.GetInverseMass() : scalar_t(0.0), bInvMass = bBody ? bBody.GetInverseMass() : scalar_t(0.0);
+	const scalar_t cRestitution = (aBody.Restitution + bBody.Restitution) * scalar_t(0.5);
+	// Slow contacts don't bounce, otherwise resting bodies jitter
+	const scalar_t restitutionThreshold = 1.0;
+
+	for (auto& point : contacts)
+	{
+		glm::vec<3, scalar_t> rA = (point.Manifold.ContactPointA_W - static_cast<glm::vec<3, scalar_t>>(aTransform.GetPosition()));
+		glm::vec<3, scalar_t> rB = (point.Manifold.ContactPointB_W - static_cast<glm::vec<3, scalar_t>>(bTransform.GetPosition()));
+
+		// Restitution is taken from velocity before any impulse of this step
+		glm::vec<3, scalar_t> rVelocity = (bBody.LinearVelocity + glm::cross<scalar_t>(bBody.AngularVelocity, rB)) - (aBody.LinearVelocity + glm::cross<scalar_t>(aBody.AngularVelocity, rA));
+		scalar_t normalVelocity = glm::dot<3, scalar_t>(rVelocity, point.Manifold.Normal);
+		point.VelocityBias = (normalVelocity < -restitutionThreshold) ? -cRestitution * normalVelocity : scalar_t(0.0);
+
+		// Apply impulses accumulated on previous steps
+		glm::vec<3, scalar_t> impulse = point.Manifold.Normal * point.NormalImpulse + point.TangentImpulse;
+
+		if (aBody)
+		{
+			aBody.LinearVelocity  -= impulse * aInvMass;
+			aBody.AngularVelocity -= aBody.GetIntertiaTensor() * glm::cross<scalar_t>(rA, impulse);
+		}
+		if (bBody)
+		{
+			bBody.LinearVelocity  += impulse * bInvMass;
+			bBody.AngularVelocity += bBody.GetIntertiaTensor() * glm::cross<scalar_t>(rB, impulse);
+		}
+	}
+}
+
+void shade::physic::PhysicsManager::ImpulseSolver(CashedContactData::ContactManifold& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB, scalar_t deltaTime)
 {
 	auto& [aBody, aTransform] = bodyA;
 	auto& [bBody, bTransform] = bodyB;
 
-	scalar_t aInvMass     = aBody ? aBody.GetInverseMass() : scalar_t(1.0), bInvMass = bBody ? bBody.GetInverseMass() : scalar_t(1.0);
+	scalar_t aInvMass     = aBody ? aBody.GetInverseMass() : scalar_t(0.0), bInvMass = bBody ? bBody.GetInverseMass() : scalar_t(0.0);
 	scalar_t cFriction    = (aBody.StaticFriction + bBody.StaticFriction) * scalar_t(0.5);
-	scalar_t cRestitution = (aBody.Restitution + bBody.Restitution) * scalar_t(0.5);
 	scalar_t totalMass    = aInvMass + bInvMass;
 
-	scalar_t contactsCount = contacts.GetSize();
-
 	glm::vec<3, scalar_t> aVel = aBody.LinearVelocity, aAngVel = aBody.AngularVelocity;
 	glm::vec<3, scalar_t> bVel = bBody.LinearVelocity, bAngVel = bBody.AngularVelocity;
 
-	for (auto& contact : contacts)
+	// Static body has zero inverse mass and inertia
+	const glm::mat<3, 3, scalar_t> aInertia = aBody ? aBody.GetIntertiaTensor() : glm::mat<3, 3, scalar_t>(0.0);
+	const glm::mat<3, 3, scalar_t> bInertia = bBody ? bBody.GetIntertiaTensor() : glm::mat<3, 3, scalar_t>(0.0);
+
+	for (auto& point : contacts)
 	{
-		// If it's an empty contacts 
-		if (!contact.HasCollision) continue;
+		const CollisionShape::Manifold& contact = point.Manifold;
 		// Calculate the relative positions of the contact points on the two objects
 		glm::vec<3, scalar_t> rA = (contact.ContactPointA_W - static_cast<glm::vec<3, scalar_t>>(aTransform.GetPosition()));
 		glm::vec<3, scalar_t> rB = (contact.ContactPointB_W - static_cast<glm::vec<3, scalar_t>>(bTransform.GetPosition()));
 
-		// Calculate the total velocities of both objects at the contact point
-		glm::vec<3, scalar_t> aTotalVelocity = aVel + glm::cross<scalar_t>(aAngVel, rA);
-		glm::vec<3, scalar_t> bTotalVelocity = bVel + glm::cross<scalar_t>(bAngVel, rB);
 		// Calculate the relative velocity at the contact point
-		glm::vec<3, scalar_t> rVelocity = bTotalVelocity - aTotalVelocity;
+		glm::vec<3, scalar_t> rVelocity = (bVel + glm::cross<scalar_t>(bAngVel, rB)) - (aVel + glm::cross<scalar_t>(aAngVel, rA));
 		// Get the contact normal from the collision information
 		glm::vec<3, scalar_t> contactNormal = contact.Normal;
-		// Calculate the impulse magnitude using the relative velocity and contact normal
-		scalar_t impulse = glm::dot<3, scalar_t>(rVelocity, contactNormal);
-		// If the impulse is non-negative, objects are separating, so skip
-		if (impulse >= 0) continue;
-		// Calculate angular effect due to inertia for both objects
-		glm::vec<3, scalar_t> aInertiaTensor = aBody ? glm::cross<scalar_t>(aBody.GetIntertiaTensor() * glm::cross<scalar_t>(rA, contactNormal), rA) : glm::vec<3, scalar_t>(0.0);
-		glm::vec<3, scalar_t> bInertiaTensor = bBody ? glm::cross<scalar_t>(bBody.GetIntertiaTensor() * glm::cross<scalar_t>(rB, contactNormal), rB) : glm::vec<3, scalar_t>(0.0);
+		scalar_t normalVelocity = glm::dot<3, scalar_t>(rVelocity, contactNormal);
 		// Calculate the angular effect on the impulse
-		scalar_t angularEffect = glm::dot<3, scalar_t>(aInertiaTensor + bInertiaTensor, contactNormal);
-		// Calculate impulse without and with angular effect
-		scalar_t j  = (-(scalar_t(1.0) + cRestitution) * impulse) / (totalMass + angularEffect);
-		j /= contactsCount;
-		// Calculate linear and angular impulses
-		glm::vec<3, scalar_t> velocity = contactNormal * j;
-		// Apply impulses to objects
-		if (aBody)
-		{
-			aVel	-= velocity;//* aInvMass;
-			aAngVel -= (aBody.GetIntertiaTensor() * glm::cross<scalar_t>(rA, velocity));
-		}
-		if (bBody)
-		{
-			bVel	+= velocity; // * bInvMass;
-			bAngVel += (bBody.GetIntertiaTensor() * glm::cross<scalar_t>(rB, velocity));
-		}
-		
+		scalar_t angularEffect = glm::dot<3, scalar_t>(
+			glm::cross<scalar_t>(aInertia * glm::cross<scalar_t>(rA, contactNormal), rA) +
+			glm::cross<scalar_t>(bInertia * glm::cross<scalar_t>(rB, contactNormal), rB), contactNormal);
+
+		if (totalMass + angularEffect <= 0.0) continue;
+
+		// Accumulated impulse can only push, so only the change is applied
+		scalar_t j = -(normalVelocity - point.VelocityBias) / (totalMass + angularEffect);
+		const scalar_t accumulated = point.NormalImpulse;
+		point.NormalImpulse = glm::max<scalar_t>(accumulated + j, 0.0);
+		j = point.NormalImpulse - accumulated;
+
+		glm::vec<3, scalar_t> impulse = contactNormal * j;
+		aVel -= impulse * aInvMass; aAngVel -= aInertia * glm::cross<scalar_t>(rA, impulse);
+		bVel += impulse * bInvMass; bAngVel += bInertia * glm::cross<scalar_t>(rB, impulse);
+
 		//Calculate the tangent component of the relative velocity
  		rVelocity = (bVel + glm::cross<scalar_t>(bAngVel, rB)) - (aVel + glm::cross<scalar_t>(aAngVel, rA));
 		glm::vec<3, scalar_t> fTangent = rVelocity - contactNormal * glm::dot(rVelocity, contactNormal);
@@ -211,27 +459,24 @@ void shade::physic::PhysicsManager::ImpulseSolver(const StackArray<CollisionShap
 			fTangent /= length;
 			// Calculate friction mass
 			scalar_t frictionMass = totalMass + glm::dot(fTangent,
-					glm::cross(aBody.GetIntertiaTensor() * glm::cross(rA, fTangent), rA) +
-					glm::cross(bBody.GetIntertiaTensor() * glm::cross(rB, fTangent), rB)
+					glm::cross(aInertia * glm::cross(rA, fTangent), rA) +
+					glm::cross(bInertia * glm::cross(rB, fTangent), rB)
 				);
 
-			// Apply friction impulse if mass is greater than 0
 			if (frictionMass > 0.0)
 			{
-				scalar_t jt = -glm::dot<3, scalar_t>(rVelocity, fTangent) * cFriction;
-
-				jt /= frictionMass;
-
-				if (aBody)
-				{
-					aVel	-= fTangent * jt;
-					aAngVel -= (aBody.GetIntertiaTensor() * glm::cross<scalar_t>(rA, fTangent * jt)) / contactsCount;
-				}
-				if (bBody) 
-				{
-					bVel	+= fTangent * jt;
-					bAngVel += (bBody.GetIntertiaTensor() * glm::cross<scalar_t>(rB, fTangent * jt)) / contactsCount;
-				}
+				// Friction impulse is kept inside Coulomb cone of accumulated normal impulse
+				const glm::vec<3, scalar_t> accumulatedTangent = point.TangentImpulse;
+				point.TangentImpulse += fTangent * (-length / frictionMass);
+
+				const scalar_t maxFriction = cFriction * point.NormalImpulse;
+				const scalar_t tangentLength = glm::length<3, scalar_t>(point.TangentImpulse);
+				if (tangentLength > maxFriction)
+					point.TangentImpulse *= maxFriction / tangentLength;
+
+				glm::vec<3, scalar_t> friction = point.TangentImpulse - accumulatedTangent;
+				aVel -= friction * aInvMass; aAngVel -= aInertia * glm::cross<scalar_t>(rA, friction);
+				bVel += friction * bInvMass; bAngVel += bInertia * glm::cross<scalar_t>(rB, friction);
 			}
 		}
 	}
@@ -240,113 +485,100 @@ void shade::physic::PhysicsManager::ImpulseSolver(const StackArray<CollisionShap
 	if (bBody) { bBody.LinearVelocity = bVel; bBody.AngularVelocity = bAngVel; }
 }
 
-void shade::physic::PhysicsManager::CashedContactData::IntegrateContact(const CollisionShape::Manifold& manifold, const RigidBody& bodyA, const RigidBody& bodyB)
+shade::physic::PhysicsManager::CashedContactData::ContactManifold& shade::physic::PhysicsManager::CashedContactData::IntegrateContact(const PairKey& key, const CollisionShape::Manifold& manifold, const glm::mat<4, 4, scalar_t>& transformA, const glm::mat<4, 4, scalar_t>& transformB, std::size_t step)
 {
-	std::size_t hash = reinterpret_cast<std::size_t>(&bodyA);
-	glm::detail::hash_combine(hash, reinterpret_cast<std::size_t>(&bodyB));
+	ContactManifold& contacts = m_Pairs[key];
 
-	bool same = false;
-	for (auto& point : m_Pairs[hash].Contancts)
-	{
-		if (point == manifold)
-		{
-			same = true;
-		}
-	}
-    if (!same)
+	Refresh(contacts, transformA, transformB);
+	AddPoint(contacts, manifold);
+	contacts.Step = step;
+
+	return contacts;
+}
+
+void shade::physic::PhysicsManager::CashedContactData::Refresh(ContactManifold& contacts, const glm::mat<4, 4, scalar_t>& transformA, const glm::mat<4, 4, scalar_t>& transformB)
+{
+	std::size_t count = 0u;
+	for (ContactPoint& point : contacts)
 	{
-		m_Pairs[hash].Contancts.PushFront(manifold);
+		CollisionShape::Manifold& manifold = point.Manifold;
+		// Move cached points with bodies
+		manifold.ContactPointA_W = glm::vec<3, scalar_t>(transformA * glm::vec<4, scalar_t>(manifold.ContactPointA_L, 1.0));
+		manifold.ContactPointB_W = glm::vec<3, scalar_t>(transformB * glm::vec<4, scalar_t>(manifold.ContactPointB_L, 1.0));
+
+		const glm::vec<3, scalar_t> difference = manifold.ContactPointA_W - manifold.ContactPointB_W;
+		manifold.CollisionDepth = glm::dot(difference, manifold.Normal);
+
+		const glm::vec<3, scalar_t> drift = difference - manifold.Normal * manifold.CollisionDepth;
+		// Keep point only while it's still touching and didn't slide away
+		if (manifold.CollisionDepth > -BreakingThreshold && glm::dot(drift, drift) < BreakingThreshold * BreakingThreshold)
+			contacts.Points[count++] = point;
 	}
+	contacts.PointsCount = count;
 }
 
-shade::StackArray<shade::physic::CollisionShape::Manifold, 4u> shade::physic::PhysicsManager::CashedContactData::GetReducedContacts(const RigidBody& bodyA, const RigidBody& bodyB)
+void shade::physic::PhysicsManager::CashedContactData::AddPoint(ContactManifold& contacts, const CollisionShape::Manifold& manifold)
 {
-	std::size_t hash = reinterpret_cast<std::size_t>(&bodyA);
-	glm::detail::hash_combine(hash, reinterpret_cast<std::size_t>(&bodyB));
-
-	StackArray<CollisionShape::Manifold, 4u> reduced;
-
-	auto contacts = m_Pairs.find(hash);
-	if (contacts != m_Pairs.end())
+	// Same feature keeps its accumulated impulses
+	for (ContactPoint& point : contacts)
 	{
-		CollisionPairArray::iterator A = contacts->second.Contancts.begin();
-
-		for (CollisionPairArray::iterator current = contacts->second.Contancts.begin()++; current != contacts->second.Contancts.end(); current++)
-		{
-			if (current->CollisionDepth > A->CollisionDepth && current->HasCollision)
-				A = current;
-		}
-
-		reduced.PushFront(*A);
-
-		CollisionPairArray::iterator B = contacts->second.Contancts.end(); scalar_t A_To_B_Distance = 0.0;
-		for (CollisionPairArray::iterator current = contacts->second.Contancts.begin(); current != contacts->second.Contancts.end(); current++)
+		if (glm::distance<3, scalar_t>(point.Manifold.ContactPointA_L, manifold.ContactPointA_L) < MatchingThreshold)
 		{
-			if (current->HasCollision && current != A)
-			{
-				scalar_t distance = glm::distance<3, scalar_t>(A->ContactPointA_L, current->ContactPointA_L);
-
-				if (distance > A_To_B_Distance)
-				{
-					A_To_B_Distance = distance; B = current;
-				}
-			}
+			point.Manifold = manifold;
+			return;
 		}
+	}
 
-		CollisionPairArray::iterator C = contacts->second.Contancts.end(); scalar_t maxArea = 0.0;
-		if (B != contacts->second.Contancts.end())
-		{
-			reduced.PushFront(*B);
-
-			for (CollisionPairArray::iterator current = contacts->second.Contancts.begin(); current != contacts->second.Contancts.end(); current++)
-			{
-				if (current->HasCollision && current != A && current != B && current != C)
-				{
-					glm::vec<3, scalar_t> C_A = current->ContactPointA_L * A->ContactPointA_L;
-					glm::vec<3, scalar_t> C_B = current->ContactPointA_L * B->ContactPointA_L;
+	if (contacts.PointsCount < MaxPointsCount)
+	{
+		contacts.Points[contacts.PointsCount++] = ContactPoint{ .Manifold = manifold };
+		return;
+	}
 
-					scalar_t area = 0.5 * glm::dot(glm::cross<scalar_t>(C_A, C_B), A->Normal);
+	// Manifold is full, keep the deepest point and replace the one which keeps the largest area
+	std::array<glm::vec<3, scalar_t>, MaxPointsCount + 1> points;
+	std::size_t deepest = MaxPointsCount; scalar_t maxDepth = manifold.CollisionDepth;
+	for (std::size_t i = 0; i < MaxPointsCount; ++i)
+	{
+		points[i] = contacts.Points[i].Manifold.ContactPointA_L;
+		if (contacts.Points[i].Manifold.CollisionDepth > maxDepth) { maxDepth = contacts.Points[i].Manifold.CollisionDepth; deepest = i; }
+	}
+	points[MaxPointsCount] = manifold.ContactPointA_L;
 
-					if (area > maxArea)
-					{
-						maxArea = area; C = current;
-					}
-				}
-			}
-		}
+	std::size_t replace = MaxPointsCount; scalar_t maxArea = -1.0;
+	for (std::size_t i = 0; i < MaxPointsCount; ++i)
+	{
+		if (i == deepest) continue;
 
-		if (C != contacts->second.Contancts.end())
-		{
-			reduced.PushFront(*C);
+		std::array<glm::vec<3, scalar_t>, MaxPointsCount> rest; std::size_t count = 0u;
+		for (std::size_t k = 0; k < points.size(); ++k)
+			if (k != i) rest[count++] = points[k];
 
-			CollisionPairArray::iterator D = contacts->second.Contancts.end(); maxArea = 0.0;
-			for (CollisionPairArray::iterator current = contacts->second.Contancts.begin(); current != contacts->second.Contancts.end(); current++)
-			{
-				if (current->HasCollision && current != A && current != B && current != C && current != D)
-				{
-					glm::vec<3, scalar_t> D_C = current->ContactPointA_L * C->ContactPointA_W;
-					glm::vec<3, scalar_t> D_A = current->ContactPointA_L * A->ContactPointA_L;
+		auto squaredArea = [](const glm::vec<3, scalar_t>& a, const glm::vec<3, scalar_t>& b) { const glm::vec<3, scalar_t> c = glm::cross(a, b); return glm::dot(c, c); };
+		const scalar_t area = glm::max(glm::max(
+			squaredArea(rest[0] - rest[1], rest[2] - rest[3]),
+			squaredArea(rest[0] - rest[2], rest[1] - rest[3])),
+			squaredArea(rest[0] - rest[3], rest[1] - rest[2]));
 
-					scalar_t area = 0.5 * glm::dot(glm::cross<scalar_t>(D_C, D_A), A->Normal);
+		if (area > maxArea) { maxArea = area; replace = i; }
+	}
 
-					if (area > maxArea)
-					{
-						maxArea = area; D = current;
-					}
-				}
-			}
+	if (replace != MaxPointsCount)
+		contacts.Points[replace] = ContactPoint{ .Manifold = manifold };
+}
 
-			if (D != contacts->second.Contancts.end())
-				reduced.PushFront(*D);
-		}
+void shade::physic::PhysicsManager::CashedContactData::RemoveStale(std::size_t step)
+{
+	for (auto pair = m_Pairs.begin(); pair != m_Pairs.end();)
+	{
+		if (pair->second.Step != step)
+			pair = m_Pairs.erase(pair);
+		else
+			pair++;
 	}
-
-	return std::move(reduced);
 }
 
 void shade::physic::PhysicsManager::CashedContactData::Clear()
 {
 	m_Pairs.clear();
 }
-
-
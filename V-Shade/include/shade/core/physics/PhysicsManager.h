@@ -4,6 +4,7 @@
 #include <shade/core/scene/Scene.h>
 #include <shade/core/physics/Common.h>
 #include <shade/core/physics/algo/ConvexHullGenerator.h>
+#include <shade/core/physics/broadphase/BroadPhase.h>
 
 namespace shade
 {
@@ -12,26 +13,65 @@ namespace shade
 		class SHADE_API PhysicsManager
 		{
 		private:
+			/* Contact manifolds which persist between steps while pair keeps touching */
 			class CashedContactData
 			{
 			public:
-				using CollisionPairArray = StackArray<CollisionShape::Manifold, 64U>;
-				struct CollisionPair
+				static constexpr std::size_t MaxPointsCount = 4u;
+				/* Points closer than this in local space are treated as the same feature */
+				static constexpr scalar_t MatchingThreshold = 0.02;
+				/* Points drifted apart more than this are dropped on refresh */
+				static constexpr scalar_t BreakingThreshold = 0.02;
+
+				struct ContactPoint
+				{
+					CollisionShape::Manifold Manifold;
+					/* Accumulated impulses, reused on next step to warm start solver */
+					scalar_t NormalImpulse = 0.0;
+					glm::vec<3, scalar_t> TangentImpulse = glm::vec<3, scalar_t>(0.0);
+					/* Restitution target computed before warm start */
+					scalar_t VelocityBias = 0.0;
+				};
+				struct ContactManifold
+				{
+					std::array<ContactPoint, MaxPointsCount> Points;
+					std::size_t PointsCount = 0u;
+					/* Last step when pair was in contact */
+					std::size_t Step = 0u;
+
+					ContactPoint* begin() { return Points.data(); }
+					ContactPoint* end() { return Points.data() + PointsCount; }
+					const ContactPoint* begin() const { return Points.data(); }
+					const ContactPoint* end() const { return Points.data() + PointsCount; }
+				};
+				struct PairKey
 				{
-					RigidBody* aBody;
-					RigidBody* bBody;
-					CollisionPairArray Contancts;
+					ecs::EntityID A, B;
+					bool operator==(const PairKey& other) const { return A == other.A && B == other.B; }
+				};
+				struct PairKeyHash
+				{
+					std::size_t operator()(const PairKey& key) const
+					{
+						std::size_t hash = std::hash<ecs::EntityID>()(key.A);
+						glm::detail::hash_combine(hash, std::hash<ecs::EntityID>()(key.B));
+						return hash;
+					}
 				};
 			public:
 				CashedContactData() = default;
 				~CashedContactData() = default;
 
-				void IntegrateContact(const CollisionShape::Manifold& manifold, const RigidBody& bodyA, const RigidBody& bodyB);
-				StackArray<CollisionShape::Manifold, 4u> GetReducedContacts(const RigidBody& bodyA, const RigidBody& bodyB);
-
+				/* Refresh cached points of pair with current transforms and merge new contact into them */
+				ContactManifold& IntegrateContact(const PairKey& key, const CollisionShape::Manifold& manifold, const glm::mat<4, 4, scalar_t>& transformA, const glm::mat<4, 4, scalar_t>& transformB, std::size_t step);
+				/* Remove pairs which weren't in contact on step */
+				void RemoveStale(std::size_t step);
 				void Clear();
 			
-				std::unordered_map<std::size_t, CollisionPair> m_Pairs;
+				std::unordered_map<PairKey, ContactManifold, PairKeyHash> m_Pairs;
+			private:
+				static void Refresh(ContactManifold& contacts, const glm::mat<4, 4, scalar_t>& transformA, const glm::mat<4, 4, scalar_t>& transformB);
+				static void AddPoint(ContactManifold& contacts, const CollisionShape::Manifold& manifold);
 			};
 		public:
 			PhysicsManager() = default;
@@ -42,18 +82,77 @@ namespace shade
 			static void Step(SharedPointer<Scene>& scene, const FrameTimer& deltaTime);
 			static void SetSimulationPlaying(bool isPlay);
 			static void SetIterationCount(std::size_t count);
+			/* Count of velocity iterations per island on each sub step */
+			static void SetVelocityIterationCount(std::size_t count);
+			static void SetBroadPhase(BroadPhase::Type type);
+			static BroadPhase::Type GetBroadPhaseType();
+			/* Statistic of last broad phase pass */
+			static const BroadPhase::Statistic& GetBroadPhaseStatistic();
+		private:
+			struct BroadPhaseBody
+			{
+				RigidBody* Body;
+				TransformComponent* Transform;
+				ecs::EntityID Entity;
+			};
+			struct BroadPhaseProxy
+			{
+				BroadPhase::ProxyID Proxy;
+				/* Last step when entity was seen, used to remove proxies of destroyed entities */
+				std::size_t Step;
+			};
+			struct NarrowPhaseContact
+			{
+				/* Index into broad phase pairs */
+				std::uint32_t Pair;
+				CollisionShape::Manifold Manifold;
+			};
+			struct SolverContact
+			{
+				/* Indices into bodies */
+				std::uint32_t A, B;
+				CashedContactData::ContactManifold* Contacts;
+			};
+			/* Dynamic bodies connected by contacts, islands share only static bodies so they are solved in parallel */
+			struct Island
+			{
+				std::vector<std::uint32_t> Bodies;
+				std::vector<std::uint32_t> Contacts;
+			};
+			/* Time body has to stay still before its island is allowed to sleep */
+			static constexpr scalar_t TimeToSleep = 1.0;
+			/* Pairs per narrow phase job, buffers are split by this value and not by threads count, so merge order is always the same */
+			static constexpr std::size_t NarrowPhaseGrainSize = 16u;
 		private:
 			static void Integrate(RigidBody& body, Transform& transform, scalar_t deltaTime, scalar_t deltaDT);
-			static void IntegrateContact(const CollisionShape::Manifold& contact, const RigidBody& bodyA, const RigidBody& bodyB);
-			static StackArray<CollisionShape::Manifold, 4u> GetStableContacts(const RigidBody& bodyA, const RigidBody& bodyB);
-			static void DetectCollisions(ecs::BasicView<ecs::EntityID, RigidBodyComponent, TransformComponent>& bodies, scalar_t deltaTime);
+			static void UpdateBroadPhase(ecs::BasicView<ecs::EntityID, RigidBodyComponent, TransformComponent>& bodies);
+			static AABB GetBoundingBox(const RigidBody& body);
+			static void DetectCollisions(scalar_t deltaTime);
+			static void NarrowPhase();
+			static void ResolveContacts(scalar_t deltaTime);
+			static void BuildIslands();
+			static void SolveIsland(Island& island, scalar_t deltaTime);
+			static std::uint32_t FindIsland(std::uint32_t body);
 			static void PositionSolver(const CollisionShape::Manifold& contact, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB, scalar_t deltaTime);
-			static void ImpulseSolver(const StackArray<CollisionShape::Manifold, 4>& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB, scalar_t deltaTime);
+			static void WarmStart(CashedContactData::ContactManifold& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB);
+			static void ImpulseSolver(CashedContactData::ContactManifold& contacts, const std::pair<RigidBody&, TransformComponent&>& bodyA, const std::pair<RigidBody&, TransformComponent&>& bodyB, scalar_t deltaTime);
 
 			static CashedContactData m_ContactsData;
 			static std::size_t m_IterationCount;
 			static scalar_t deltaDT;
 			static bool m_IsSimulating;
+
+			static SharedPointer<BroadPhase>								m_BroadPhase;
+			static std::unordered_map<ecs::EntityID, BroadPhaseProxy>		m_Proxies;
+			static std::vector<BroadPhaseBody>								m_Bodies;
+			static std::vector<BroadPhase::Pair>							m_Pairs;
+			static std::size_t												m_StepIndex;
+			static std::size_t												m_VelocityIterationCount;
+			static std::vector<SolverContact>								m_SolverContacts;
+			/* Union find parents of bodies */
+			static std::vector<std::uint32_t>								m_IslandParents;
+			static std::vector<Island>										m_Islands;
+			static std::vector<std::vector<NarrowPhaseContact>>				m_NarrowPhaseBuffers;
 		private:
 			
 
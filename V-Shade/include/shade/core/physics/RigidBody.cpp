@@ -101,28 +101,32 @@ bool shade::physic::RigidBody::OBB_X_OBB(const glm::mat<4, 4, physic::scalar_t>&
 
 void shade::physic::RigidBody::ApplayGravity(const glm::vec<3, physic::scalar_t>& gravity)
 {
-	// If body is dynamic.
-	if (*this) ApplyForce(gravity);
+	// If body is dynamic. Gravity doesn't wake sleeping body
+	if (*this) NetForce += gravity;
 }
 
 void shade::physic::RigidBody::ApplyForce(const glm::vec<3, physic::scalar_t>& force, const glm::vec<3, physic::scalar_t>& position)
 {
+	WakeUp();
 	NetForce += force;
 	ApplyTorque(glm::cross<physic::scalar_t>(position, force));
 }
 
 void shade::physic::RigidBody::ApplyTorque(const glm::vec<3, physic::scalar_t>& torque)
 {
+	WakeUp();
 	NetTorque += torque;
 }
 
 void shade::physic::RigidBody::ApplyLinearImpulse(const glm::vec<3, scalar_t>& impulse)
 {
+	WakeUp();
 	NetForce += impulse;
 }
 
 void shade::physic::RigidBody::ApplyAngularImpulse(const glm::vec<3, scalar_t>& impulse, const glm::vec<3, scalar_t>& position)
 {
+	WakeUp();
 	NetTorque += glm::cross<scalar_t>(position, impulse);
 }
 
@@ -131,6 +135,12 @@ void shade::physic::RigidBody::SetSleep(bool sleep)
 	m_IsSleep = sleep;
 }
 
+void shade::physic::RigidBody::WakeUp()
+{
+	m_IsSleep = false;
+	m_TimeToSleep = 0.0;
+}
+
 bool shade::physic::RigidBody::IsSleep() const
 {
 	return m_IsSleep;
@@ -330,6 +340,22 @@ void shade::physic::RigidBody::Integrate(Transform& transform, scalar_t deltaTim
 }
 
 
+void shade::physic::RigidBody::UpdateSleeping(const Transform& transform)
+{
+	const glm::mat4 model = transform.GetModelMatrix();
+	// Solver doesn't move sleeping bodies, so any change came from editor, script or transform edit
+	if (model != m_SleepTransform)
+	{
+		for (auto& ext : m_Extensions)
+		{
+			ext.UpdateCorners(model);
+		}
+
+		m_SleepTransform = model;
+		WakeUp();
+	}
+}
+
 void shade::physic::RigidBody::ClearForces()
 {
 	NetForce *= 0;
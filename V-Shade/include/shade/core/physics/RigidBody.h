@@ -41,6 +41,8 @@ namespace shade
 			void ApplyAngularImpulse(const glm::vec<3, scalar_t>& impulse, const glm::vec<3, scalar_t>& position);
 
 			void SetSleep(bool sleep);
+			/* Reset sleep timer, called when force or impulse is applied */
+			void WakeUp();
 			bool IsSleep() const;
 			void SetIntertiaTensor(const glm::vec<3, physic::scalar_t>& scale);
 			const glm::mat<3, 3, scalar_t>& GetIntertiaTensor() const;
@@ -85,6 +87,8 @@ namespace shade
 		private:
 			void Integrate(Transform& transform, scalar_t deltaTime, scalar_t deltaDT);
 			bool ShouldSleep(const Transform& transform, scalar_t deltaTime, scalar_t deltaDT);
+			/* Sleeping body isn't integrated, so extensions are refreshed here and body is woken when it was moved from outside */
+			void UpdateSleeping(const Transform& transform);
 			void UpdateIntertiaTensor(const glm::qua<scalar_t>& rotate);
 			void UpdateIntertiaTensor(const glm::vec<3, scalar_t>& rotate);
 		private:
@@ -95,6 +99,8 @@ namespace shade
 
 			scalar_t m_TimeToSleep = 0.0;
 			bool m_IsSleep = false;
+			// Transform which body had when it fell asleep
+			glm::mat4 m_SleepTransform = glm::mat4(1.f);
 			friend class PhysicsManager;
 		private:
 			friend class serialize::Serializer;
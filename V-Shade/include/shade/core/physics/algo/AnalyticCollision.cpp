@@ -0,0 +1,312 @@
+#include "shade_pch.h"
+#include "AnalyticCollision.h"
+
+namespace shade
+{
+	namespace physic
+	{
+		namespace algo
+		{
+			using vec3 = glm::vec<3, scalar_t>;
+
+			static constexpr scalar_t Epsilon = 1e-9;
+			/* Edge axis has to be noticeably better than face axis to be chosen, keeps contact stable on resting boxes */
+			static constexpr scalar_t EdgeAxisRelativeTolerance = 0.95;
+			static constexpr scalar_t EdgeAxisAbsoluteTolerance = 0.001;
+
+			static CollisionShape::Manifold MakeManifold(const vec3& normal, scalar_t depth, const vec3& pointA, const vec3& pointB)
+			{
+				CollisionShape::Manifold manifold;
+				manifold.HasCollision = true;
+				manifold.Normal = normal;
+				manifold.CollisionDepth = depth;
+				manifold.ContactPointA_W = pointA;
+				manifold.ContactPointB_W = pointB;
+				return manifold;
+			}
+
+			/* Vertex of box furthest along direction is the box center moved by half size along each axis, edge is this vertex with one axis free */
+			static Segment BoxSupportEdge(const ShapeFrame& frame, const vec3& halfSize, const vec3& direction, std::size_t axis)
+			{
+				vec3 center = frame.Position;
+				for (std::size_t i = 0; i < 3; ++i)
+				{
+					if (i != axis)
+						center += frame.Rotation[i] * ((glm::dot(frame.Rotation[i], direction) >= 0.0) ? halfSize[i] : -halfSize[i]);
+				}
+				const vec3 extent = frame.Rotation[axis] * halfSize[axis];
+				return { center - extent, center + extent };
+			}
+
+			/*
+				Vertex of incident box deepest under reference face which also lies within face bounds, plain support vertex
+				may hang outside of reference face when incident box rests on it with edge or face.
+			*/
+			static vec3 BoxIncidentVertex(const ShapeFrame& reference, const vec3& referenceHalfSize, std::size_t axis, const ShapeFrame& incident, const vec3& incidentHalfSize, const vec3& normal)
+			{
+				const scalar_t faceOffset = glm::dot(reference.Position, normal) + referenceHalfSize[axis];
+
+				vec3 result = BoxSupport(incident, incidentHalfSize, -normal);
+				scalar_t maxDepth = std::numeric_limits<scalar_t>::lowest();
+
+				for (std::size_t corner = 0; corner < 8; ++corner)
+				{
+					vec3 vertex = incident.Position;
+					for (std::size_t i = 0; i < 3; ++i)
+						vertex += incident.Rotation[i] * ((corner & (1u << i)) ? incidentHalfSize[i] : -incidentHalfSize[i]);
+
+					const scalar_t depth = faceOffset - glm::dot(vertex, normal);
+					if (depth < 0.0 || depth <= maxDepth) continue;
+
+					const vec3 local = glm::transpose(reference.Rotation) * (vertex - reference.Position);
+					bool isWithinFace = true;
+					for (std::size_t i = 0; i < 3; ++i)
+						isWithinFace &= (i == axis || glm::abs(local[i]) <= referenceHalfSize[i] + Epsilon);
+
+					if (isWithinFace) { maxDepth = depth; result = vertex; }
+				}
+
+				return result;
+			}
+		}
+	}
+}
+
+shade::physic::algo::ShapeFrame::ShapeFrame(const glm::mat<4, 4, scalar_t>& transform) :
+	Position(transform[3]),
+	Scale(glm::length(glm::vec<3, scalar_t>(transform[0])), glm::length(glm::vec<3, scalar_t>(transform[1])), glm::length(glm::vec<3, scalar_t>(transform[2])))
+{
+	for (glm::length_t i = 0; i < 3; ++i)
+		Rotation[i] = (Scale[i] > Epsilon) ? glm::vec<3, scalar_t>(transform[i]) / Scale[i] : glm::vec<3, scalar_t>(0.0);
+}
+
+shade::physic::scalar_t shade::physic::algo::ShapeFrame::GetMaxScale() const
+{
+	return glm::max(Scale.x, glm::max(Scale.y, Scale.z));
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::algo::ShapeFrame::ToLocal(const glm::vec<3, scalar_t>& point) const
+{
+	// Rotation is orthonormal, so its inverse is transpose
+	const glm::vec<3, scalar_t> rotated = glm::transpose(Rotation) * (point - Position);
+	return glm::vec<3, scalar_t>(
+		(Scale.x > Epsilon) ? rotated.x / Scale.x : 0.0,
+		(Scale.y > Epsilon) ? rotated.y / Scale.y : 0.0,
+		(Scale.z > Epsilon) ? rotated.z / Scale.z : 0.0);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::algo::BoxSupport(const ShapeFrame& frame, const glm::vec<3, scalar_t>& halfSize, const glm::vec<3, scalar_t>& direction)
+{
+	glm::vec<3, scalar_t> point = frame.Position;
+	for (glm::length_t i = 0; i < 3; ++i)
+		point += frame.Rotation[i] * ((glm::dot(frame.Rotation[i], direction) >= 0.0) ? halfSize[i] : -halfSize[i]);
+	return point;
+}
+
+shade::physic::algo::Segment shade::physic::algo::CapsuleSegment(const ShapeFrame& frame, scalar_t halfHeight)
+{
+	const glm::vec<3, scalar_t> extent = frame.Rotation[1] * (halfHeight * frame.Scale.y);
+	return { frame.Position - extent, frame.Position + extent };
+}
+
+shade::physic::scalar_t shade::physic::algo::CapsuleRadius(const ShapeFrame& frame, scalar_t radius)
+{
+	return radius * glm::max(frame.Scale.x, frame.Scale.z);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::algo::ClosestPointOnSegment(const Segment& segment, const glm::vec<3, scalar_t>& point)
+{
+	const glm::vec<3, scalar_t> ab = segment.B - segment.A;
+	const scalar_t lengthSquared = glm::dot(ab, ab);
+
+	if (lengthSquared <= Epsilon) return segment.A;
+
+	return segment.A + ab * glm::clamp(glm::dot(point - segment.A, ab) / lengthSquared, scalar_t(0.0), scalar_t(1.0));
+}
+
+std::pair<glm::vec<3, shade::physic::scalar_t>, glm::vec<3, shade::physic::scalar_t>> shade::physic::algo::ClosestPointsSegmentSegment(const Segment& first, const Segment& second)
+{
+	const glm::vec<3, scalar_t> d1 = first.B - first.A, d2 = second.B - second.A, r = first.A - second.A;
+	const scalar_t a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+
+	scalar_t s = 0.0, t = 0.0;
+
+	if (a <= Epsilon && e <= Epsilon)
+		return { first.A, second.A };
+
+	if (a <= Epsilon)
+	{
+		t = glm::clamp(f / e, scalar_t(0.0), scalar_t(1.0));
+	}
+	else
+	{
+		const scalar_t c = glm::dot(d1, r);
+		if (e <= Epsilon)
+		{
+			s = glm::clamp(-c / a, scalar_t(0.0), scalar_t(1.0));
+		}
+		else
+		{
+			const scalar_t b = glm::dot(d1, d2), denominator = a * e - b * b;
+			// Parallel segments give zero denominator, any point of first one will do
+			if (denominator > Epsilon)
+				s = glm::clamp((b * f - c * e) / denominator, scalar_t(0.0), scalar_t(1.0));
+
+			t = (b * s + f) / e;
+
+			if (t < 0.0)
+			{
+				t = 0.0; s = glm::clamp(-c / a, scalar_t(0.0), scalar_t(1.0));
+			}
+			else if (t > 1.0)
+			{
+				t = 1.0; s = glm::clamp((b - c) / a, scalar_t(0.0), scalar_t(1.0));
+			}
+		}
+	}
+
+	return { first.A + d1 * s, second.A + d2 * t };
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::algo::SphereSphere(const glm::vec<3, scalar_t>& centerA, scalar_t radiusA, const glm::vec<3, scalar_t>& centerB, scalar_t radiusB)
+{
+	const glm::vec<3, scalar_t> delta = centerB - centerA;
+	const scalar_t distanceSquared = glm::dot(delta, delta), radius = radiusA + radiusB;
+
+	if (distanceSquared > radius * radius)
+		return { false };
+
+	const scalar_t distance = glm::sqrt(distanceSquared);
+	// Concentric spheres have no preferred direction, push along world up
+	const glm::vec<3, scalar_t> normal = (distance > Epsilon) ? delta / distance : glm::vec<3, scalar_t>(0.0, 1.0, 0.0);
+
+	return MakeManifold(normal, radius - distance, centerA + normal * radiusA, centerB - normal * radiusB);
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::algo::SphereBox(const glm::vec<3, scalar_t>& center, scalar_t radius, const ShapeFrame& box, const glm::vec<3, scalar_t>& halfSize)
+{
+	const glm::vec<3, scalar_t> local = glm::transpose(box.Rotation) * (center - box.Position);
+	const glm::vec<3, scalar_t> closest = glm::clamp(local, -halfSize, halfSize);
+	const glm::vec<3, scalar_t> delta = local - closest;
+	const scalar_t distanceSquared = glm::dot(delta, delta);
+
+	if (distanceSquared > radius * radius)
+		return { false };
+
+	if (distanceSquared > Epsilon)
+	{
+		const scalar_t distance = glm::sqrt(distanceSquared);
+		const glm::vec<3, scalar_t> normal = box.Rotation * (-delta / distance);
+
+		return MakeManifold(normal, radius - distance, center + normal * radius, box.Position + box.Rotation * closest);
+	}
+
+	// Center is inside of box, push it out through the nearest face
+	glm::length_t axis = 0;
+	scalar_t minDistance = halfSize[0] - glm::abs(local[0]);
+	for (glm::length_t i = 1; i < 3; ++i)
+	{
+		const scalar_t distance = halfSize[i] - glm::abs(local[i]);
+		if (distance < minDistance) { minDistance = distance; axis = i; }
+	}
+
+	const scalar_t sign = (local[axis] >= 0.0) ? 1.0 : -1.0;
+	const glm::vec<3, scalar_t> normal = box.Rotation[axis] * -sign;
+
+	glm::vec<3, scalar_t> facePoint = local; facePoint[axis] = halfSize[axis] * sign;
+
+	return MakeManifold(normal, minDistance + radius, center + normal * radius, box.Position + box.Rotation * facePoint);
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::algo::SphereCapsule(const glm::vec<3, scalar_t>& center, scalar_t radius, const Segment& capsule, scalar_t capsuleRadius)
+{
+	return SphereSphere(center, radius, ClosestPointOnSegment(capsule, center), capsuleRadius);
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::algo::CapsuleCapsule(const Segment& capsuleA, scalar_t radiusA, const Segment& capsuleB, scalar_t radiusB)
+{
+	const auto [pointA, pointB] = ClosestPointsSegmentSegment(capsuleA, capsuleB);
+	return SphereSphere(pointA, radiusA, pointB, radiusB);
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::algo::BoxBox(const ShapeFrame& boxA, const glm::vec<3, scalar_t>& halfSizeA, const ShapeFrame& boxB, const glm::vec<3, scalar_t>& halfSizeB)
+{
+	const glm::vec<3, scalar_t> t = boxB.Position - boxA.Position;
+
+	// Penetration of boxes projected on axis, negative when axis separates them
+	auto penetration = [&](const glm::vec<3, scalar_t>& axis)
+	{
+		scalar_t radiusA = 0.0, radiusB = 0.0;
+		for (glm::length_t i = 0; i < 3; ++i)
+		{
+			radiusA += halfSizeA[i] * glm::abs(glm::dot(boxA.Rotation[i], axis));
+			radiusB += halfSizeB[i] * glm::abs(glm::dot(boxB.Rotation[i], axis));
+		}
+		return radiusA + radiusB - glm::abs(glm::dot(t, axis));
+	};
+
+	enum class Feature { FaceA, FaceB, Edge } feature = Feature::FaceA;
+	glm::vec<3, scalar_t> bestAxis(0.0);
+	scalar_t bestDepth = std::numeric_limits<scalar_t>::max();
+	glm::length_t faceAxis = 0, edgeA = 0, edgeB = 0;
+
+	for (glm::length_t i = 0; i < 3; ++i)
+	{
+		const scalar_t depth = penetration(boxA.Rotation[i]);
+		if (depth < 0.0) return { false };
+		if (depth < bestDepth) { bestDepth = depth; bestAxis = boxA.Rotation[i]; feature = Feature::FaceA; faceAxis = i; }
+	}
+	for (glm::length_t i = 0; i < 3; ++i)
+	{
+		const scalar_t depth = penetration(boxB.Rotation[i]);
+		if (depth < 0.0) return { false };
+		if (depth < bestDepth) { bestDepth = depth; bestAxis = boxB.Rotation[i]; feature = Feature::FaceB; faceAxis = i; }
+	}
+
+	const scalar_t faceDepth = bestDepth;
+	for (glm::length_t i = 0; i < 3; ++i)
+	{
+		for (glm::length_t j = 0; j < 3; ++j)
+		{
+			glm::vec<3, scalar_t> axis = glm::cross(boxA.Rotation[i], boxB.Rotation[j]);
+			const scalar_t length = glm::length(axis);
+			// Parallel edges are already covered by face axes
+			if (length <= 1e-6) continue;
+
+			axis /= length;
+			const scalar_t depth = penetration(axis);
+			if (depth < 0.0) return { false };
+			if (depth < bestDepth && depth < faceDepth * EdgeAxisRelativeTolerance - EdgeAxisAbsoluteTolerance)
+			{
+				bestDepth = depth; bestAxis = axis; feature = Feature::Edge; edgeA = i; edgeB = j;
+			}
+		}
+	}
+
+	const glm::vec<3, scalar_t> normal = (glm::dot(bestAxis, t) < 0.0) ? -bestAxis : bestAxis;
+
+	switch (feature)
+	{
+	case Feature::FaceA:
+	{
+		const glm::vec<3, scalar_t> pointB = BoxIncidentVertex(boxA, halfSizeA, faceAxis, boxB, halfSizeB, normal);
+		return MakeManifold(normal, bestDepth, pointB + normal * bestDepth, pointB);
+	}
+	case Feature::FaceB:
+	{
+		const glm::vec<3, scalar_t> pointA = BoxIncidentVertex(boxB, halfSizeB, faceAxis, boxA, halfSizeA, -normal);
+		return MakeManifold(normal, bestDepth, pointA, pointA - normal * bestDepth);
+	}
+	default:
+	{
+		const auto [pointA, pointB] = ClosestPointsSegmentSegment(BoxSupportEdge(boxA, halfSizeA, normal, edgeA), BoxSupportEdge(boxB, halfSizeB, -normal, edgeB));
+		return MakeManifold(normal, bestDepth, pointA, pointB);
+	}
+	}
+}
+
+void shade::physic::algo::SetLocalContactPoints(CollisionShape::Manifold& manifold, const ShapeFrame& frameA, const ShapeFrame& frameB)
+{
+	manifold.ContactPointA_L = frameA.ToLocal(manifold.ContactPointA_W);
+	manifold.ContactPointB_L = frameB.ToLocal(manifold.ContactPointB_W);
+}
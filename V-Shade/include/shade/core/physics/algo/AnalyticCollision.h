@@ -0,0 +1,55 @@
+#pragma once
+#include <shade/core/physics/shapes/CollisionShape.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		namespace algo
+		{
+			/* Transform of collider split into position, pure rotation and per axis scale */
+			struct SHADE_API ShapeFrame
+			{
+				ShapeFrame(const glm::mat<4, 4, scalar_t>& transform);
+
+				glm::vec<3, scalar_t> Position;
+				glm::mat<3, 3, scalar_t> Rotation;
+				glm::vec<3, scalar_t> Scale;
+
+				scalar_t GetMaxScale() const;
+				/* World point to local space of transform, without general matrix inverse */
+				glm::vec<3, scalar_t> ToLocal(const glm::vec<3, scalar_t>& point) const;
+			};
+
+			struct Segment
+			{
+				glm::vec<3, scalar_t> A, B;
+			};
+
+			/* Support point of box with already scaled half size */
+			SHADE_API glm::vec<3, scalar_t> BoxSupport(const ShapeFrame& frame, const glm::vec<3, scalar_t>& halfSize, const glm::vec<3, scalar_t>& direction);
+			/* Inner segment of capsule aligned with local Y axis, in world space */
+			SHADE_API Segment CapsuleSegment(const ShapeFrame& frame, scalar_t halfHeight);
+			/* Radius of capsule scaled by the largest of its cross section axes */
+			SHADE_API scalar_t CapsuleRadius(const ShapeFrame& frame, scalar_t radius);
+
+			SHADE_API glm::vec<3, scalar_t> ClosestPointOnSegment(const Segment& segment, const glm::vec<3, scalar_t>& point);
+			/* Closest points between two segments, returns pair of points on first and second one */
+			SHADE_API std::pair<glm::vec<3, scalar_t>, glm::vec<3, scalar_t>> ClosestPointsSegmentSegment(const Segment& first, const Segment& second);
+
+			/*
+				Closed form tests, all parameters are in world space and already scaled.
+				Returned manifold follows GJK/EPA convention: normal points from A to B, local points are left empty.
+			*/
+			SHADE_API CollisionShape::Manifold SphereSphere(const glm::vec<3, scalar_t>& centerA, scalar_t radiusA, const glm::vec<3, scalar_t>& centerB, scalar_t radiusB);
+			SHADE_API CollisionShape::Manifold SphereBox(const glm::vec<3, scalar_t>& center, scalar_t radius, const ShapeFrame& box, const glm::vec<3, scalar_t>& halfSize);
+			SHADE_API CollisionShape::Manifold SphereCapsule(const glm::vec<3, scalar_t>& center, scalar_t radius, const Segment& capsule, scalar_t capsuleRadius);
+			SHADE_API CollisionShape::Manifold CapsuleCapsule(const Segment& capsuleA, scalar_t radiusA, const Segment& capsuleB, scalar_t radiusB);
+			/* Separating axis test over 3 + 3 face axes and 9 edge axes */
+			SHADE_API CollisionShape::Manifold BoxBox(const ShapeFrame& boxA, const glm::vec<3, scalar_t>& halfSizeA, const ShapeFrame& boxB, const glm::vec<3, scalar_t>& halfSizeB);
+
+			/* Fill local contact points from world ones */
+			SHADE_API void SetLocalContactPoints(CollisionShape::Manifold& manifold, const ShapeFrame& frameA, const ShapeFrame& frameB);
+		}
+	}
+}
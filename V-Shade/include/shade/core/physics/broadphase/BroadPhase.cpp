@@ -0,0 +1,39 @@
+#include "shade_pch.h"
+#include "BroadPhase.h"
+#include <shade/core/physics/broadphase/SweepAndPrune.h>
+#include <shade/core/physics/broadphase/DynamicAABBTree.h>
+
+shade::SharedPointer<shade::physic::BroadPhase> shade::physic::BroadPhase::Create(Type type)
+{
+	switch (type)
+	{
+	case Type::SweepAndPrune:	return SharedPointer<SweepAndPrune>::Create();
+	case Type::DynamicAABBTree: return SharedPointer<DynamicAABBTree>::Create();
+	default:
+		return nullptr;
+	}
+}
+
+void shade::physic::BroadPhase::FindPairs(std::vector<Pair>& pairs)
+{
+	pairs.clear();
+	m_Statistic.PairsTested = 0u;
+
+	CollectPairs(pairs);
+
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	m_Statistic.PairsFound = pairs.size();
+}
+
+std::string shade::physic::BroadPhase::GetTypeAsString(Type type)
+{
+	switch (type)
+	{
+	case Type::SweepAndPrune:	return "Sweep and prune";
+	case Type::DynamicAABBTree:	return "Dynamic AABB tree";
+	default:
+		return "Undefined";
+	}
+}
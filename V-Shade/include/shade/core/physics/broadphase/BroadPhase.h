@@ -0,0 +1,88 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/physics/Common.h>
+#include <shade/core/memory/Memory.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Axis aligned bounding box in world space */
+		struct AABB
+		{
+			glm::vec<3, scalar_t> Min = glm::vec<3, scalar_t>(0.0);
+			glm::vec<3, scalar_t> Max = glm::vec<3, scalar_t>(0.0);
+
+			SHADE_INLINE bool Overlaps(const AABB& other) const
+			{
+				return (Min.x <= other.Max.x && Max.x >= other.Min.x &&
+						Min.y <= other.Max.y && Max.y >= other.Min.y &&
+						Min.z <= other.Max.z && Max.z >= other.Min.z);
+			}
+			SHADE_INLINE bool Contains(const AABB& other) const
+			{
+				return (Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z &&
+						Max.x >= other.Max.x && Max.y >= other.Max.y && Max.z >= other.Max.z);
+			}
+			SHADE_INLINE AABB Union(const AABB& other) const { return { glm::min(Min, other.Min), glm::max(Max, other.Max) }; }
+			SHADE_INLINE AABB Fattened(scalar_t margin) const { return { Min - glm::vec<3, scalar_t>(margin), Max + glm::vec<3, scalar_t>(margin) }; }
+			SHADE_INLINE glm::vec<3, scalar_t> GetCenter() const { return (Min + Max) * scalar_t(0.5); }
+			SHADE_INLINE scalar_t GetSurfaceArea() const
+			{
+				const glm::vec<3, scalar_t> size = Max - Min;
+				return scalar_t(2.0) * (size.x * size.y + size.y * size.z + size.z * size.x);
+			}
+		};
+
+		/* Broad phase interface, keeps proxies of bodies bounds and reports pairs which bounds overlap */
+		class SHADE_API BroadPhase
+		{
+		public:
+			enum class Type : std::uint32_t
+			{
+				SweepAndPrune = 0,
+				DynamicAABBTree,
+
+				TYPE_MAX_ENUM
+			};
+			using ProxyID = std::uint32_t;
+			static constexpr ProxyID NULL_PROXY = ~0u;
+			/* Pair of proxies user data, A is always lower than B */
+			struct Pair
+			{
+				std::uint32_t A, B;
+
+				bool operator<(const Pair& other) const { return (A != other.A) ? A < other.A : B < other.B; }
+				bool operator==(const Pair& other) const { return A == other.A && B == other.B; }
+			};
+			struct Statistic
+			{
+				std::size_t ProxiesCount = 0u;
+				/* Count of bounds tests done by last FindPairs */
+				std::size_t PairsTested = 0u;
+				std::size_t PairsFound = 0u;
+			};
+		public:
+			virtual ~BroadPhase() = default;
+			static SharedPointer<BroadPhase> Create(Type type);
+		public:
+			virtual ProxyID CreateProxy(const AABB& aabb, std::uint32_t userData) = 0;
+			virtual void DestroyProxy(ProxyID proxy) = 0;
+			virtual void UpdateProxy(ProxyID proxy, const AABB& aabb, std::uint32_t userData) = 0;
+			virtual Type GetType() const = 0;
+			/* Collect overlapping pairs, pairs are sorted so result doesn't depend on internal order */
+			void FindPairs(std::vector<Pair>& pairs);
+			const Statistic& GetStatistic() const { return m_Statistic; }
+
+			static std::string GetTypeAsString(Type type);
+		protected:
+			virtual void CollectPairs(std::vector<Pair>& pairs) = 0;
+			SHADE_INLINE void AddPair(std::vector<Pair>& pairs, std::uint32_t a, std::uint32_t b) const
+			{
+				pairs.emplace_back((a < b) ? Pair{ a, b } : Pair{ b, a });
+			}
+		protected:
+			Statistic m_Statistic;
+		};
+	}
+}
@@ -0,0 +1,65 @@
+#include "shade_pch.h"
+#include "BroadPhaseBenchmark.h"
+
+shade::physic::BroadPhaseBenchmark::Result shade::physic::BroadPhaseBenchmark::Run(BroadPhase::Type type, const Settings& settings)
+{
+	Result result{ .Type = type, .BruteForcePairs = settings.BodiesCount * (settings.BodiesCount - (settings.BodiesCount ? 1u : 0u)) / 2u };
+
+	SharedPointer<BroadPhase> broadPhase = BroadPhase::Create(type);
+	if (!broadPhase || !settings.StepsCount) return result;
+
+	std::mt19937 generator(settings.Seed);
+	std::uniform_real_distribution<scalar_t> position(scalar_t(0.0), settings.WorldSize);
+	std::uniform_real_distribution<scalar_t> velocity(-settings.MaxVelocity, settings.MaxVelocity);
+
+	struct Body
+	{
+		glm::vec<3, scalar_t> Position, Velocity;
+		BroadPhase::ProxyID Proxy;
+	};
+
+	const glm::vec<3, scalar_t> halfSize(settings.BodySize * scalar_t(0.5));
+	std::vector<Body> bodies(settings.BodiesCount);
+
+	for (std::size_t i = 0; i < bodies.size(); ++i)
+	{
+		bodies[i].Position = { position(generator), position(generator), position(generator) };
+		bodies[i].Velocity = { velocity(generator), velocity(generator), velocity(generator) };
+		bodies[i].Proxy	   = broadPhase->CreateProxy({ bodies[i].Position - halfSize, bodies[i].Position + halfSize }, static_cast<std::uint32_t>(i));
+	}
+
+	std::vector<BroadPhase::Pair> pairs;
+	std::size_t pairsTested = 0u, pairsFound = 0u;
+	std::chrono::duration<double, std::milli> elapsed(0.0);
+
+	for (std::size_t step = 0; step < settings.StepsCount; ++step)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			Body& body = bodies[i];
+			body.Position += body.Velocity;
+			// Bounce from world bounds so density stays the same
+			for (glm::length_t axis = 0; axis < 3; ++axis)
+			{
+				if (body.Position[axis] < scalar_t(0.0) || body.Position[axis] > settings.WorldSize)
+					body.Velocity[axis] = -body.Velocity[axis];
+			}
+
+			broadPhase->UpdateProxy(body.Proxy, { body.Position - halfSize, body.Position + halfSize }, static_cast<std::uint32_t>(i));
+		}
+
+		broadPhase->FindPairs(pairs);
+
+		elapsed += std::chrono::steady_clock::now() - start;
+		pairsTested += broadPhase->GetStatistic().PairsTested;
+		pairsFound	+= broadPhase->GetStatistic().PairsFound;
+	}
+
+	result.AveragePairsTested		= double(pairsTested) / double(settings.StepsCount);
+	result.AveragePairsFound		= double(pairsFound) / double(settings.StepsCount);
+	result.AverageStepMilliseconds	= elapsed.count() / double(settings.StepsCount);
+
+	return result;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <shade/core/physics/broadphase/BroadPhase.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Generates scene of randomly moving boxes and measures broad phase work per step */
+		class SHADE_API BroadPhaseBenchmark
+		{
+		public:
+			struct Settings
+			{
+				std::size_t BodiesCount = 2000u;
+				std::size_t StepsCount	= 100u;
+				scalar_t	WorldSize	= 100.0;
+				scalar_t	BodySize	= 1.0;
+				scalar_t	MaxVelocity = 0.1;
+				std::uint32_t Seed		= 0u;
+			};
+			struct Result
+			{
+				BroadPhase::Type Type;
+				/* Pairs tested by brute force n * (n - 1) / 2 for comparison */
+				std::size_t BruteForcePairs		= 0u;
+				double AveragePairsTested		= 0.0;
+				double AveragePairsFound		= 0.0;
+				double AverageStepMilliseconds	= 0.0;
+			};
+		public:
+			static Result Run(BroadPhase::Type type, const Settings& settings);
+			static Result Run(BroadPhase::Type type) { return Run(type, Settings()); }
+		};
+	}
+}
@@ -0,0 +1,271 @@
+#include "shade_pch.h"
+#include "DynamicAABBTree.h"
+
+shade::physic::DynamicAABBTree::DynamicAABBTree(scalar_t margin) :
+	m_Margin(margin)
+{
+}
+
+shade::physic::BroadPhase::ProxyID shade::physic::DynamicAABBTree::CreateProxy(const AABB& aabb, std::uint32_t userData)
+{
+	const ProxyID leaf = AllocateNode();
+
+	m_Nodes[leaf].Tight		= aabb;
+	m_Nodes[leaf].Box		= aabb.Fattened(m_Margin);
+	m_Nodes[leaf].UserData	= userData;
+	m_Nodes[leaf].Height	= 0;
+
+	InsertLeaf(leaf);
+	m_Leafs.emplace_back(leaf);
+	m_Statistic.ProxiesCount++;
+
+	return leaf;
+}
+
+void shade::physic::DynamicAABBTree::DestroyProxy(ProxyID proxy)
+{
+	assert(proxy < m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0 && "Invalid proxy !");
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	m_Leafs.erase(std::find(m_Leafs.begin(), m_Leafs.end(), proxy));
+	m_Statistic.ProxiesCount--;
+}
+
+void shade::physic::DynamicAABBTree::UpdateProxy(ProxyID proxy, const AABB& aabb, std::uint32_t userData)
+{
+	assert(proxy < m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0 && "Invalid proxy !");
+
+	Node& leaf = m_Nodes[proxy];
+	leaf.Tight = aabb; leaf.UserData = userData;
+
+	// Small movements stay inside fat box, so tree is untouched
+	if (leaf.Box.Contains(aabb))
+		return;
+
+	RemoveLeaf(proxy);
+	m_Nodes[proxy].Box = aabb.Fattened(m_Margin);
+	InsertLeaf(proxy);
+}
+
+void shade::physic::DynamicAABBTree::CollectPairs(std::vector<Pair>& pairs)
+{
+	if (m_Root == NULL_PROXY) return;
+
+	std::vector<ProxyID> stack; stack.reserve(64u);
+
+	for (const ProxyID leaf : m_Leafs)
+	{
+		const Node& current = m_Nodes[leaf];
+		stack.clear(); stack.emplace_back(m_Root);
+
+		while (!stack.empty())
+		{
+			const ProxyID index = stack.back(); stack.pop_back();
+			const Node& node = m_Nodes[index];
+
+			m_Statistic.PairsTested++;
+			if (!node.Box.Overlaps(current.Box))
+				continue;
+
+			if (node.IsLeaf())
+			{
+				// Every pair is visited from both sides, keep only one
+				if (index > leaf && node.Tight.Overlaps(current.Tight))
+					AddPair(pairs, current.UserData, node.UserData);
+			}
+			else
+			{
+				stack.emplace_back(node.Left); stack.emplace_back(node.Right);
+			}
+		}
+	}
+}
+
+shade::physic::BroadPhase::ProxyID shade::physic::DynamicAABBTree::AllocateNode()
+{
+	ProxyID node;
+	if (!m_FreeNodes.empty())
+	{
+		node = m_FreeNodes.back(); m_FreeNodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<ProxyID>(m_Nodes.size()); m_Nodes.emplace_back();
+	}
+
+	m_Nodes[node] = Node();
+	return node;
+}
+
+void shade::physic::DynamicAABBTree::FreeNode(ProxyID node)
+{
+	m_Nodes[node].Height = -1;
+	m_FreeNodes.emplace_back(node);
+}
+
+void shade::physic::DynamicAABBTree::InsertLeaf(ProxyID leaf)
+{
+	if (m_Root == NULL_PROXY)
+	{
+		m_Root = leaf; m_Nodes[leaf].Parent = NULL_PROXY;
+		return;
+	}
+
+	const AABB box = m_Nodes[leaf].Box;
+
+	// Descend by surface area heuristic
+	ProxyID sibling = m_Root;
+	while (!m_Nodes[sibling].IsLeaf())
+	{
+		const Node& node = m_Nodes[sibling];
+
+		const scalar_t area = node.Box.GetSurfaceArea();
+		const scalar_t combinedArea = node.Box.Union(box).GetSurfaceArea();
+		// Cost of creating new parent here and cost of pushing leaf down
+		const scalar_t cost = scalar_t(2.0) * combinedArea;
+		const scalar_t inheritanceCost = scalar_t(2.0) * (combinedArea - area);
+
+		auto descendCost = [&](ProxyID child)
+			{
+				const Node& childNode = m_Nodes[child];
+				const scalar_t unionArea = childNode.Box.Union(box).GetSurfaceArea();
+				return (childNode.IsLeaf() ? unionArea : unionArea - childNode.Box.GetSurfaceArea()) + inheritanceCost;
+			};
+
+		const scalar_t leftCost = descendCost(node.Left), rightCost = descendCost(node.Right);
+
+		if (cost < leftCost && cost < rightCost)
+			break;
+
+		sibling = (leftCost < rightCost) ? node.Left : node.Right;
+	}
+
+	const ProxyID oldParent = m_Nodes[sibling].Parent;
+	const ProxyID newParent = AllocateNode();
+
+	m_Nodes[newParent].Parent	= oldParent;
+	m_Nodes[newParent].Box		= box.Union(m_Nodes[sibling].Box);
+	m_Nodes[newParent].Height	= m_Nodes[sibling].Height + 1;
+	m_Nodes[newParent].Left		= sibling;
+	m_Nodes[newParent].Right	= leaf;
+	m_Nodes[sibling].Parent		= newParent;
+	m_Nodes[leaf].Parent		= newParent;
+
+	if (oldParent != NULL_PROXY)
+	{
+		if (m_Nodes[oldParent].Left == sibling)
+			m_Nodes[oldParent].Left = newParent;
+		else
+			m_Nodes[oldParent].Right = newParent;
+	}
+	else
+	{
+		m_Root = newParent;
+	}
+
+	Refit(m_Nodes[leaf].Parent);
+}
+
+void shade::physic::DynamicAABBTree::RemoveLeaf(ProxyID leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = NULL_PROXY;
+		return;
+	}
+
+	const ProxyID parent = m_Nodes[leaf].Parent;
+	const ProxyID grandParent = m_Nodes[parent].Parent;
+	const ProxyID sibling = (m_Nodes[parent].Left == leaf) ? m_Nodes[parent].Right : m_Nodes[parent].Left;
+
+	if (grandParent != NULL_PROXY)
+	{
+		if (m_Nodes[grandParent].Left == parent)
+			m_Nodes[grandParent].Left = sibling;
+		else
+			m_Nodes[grandParent].Right = sibling;
+
+		m_Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+	else
+	{
+		m_Root = sibling;
+		m_Nodes[sibling].Parent = NULL_PROXY;
+		FreeNode(parent);
+	}
+}
+
+void shade::physic::DynamicAABBTree::Refit(ProxyID node)
+{
+	while (node != NULL_PROXY)
+	{
+		node = Balance(node);
+
+		Node& current = m_Nodes[node];
+		const Node& left = m_Nodes[current.Left];
+		const Node& right = m_Nodes[current.Right];
+
+		current.Height = 1 + (std::max)(left.Height, right.Height);
+		current.Box = left.Box.Union(right.Box);
+
+		node = current.Parent;
+	}
+}
+
+shade::physic::BroadPhase::ProxyID shade::physic::DynamicAABBTree::Balance(ProxyID a)
+{
+	// Rotate higher grand child up when children heights differ by more than one
+	if (m_Nodes[a].IsLeaf() || m_Nodes[a].Height < 2)
+		return a;
+
+	const ProxyID b = m_Nodes[a].Left, c = m_Nodes[a].Right;
+	const std::int32_t balance = m_Nodes[c].Height - m_Nodes[b].Height;
+
+	auto rotate = [this, a](ProxyID up, ProxyID stay, bool isUpRight)
+		{
+			// Promote "up" to a place of "a", "a" becomes child of "up"
+			const ProxyID f = m_Nodes[up].Left, g = m_Nodes[up].Right;
+
+			m_Nodes[up].Left = a;
+			m_Nodes[up].Parent = m_Nodes[a].Parent;
+			m_Nodes[a].Parent = up;
+
+			if (m_Nodes[up].Parent != NULL_PROXY)
+			{
+				if (m_Nodes[m_Nodes[up].Parent].Left == a)
+					m_Nodes[m_Nodes[up].Parent].Left = up;
+				else
+					m_Nodes[m_Nodes[up].Parent].Right = up;
+			}
+			else
+			{
+				m_Root = up;
+			}
+
+			// Higher grand child stays under "up", lower one goes to "a"
+			const ProxyID keep = (m_Nodes[f].Height > m_Nodes[g].Height) ? f : g;
+			const ProxyID move = (keep == f) ? g : f;
+
+			m_Nodes[up].Right = keep;
+			if (isUpRight) m_Nodes[a].Right = move; else m_Nodes[a].Left = move;
+			m_Nodes[move].Parent = a;
+
+			m_Nodes[a].Box = m_Nodes[stay].Box.Union(m_Nodes[move].Box);
+			m_Nodes[a].Height = 1 + (std::max)(m_Nodes[stay].Height, m_Nodes[move].Height);
+			m_Nodes[up].Box = m_Nodes[a].Box.Union(m_Nodes[keep].Box);
+			m_Nodes[up].Height = 1 + (std::max)(m_Nodes[a].Height, m_Nodes[keep].Height);
+
+			return up;
+		};
+
+	if (balance > 1)
+		return rotate(c, b, true);
+	if (balance < -1)
+		return rotate(b, c, false);
+
+	return a;
+}
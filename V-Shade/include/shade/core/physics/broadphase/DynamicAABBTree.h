@@ -0,0 +1,87 @@
+#pragma once
+#include <shade/core/physics/broadphase/BroadPhase.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Bounding volume hierarchy of fattened boxes, leaf is reinserted only when its box leaves the fat one */
+		class SHADE_API DynamicAABBTree : public BroadPhase
+		{
+		public:
+			DynamicAABBTree(scalar_t margin = scalar_t(0.1));
+			virtual ~DynamicAABBTree() = default;
+		public:
+			virtual ProxyID CreateProxy(const AABB& aabb, std::uint32_t userData) override;
+			virtual void DestroyProxy(ProxyID proxy) override;
+			virtual void UpdateProxy(ProxyID proxy, const AABB& aabb, std::uint32_t userData) override;
+			virtual Type GetType() const override { return Type::DynamicAABBTree; }
+			/* Call function(userData) for every leaf which fat box overlaps aabb */
+			template<typename Function>
+			void Query(const AABB& aabb, Function function) const;
+			/* Call function(userData) for every leaf which fat box passes test(box), subtree is skipped when its box fails */
+			template<typename Test, typename Function>
+			void Traverse(Test test, Function function) const;
+			std::uint32_t GetHeight() const { return (m_Root != NULL_PROXY) ? m_Nodes[m_Root].Height : 0u; }
+		protected:
+			virtual void CollectPairs(std::vector<Pair>& pairs) override;
+		private:
+			struct Node
+			{
+				/* Fattened box for leafs and union of children for branches */
+				AABB Box;
+				/* Exact box of leaf */
+				AABB Tight;
+				ProxyID Parent = NULL_PROXY;
+				ProxyID Left = NULL_PROXY, Right = NULL_PROXY;
+				std::uint32_t UserData = 0u;
+				/* Leaf is 0, free node is -1 */
+				std::int32_t Height = -1;
+
+				SHADE_INLINE bool IsLeaf() const { return Left == NULL_PROXY; }
+			};
+			std::vector<Node>		m_Nodes;
+			std::vector<ProxyID>	m_FreeNodes;
+			std::vector<ProxyID>	m_Leafs;
+			ProxyID					m_Root = NULL_PROXY;
+			scalar_t				m_Margin;
+		private:
+			ProxyID AllocateNode();
+			void FreeNode(ProxyID node);
+			void InsertLeaf(ProxyID leaf);
+			void RemoveLeaf(ProxyID leaf);
+			ProxyID Balance(ProxyID node);
+			void Refit(ProxyID node);
+		};
+
+		template<typename Function>
+		inline void DynamicAABBTree::Query(const AABB& aabb, Function function) const
+		{
+			Traverse([&aabb](const AABB& box) { return box.Overlaps(aabb); }, function);
+		}
+
+		template<typename Test, typename Function>
+		inline void DynamicAABBTree::Traverse(Test test, Function function) const
+		{
+			if (m_Root == NULL_PROXY) return;
+
+			std::vector<ProxyID> stack; stack.reserve(64u); stack.emplace_back(m_Root);
+			while (!stack.empty())
+			{
+				const Node& node = m_Nodes[stack.back()]; stack.pop_back();
+
+				if (!test(node.Box))
+					continue;
+
+				if (node.IsLeaf())
+				{
+					function(node.UserData);
+				}
+				else
+				{
+					stack.emplace_back(node.Left); stack.emplace_back(node.Right);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#include "shade_pch.h"
+#include "SweepAndPrune.h"
+
+shade::physic::BroadPhase::ProxyID shade::physic::SweepAndPrune::CreateProxy(const AABB& aabb, std::uint32_t userData)
+{
+	ProxyID proxy;
+	if (!m_FreeProxies.empty())
+	{
+		proxy = m_FreeProxies.back(); m_FreeProxies.pop_back();
+	}
+	else
+	{
+		proxy = static_cast<ProxyID>(m_Proxies.size()); m_Proxies.emplace_back();
+	}
+
+	m_Proxies[proxy] = { aabb, userData, true };
+	// Will be moved into right place by next sort
+	m_Sorted.emplace_back(proxy);
+	m_Statistic.ProxiesCount++;
+
+	return proxy;
+}
+
+void shade::physic::SweepAndPrune::DestroyProxy(ProxyID proxy)
+{
+	assert(proxy < m_Proxies.size() && m_Proxies[proxy].IsAlive && "Invalid proxy !");
+
+	m_Proxies[proxy].IsAlive = false;
+	m_Sorted.erase(std::find(m_Sorted.begin(), m_Sorted.end(), proxy));
+	m_FreeProxies.emplace_back(proxy);
+	m_Statistic.ProxiesCount--;
+}
+
+void shade::physic::SweepAndPrune::UpdateProxy(ProxyID proxy, const AABB& aabb, std::uint32_t userData)
+{
+	assert(proxy < m_Proxies.size() && m_Proxies[proxy].IsAlive && "Invalid proxy !");
+
+	m_Proxies[proxy].Box = aabb;
+	m_Proxies[proxy].UserData = userData;
+}
+
+std::size_t shade::physic::SweepAndPrune::ChooseAxis() const
+{
+	if (m_Sorted.empty()) return m_Axis;
+
+	glm::vec<3, scalar_t> sum(0.0), sumSquared(0.0);
+	for (const ProxyID proxy : m_Sorted)
+	{
+		const glm::vec<3, scalar_t> center = m_Proxies[proxy].Box.GetCenter();
+		sum += center; sumSquared += center * center;
+	}
+
+	const glm::vec<3, scalar_t> variance = sumSquared - sum * sum / scalar_t(m_Sorted.size());
+	return (variance.x >= variance.y && variance.x >= variance.z) ? 0u : (variance.y >= variance.z) ? 1u : 2u;
+}
+
+void shade::physic::SweepAndPrune::CollectPairs(std::vector<Pair>& pairs)
+{
+	const std::size_t axis = ChooseAxis();
+	auto less = [this, axis](ProxyID left, ProxyID right) { return m_Proxies[left].Box.Min[axis] < m_Proxies[right].Box.Min[axis]; };
+
+	if (axis != m_Axis)
+	{
+		m_Axis = axis;
+		std::sort(m_Sorted.begin(), m_Sorted.end(), less);
+	}
+	else
+	{
+		// Bodies move a little between steps, so order is almost sorted
+		for (std::size_t i = 1; i < m_Sorted.size(); ++i)
+		{
+			const ProxyID proxy = m_Sorted[i];
+			std::size_t j = i;
+			for (; j > 0 && less(proxy, m_Sorted[j - 1]); --j)
+				m_Sorted[j] = m_Sorted[j - 1];
+			m_Sorted[j] = proxy;
+		}
+	}
+
+	for (std::size_t i = 0; i < m_Sorted.size(); ++i)
+	{
+		const Proxy& proxyA = m_Proxies[m_Sorted[i]];
+
+		for (std::size_t j = i + 1; j < m_Sorted.size(); ++j)
+		{
+			const Proxy& proxyB = m_Proxies[m_Sorted[j]];
+			// Rest of proxies start after current ends on sweep axis
+			if (proxyB.Box.Min[axis] > proxyA.Box.Max[axis])
+				break;
+
+			m_Statistic.PairsTested++;
+			if (proxyA.Box.Overlaps(proxyB.Box))
+				AddPair(pairs, proxyA.UserData, proxyB.UserData);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <shade/core/physics/broadphase/BroadPhase.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Sweep and prune along the axis with largest spread, sorted order is kept between steps so insertion sort stays close to linear */
+		class SHADE_API SweepAndPrune : public BroadPhase
+		{
+		public:
+			SweepAndPrune() = default;
+			virtual ~SweepAndPrune() = default;
+		public:
+			virtual ProxyID CreateProxy(const AABB& aabb, std::uint32_t userData) override;
+			virtual void DestroyProxy(ProxyID proxy) override;
+			virtual void UpdateProxy(ProxyID proxy, const AABB& aabb, std::uint32_t userData) override;
+			virtual Type GetType() const override { return Type::SweepAndPrune; }
+		protected:
+			virtual void CollectPairs(std::vector<Pair>& pairs) override;
+		private:
+			struct Proxy
+			{
+				AABB Box;
+				std::uint32_t UserData = 0u;
+				bool IsAlive = false;
+			};
+			std::vector<Proxy>		m_Proxies;
+			std::vector<ProxyID>	m_FreeProxies;
+			/* Alive proxies sorted by min bound on sweep axis */
+			std::vector<ProxyID>	m_Sorted;
+			std::size_t				m_Axis = 0u;
+		private:
+			std::size_t ChooseAxis() const;
+		};
+	}
+}
@@ -0,0 +1,37 @@
+#include "shade_pch.h"
+#include "BoxShape.h"
+#include <shade/core/physics/algo/AnalyticCollision.h>
+
+shade::physic::BoxShape::BoxShape(const glm::vec<3, scalar_t>& halfSize) : CollisionShape(Shape::Box)
+{
+	SetHalfSize(halfSize);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::BoxShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+{
+	const algo::ShapeFrame frame(transform);
+	return algo::BoxSupport(frame, m_HalfSize * frame.Scale, direction);
+}
+
+void shade::physic::BoxShape::SetHalfSize(const glm::vec<3, scalar_t>& halfSize)
+{
+	m_HalfSize = halfSize;
+	SetMinMaxHalfExt(-halfSize, halfSize);
+}
+
+void shade::physic::BoxShape::Serialize(std::ostream& stream) const
+{
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(GetShape()));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfSize.x));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfSize.y));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfSize.z));
+}
+
+void shade::physic::BoxShape::Deserialize(std::istream& stream)
+{
+	glm::vec3 halfSize;
+	serialize::Serializer::Deserialize(stream, halfSize.x);
+	serialize::Serializer::Deserialize(stream, halfSize.y);
+	serialize::Serializer::Deserialize(stream, halfSize.z);
+	SetHalfSize(halfSize);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/physics/shapes/CollisionShape.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Box centered at local origin */
+		class SHADE_API BoxShape : public CollisionShape
+		{
+		public:
+			BoxShape(const glm::vec<3, scalar_t>& halfSize = glm::vec<3, scalar_t>(0.5));
+			virtual ~BoxShape() = default;
+		public:
+			virtual glm::vec<3, scalar_t> FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const override;
+
+			void SetHalfSize(const glm::vec<3, scalar_t>& halfSize);
+			const glm::vec<3, scalar_t>& GetHalfSize() const { return m_HalfSize; }
+		private:
+			virtual void Serialize(std::ostream& stream) const override;
+			virtual void Deserialize(std::istream& stream) override;
+
+			glm::vec<3, scalar_t> m_HalfSize;
+			friend class serialize::Serializer;
+		};
+	}
+}
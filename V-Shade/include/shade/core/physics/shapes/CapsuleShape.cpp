@@ -0,0 +1,39 @@
+#include "shade_pch.h"
+#include "CapsuleShape.h"
+#include <shade/core/physics/algo/AnalyticCollision.h>
+
+shade::physic::CapsuleShape::CapsuleShape(scalar_t radius, scalar_t halfHeight) : CollisionShape(Shape::Capsule)
+{
+	SetSize(radius, halfHeight);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::CapsuleShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+{
+	const algo::ShapeFrame frame(transform);
+	const algo::Segment segment = algo::CapsuleSegment(frame, m_HalfHeight);
+	const scalar_t length = glm::length(direction);
+
+	const glm::vec<3, scalar_t> end = (glm::dot(segment.B - segment.A, direction) >= 0.0) ? segment.B : segment.A;
+	return (length > 0.0) ? end + direction * (algo::CapsuleRadius(frame, m_Radius) / length) : end;
+}
+
+void shade::physic::CapsuleShape::SetSize(scalar_t radius, scalar_t halfHeight)
+{
+	m_Radius = radius; m_HalfHeight = halfHeight;
+	SetMinMaxHalfExt(-glm::vec<3, scalar_t>(radius, halfHeight + radius, radius), glm::vec<3, scalar_t>(radius, halfHeight + radius, radius));
+}
+
+void shade::physic::CapsuleShape::Serialize(std::ostream& stream) const
+{
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(GetShape()));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_Radius));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfHeight));
+}
+
+void shade::physic::CapsuleShape::Deserialize(std::istream& stream)
+{
+	float radius = 0.f, halfHeight = 0.f;
+	serialize::Serializer::Deserialize(stream, radius);
+	serialize::Serializer::Deserialize(stream, halfHeight);
+	SetSize(radius, halfHeight);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/physics/shapes/CollisionShape.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Capsule along local Y axis, half height is distance from center to center of each cap */
+		class SHADE_API CapsuleShape : public CollisionShape
+		{
+		public:
+			CapsuleShape(scalar_t radius = 0.5, scalar_t halfHeight = 0.5);
+			virtual ~CapsuleShape() = default;
+		public:
+			virtual glm::vec<3, scalar_t> FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const override;
+
+			void SetSize(scalar_t radius, scalar_t halfHeight);
+			scalar_t GetRadius() const { return m_Radius; }
+			scalar_t GetHalfHeight() const { return m_HalfHeight; }
+		private:
+			virtual void Serialize(std::ostream& stream) const override;
+			virtual void Deserialize(std::istream& stream) override;
+
+			scalar_t m_Radius;
+			scalar_t m_HalfHeight;
+			friend class serialize::Serializer;
+		};
+	}
+}
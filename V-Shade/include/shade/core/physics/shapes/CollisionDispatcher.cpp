@@ -0,0 +1,137 @@
+#include "shade_pch.h"
+#include "CollisionDispatcher.h"
+#include <shade/core/physics/algo/GJK.h>
+#include <shade/core/physics/algo/AnalyticCollision.h>
+#include <shade/core/physics/shapes/SphereShape.h>
+#include <shade/core/physics/shapes/BoxShape.h>
+#include <shade/core/physics/shapes/CapsuleShape.h>
+#include <shade/core/physics/shapes/PlaneShape.h>
+
+namespace
+{
+	using namespace shade::physic;
+
+	using Manifold = CollisionShape::Manifold;
+	using mat4 = glm::mat<4, 4, scalar_t>;
+	using vec3 = glm::vec<3, scalar_t>;
+
+	/* Closed form routines leave local points empty, they are filled from frames which are already decomposed */
+	Manifold WithLocalPoints(Manifold manifold, const algo::ShapeFrame& frameA, const algo::ShapeFrame& frameB)
+	{
+		if (manifold.HasCollision)
+			algo::SetLocalContactPoints(manifold, frameA, frameB);
+		return manifold;
+	}
+
+	/* Plane is tested as box without thickness */
+	vec3 GetHalfSize(const PlaneShape& plane, const algo::ShapeFrame& frame)
+	{
+		return vec3(plane.GetHalfSize().x, 0.0, plane.GetHalfSize().y) * frame.Scale;
+	}
+
+	Manifold SphereSphere(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		return WithLocalPoints(algo::SphereSphere(
+			frameA.Position, static_cast<const SphereShape&>(shapeA).GetRadius() * frameA.GetMaxScale(),
+			frameB.Position, static_cast<const SphereShape&>(shapeB).GetRadius() * frameB.GetMaxScale()), frameA, frameB);
+	}
+	Manifold SphereBox(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		return WithLocalPoints(algo::SphereBox(
+			frameA.Position, static_cast<const SphereShape&>(shapeA).GetRadius() * frameA.GetMaxScale(),
+			frameB, static_cast<const BoxShape&>(shapeB).GetHalfSize() * frameB.Scale), frameA, frameB);
+	}
+	Manifold SpherePlane(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		return WithLocalPoints(algo::SphereBox(
+			frameA.Position, static_cast<const SphereShape&>(shapeA).GetRadius() * frameA.GetMaxScale(),
+			frameB, GetHalfSize(static_cast<const PlaneShape&>(shapeB), frameB)), frameA, frameB);
+	}
+	Manifold SphereCapsule(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		const CapsuleShape& capsule = static_cast<const CapsuleShape&>(shapeB);
+		return WithLocalPoints(algo::SphereCapsule(
+			frameA.Position, static_cast<const SphereShape&>(shapeA).GetRadius() * frameA.GetMaxScale(),
+			algo::CapsuleSegment(frameB, capsule.GetHalfHeight()), algo::CapsuleRadius(frameB, capsule.GetRadius())), frameA, frameB);
+	}
+	Manifold CapsuleCapsule(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		const CapsuleShape& capsuleA = static_cast<const CapsuleShape&>(shapeA), & capsuleB = static_cast<const CapsuleShape&>(shapeB);
+		return WithLocalPoints(algo::CapsuleCapsule(
+			algo::CapsuleSegment(frameA, capsuleA.GetHalfHeight()), algo::CapsuleRadius(frameA, capsuleA.GetRadius()),
+			algo::CapsuleSegment(frameB, capsuleB.GetHalfHeight()), algo::CapsuleRadius(frameB, capsuleB.GetRadius())), frameA, frameB);
+	}
+	Manifold BoxBox(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		return WithLocalPoints(algo::BoxBox(
+			frameA, static_cast<const BoxShape&>(shapeA).GetHalfSize() * frameA.Scale,
+			frameB, static_cast<const BoxShape&>(shapeB).GetHalfSize() * frameB.Scale), frameA, frameB);
+	}
+	Manifold BoxPlane(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		const algo::ShapeFrame frameA(transformA), frameB(transformB);
+		return WithLocalPoints(algo::BoxBox(
+			frameA, static_cast<const BoxShape&>(shapeA).GetHalfSize() * frameA.Scale,
+			frameB, GetHalfSize(static_cast<const PlaneShape&>(shapeB), frameB)), frameA, frameB);
+	}
+
+	/* Routines are written for one order of shapes, reversed pair swaps points and flips normal */
+	template<CollisionDispatcher::Function function>
+	Manifold Flipped(const CollisionShape& shapeA, const mat4& transformA, const CollisionShape& shapeB, const mat4& transformB)
+	{
+		Manifold manifold = function(shapeB, transformB, shapeA, transformA);
+		manifold.Normal = -manifold.Normal;
+		std::swap(manifold.ContactPointA_W, manifold.ContactPointB_W);
+		std::swap(manifold.ContactPointA_L, manifold.ContactPointB_L);
+		return manifold;
+	}
+
+	template<CollisionDispatcher::Function function>
+	void Register(std::array<std::array<CollisionDispatcher::Function, CollisionShape::Shape::SHAPE_MAX_ENUM>, CollisionShape::Shape::SHAPE_MAX_ENUM>& table, CollisionShape::Shape a, CollisionShape::Shape b)
+	{
+		table[a][b] = function;
+		if (a != b) table[b][a] = &Flipped<function>;
+	}
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::CollisionDispatcher::Dispatch(const CollisionShape& shapeA, const glm::mat<4, 4, scalar_t>& transformA, const CollisionShape& shapeB, const glm::mat<4, 4, scalar_t>& transformB)
+{
+	// GJK/EPA fallback fills local points itself
+	return GetTable()[shapeA.GetShape()][shapeB.GetShape()](shapeA, transformA, shapeB, transformB);
+}
+
+shade::physic::CollisionShape::Manifold shade::physic::CollisionDispatcher::GJK_EPA(const CollisionShape& shapeA, const glm::mat<4, 4, scalar_t>& transformA, const CollisionShape& shapeB, const glm::mat<4, 4, scalar_t>& transformB)
+{
+	auto [hasCollision, simplex] = algo::GJK(shapeA, transformA, shapeB, transformB);
+	if (hasCollision)
+		return algo::EPA(simplex, shapeA, transformA, shapeB, transformB);
+	else
+		return { false }; // Return no collision
+}
+
+const shade::physic::CollisionDispatcher::Table& shade::physic::CollisionDispatcher::GetTable()
+{
+	static const Table table = []()
+	{
+		Table table;
+		for (auto& row : table) row.fill(&CollisionDispatcher::GJK_EPA);
+
+		Register<&SphereSphere>(table, CollisionShape::Shape::Sphere, CollisionShape::Shape::Sphere);
+		Register<&SphereBox>(table, CollisionShape::Shape::Sphere, CollisionShape::Shape::Box);
+		Register<&SpherePlane>(table, CollisionShape::Shape::Sphere, CollisionShape::Shape::Plane);
+		Register<&SphereCapsule>(table, CollisionShape::Shape::Sphere, CollisionShape::Shape::Capsule);
+		Register<&CapsuleCapsule>(table, CollisionShape::Shape::Capsule, CollisionShape::Shape::Capsule);
+		Register<&BoxBox>(table, CollisionShape::Shape::Box, CollisionShape::Shape::Box);
+		Register<&BoxPlane>(table, CollisionShape::Shape::Box, CollisionShape::Shape::Plane);
+
+		return table;
+	}();
+
+	return table;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/physics/shapes/CollisionShape.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Table of collision routines indexed by pair of shape types, pairs without closed form routine use GJK and EPA */
+		class SHADE_API CollisionDispatcher
+		{
+		public:
+			using Function = CollisionShape::Manifold(*)(const CollisionShape& shapeA, const glm::mat<4, 4, scalar_t>& transformA, const CollisionShape& shapeB, const glm::mat<4, 4, scalar_t>& transformB);
+		public:
+			static CollisionShape::Manifold Dispatch(const CollisionShape& shapeA, const glm::mat<4, 4, scalar_t>& transformA, const CollisionShape& shapeB, const glm::mat<4, 4, scalar_t>& transformB);
+			/* General routine which works for any pair of convex shapes */
+			static CollisionShape::Manifold GJK_EPA(const CollisionShape& shapeA, const glm::mat<4, 4, scalar_t>& transformA, const CollisionShape& shapeB, const glm::mat<4, 4, scalar_t>& transformB);
+		private:
+			using Table = std::array<std::array<Function, CollisionShape::Shape::SHAPE_MAX_ENUM>, CollisionShape::Shape::SHAPE_MAX_ENUM>;
+			static const Table& GetTable();
+		};
+	}
+}
@@ -1,6 +1,11 @@
 #include "shade_pch.h"
 #include "CollisionShape.h"
 #include "MeshShape.h"
+#include "SphereShape.h"
+#include "BoxShape.h"
+#include "CapsuleShape.h"
+#include "PlaneShape.h"
+#include "CollisionDispatcher.h"
 
 static void CalculateAxes(const std::array<glm::vec<3, shade::physic::scalar_t>, 8>& aCorners, const std::array<glm::vec<3, shade::physic::scalar_t>, 8>& bCorners, std::array<glm::vec<3, shade::physic::scalar_t>, 15>& axes)
 {
@@ -110,6 +115,8 @@ shade::physic::CollisionShape::Shape shade::physic::CollisionShape::GetShapeFrom
 		return Shape::Plane;
 	if (shape == "Mesh")
 		return Shape::Mesh;
+	if (shape == "Box")
+		return Shape::Box;
 
 	return Shape::SHAPE_MAX_ENUM;
 }
@@ -123,6 +130,7 @@ std::string shade::physic::CollisionShape::GetShapeAsString(Shape shape)
 	case shade::physic::CollisionShape::Shape::Capsule:  return "Capsule";
 	case shade::physic::CollisionShape::Shape::Plane:  return "Plane";
 	case shade::physic::CollisionShape::Shape::Mesh:  return "Mesh";
+	case shade::physic::CollisionShape::Shape::Box:  return "Box";
 	default:
 		return "Undefined";
 	}
@@ -132,6 +140,11 @@ shade::physic::CollisionShape::CollisionShape(Shape shape) : m_Shape(shape)
 {
 }
 
+shade::physic::CollisionShape::Manifold shade::physic::CollisionShape::TestCollision(const glm::mat<4, 4, scalar_t>& transform, const CollisionShape& otherShape, const glm::mat<4, 4, scalar_t>& otherTransform) const
+{
+	return CollisionDispatcher::Dispatch(*this, transform, otherShape, otherTransform);
+}
+
 void shade::physic::CollisionShape::SetMinMaxHalfExt(const glm::vec<3, scalar_t>& minExt, const glm::vec<3, scalar_t>& maxExt)
 {
 	m_MinHalfExt = minExt;
@@ -210,6 +223,7 @@ void shade::physic::CollisionShapes::Deserialize(std::istream& stream)
 			if (verticesCount <= 0 || verticesCount >= UINT32_MAX)
 				throw std::exception("Invalide lods count!");
 
+			std::vector<glm::vec<3, scalar_t>> vertices(verticesCount);
 			for (std::size_t v = 0; v < verticesCount; v++)
 			{
 				glm::vec3 point;
@@ -218,12 +232,43 @@ void shade::physic::CollisionShapes::Deserialize(std::istream& stream)
 				serialize::Serializer::Deserialize(stream, point.y);
 				serialize::Serializer::Deserialize(stream, point.z);
 
-				collider->AddVertex(point);
+				vertices[v] = point;
 			}
+			collider->SetVertices(vertices);
 
 			AddShape(collider);
+			break;
 		}
-
+		case CollisionShape::Shape::Sphere:
+		{
+			auto collider = shade::SharedPointer<shade::physic::SphereShape>::Create();
+			serialize::Serializer::Deserialize<CollisionShape>(stream, *collider);
+			AddShape(collider);
+			break;
+		}
+		case CollisionShape::Shape::Box:
+		{
+			auto collider = shade::SharedPointer<shade::physic::BoxShape>::Create();
+			serialize::Serializer::Deserialize<CollisionShape>(stream, *collider);
+			AddShape(collider);
+			break;
+		}
+		case CollisionShape::Shape::Capsule:
+		{
+			auto collider = shade::SharedPointer<shade::physic::CapsuleShape>::Create();
+			serialize::Serializer::Deserialize<CollisionShape>(stream, *collider);
+			AddShape(collider);
+			break;
+		}
+		case CollisionShape::Shape::Plane:
+		{
+			auto collider = shade::SharedPointer<shade::physic::PlaneShape>::Create();
+			serialize::Serializer::Deserialize<CollisionShape>(stream, *collider);
+			AddShape(collider);
+			break;
+		}
+		default:
+			throw std::exception("Unsupported collision shape!");
 		}
 
 	}
@@ -79,6 +79,7 @@ namespace shade
 				Capsule,
 				Plane,
 				Mesh,
+				Box,
 
 				SHAPE_MAX_ENUM
 			};
@@ -91,7 +92,8 @@ namespace shade
 		public:
 			void SetMinMaxHalfExt(const glm::vec<3, scalar_t>& minExt, const glm::vec<3, scalar_t>& maxExt);
 
-			virtual Manifold TestCollision(const glm::mat<4, 4, scalar_t>& transform, const CollisionShape& otherShape, const glm::mat<4, 4, scalar_t>& otherTransform) const = 0; // TODO: {} insead of  = 0
+			/* Uses closed form routine for known pair of shapes and GJK with EPA otherwise */
+			virtual Manifold TestCollision(const glm::mat<4, 4, scalar_t>& transform, const CollisionShape& otherShape, const glm::mat<4, 4, scalar_t>& otherTransform) const;
 			virtual glm::vec<3, scalar_t> FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const = 0; // TODO: {} insead of  = 0
 		
 			const glm::vec<3, scalar_t>& GetMinHalfExt() const;
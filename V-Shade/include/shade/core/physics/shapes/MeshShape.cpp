@@ -1,56 +1,252 @@
 #include "shade_pch.h"
 #include "MeshShape.h"
-#include <shade/core/physics/algo/GJK.h>
+#include <shade/core/physics/algo/ConvexHullGenerator.h>
+#include <emmintrin.h>
 
-shade::physic::CollisionShape::Manifold shade::physic::MeshShape::TestCollision(const glm::mat<4,4, scalar_t>& transform, const CollisionShape& otherShape, const glm::mat<4, 4, scalar_t>& otherTransform) const
+glm::vec<3, shade::physic::scalar_t> shade::physic::MeshShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+{
+	if (m_Vertices.empty()) return glm::vec<3, scalar_t>(0.0);
+
+	// dot(M * v, d) == dot(v, transpose(M) * d), so direction is transformed once instead of every vertex
+	const glm::vec<3, scalar_t> localDirection = glm::transpose(glm::mat<3, 3, scalar_t>(transform)) * direction;
+	const glm::vec<3, scalar_t>& vertex = m_Vertices[FindFurthestPointLocal(localDirection)];
+
+	return glm::vec<3, scalar_t>(transform * glm::vec<4, scalar_t>(vertex, 1.0));
+}
+
+std::size_t shade::physic::MeshShape::FindFurthestPointLocal(const glm::vec<3, scalar_t>& direction) const
 {
-	auto [hasCollision, simplex] = algo::GJK(*this, transform, otherShape, otherTransform);
-	if (hasCollision)
-		return algo::EPA(simplex, *this, transform, otherShape, otherTransform);
+	EnsureSupportData();
+	return (m_AdjacencyOffsets.empty()) ? ScanFurthestPoint(direction) : ClimbFurthestPoint(direction);
+}
+
+std::size_t shade::physic::MeshShape::ScanFurthestPoint(const glm::vec<3, scalar_t>& direction) const
+{
+	if constexpr (std::is_same_v<scalar_t, double>)
+	{
+		const __m128d dx = _mm_set1_pd(direction.x), dy = _mm_set1_pd(direction.y), dz = _mm_set1_pd(direction.z);
+		__m128d maxDistance = _mm_set1_pd(-DBL_MAX), maxIndex = _mm_setzero_pd();
+		__m128d index = _mm_set_pd(1.0, 0.0);
+		const __m128d step = _mm_set1_pd(2.0);
+
+		for (std::size_t i = 0; i < m_X.size(); i += 2)
+		{
+			const __m128d distance = _mm_add_pd(_mm_add_pd(
+				_mm_mul_pd(_mm_loadu_pd(&m_X[i]), dx),
+				_mm_mul_pd(_mm_loadu_pd(&m_Y[i]), dy)),
+				_mm_mul_pd(_mm_loadu_pd(&m_Z[i]), dz));
+
+			const __m128d mask = _mm_cmpgt_pd(distance, maxDistance);
+			maxDistance = _mm_or_pd(_mm_and_pd(mask, distance), _mm_andnot_pd(mask, maxDistance));
+			maxIndex	= _mm_or_pd(_mm_and_pd(mask, index), _mm_andnot_pd(mask, maxIndex));
+			index		= _mm_add_pd(index, step);
+		}
+
+		alignas(16) double distances[2], indices[2];
+		_mm_store_pd(distances, maxDistance); _mm_store_pd(indices, maxIndex);
+		// Lower index wins on equal distance, same as scalar scan
+		const std::size_t lane = (distances[1] > distances[0] || (distances[1] == distances[0] && indices[1] < indices[0])) ? 1u : 0u;
+		return static_cast<std::size_t>(indices[lane]);
+	}
 	else
-		return { false }; // Return no collision
+	{
+		std::size_t maxIndex = 0u; scalar_t maxDistance = -std::numeric_limits<scalar_t>::max();
+		for (std::size_t i = 0; i < m_Vertices.size(); ++i)
+		{
+			const scalar_t distance = glm::dot(m_Vertices[i], direction);
+			if (distance > maxDistance) { maxDistance = distance; maxIndex = i; }
+		}
+		return maxIndex;
+	}
 }
 
-glm::vec<3, shade::physic::scalar_t> shade::physic::MeshShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+std::size_t shade::physic::MeshShape::ClimbFurthestPoint(const glm::vec<3, scalar_t>& direction) const
 {
-	glm::vec<3, shade::physic::scalar_t> maxPoint(0.f);
-	float     maxDistance = -FLT_MAX;
-	for (const glm::vec<3, shade::physic::scalar_t>& v : m_Vertices)
+	// On convex hull local maximum is global one
+	std::uint32_t current = m_ClimbStart; scalar_t maxDistance = glm::dot(m_Vertices[current], direction);
+
+	for (bool isClimbing = true; isClimbing;)
 	{
-		// We need non-transposed matrix but glm allready use transposed matrices, so that's why we are transposing matrix back
-		const glm::vec<3, scalar_t> vertex = glm::vec<3, scalar_t>(glm::vec<4, scalar_t>(v, 1.0) * glm::transpose(transform));
-		const float distance = glm::dot(vertex, direction);
-		if (distance > maxDistance) 
+		isClimbing = false;
+		for (std::uint32_t i = m_AdjacencyOffsets[current]; i < m_AdjacencyOffsets[current + 1]; ++i)
 		{
-			maxDistance = distance;
-			maxPoint = vertex;
+			const std::uint32_t neighbour = m_Adjacency[i];
+			const scalar_t distance = glm::dot(m_Vertices[neighbour], direction);
+			if (distance > maxDistance)
+			{
+				maxDistance = distance; current = neighbour; isClimbing = true;
+				break;
+			}
 		}
 	}
-	return maxPoint;
+	return current;
+}
+
+void shade::physic::MeshShape::InvalidateSupportData()
+{
+	std::lock_guard lock(m_SupportDataMutex);
+	m_IsSupportDataValid.store(false, std::memory_order_release);
 }
 
+void shade::physic::MeshShape::EnsureSupportData() const
+{
+	if (m_IsSupportDataValid.load(std::memory_order_acquire)) return;
+
+	std::lock_guard lock(m_SupportDataMutex);
+	if (!m_IsSupportDataValid.load(std::memory_order_relaxed))
+	{
+		BuildSupportData();
+		m_IsSupportDataValid.store(true, std::memory_order_release);
+	}
+}
+
+void shade::physic::MeshShape::BuildSupportData() const
+{
+	m_AdjacencyOffsets.clear(); m_Adjacency.clear(); m_ClimbStart = 0u;
+
+	if (m_Vertices.size() >= HillClimbingThreshold)
+	{
+		if (!m_HullIndices.empty())
+		{
+			BuildAdjacency(m_HullIndices);
+		}
+		else
+		{
+			// Triangles aren't stored with asset, so hull is generated only to get them, vertices of asset stay as they are
+			Vertices cloud(m_Vertices.size());
+			for (std::size_t i = 0; i < m_Vertices.size(); ++i)
+				cloud[i].Position = m_Vertices[i];
+
+			auto [hull, hullIndices] = algo::GenerateConvexHull(cloud, 0.0001);
+			if (!hull.empty() && !hullIndices.empty())
+			{
+				// Hull vertices are points of the cloud, so triangles are remapped to indices of asset vertices
+				const auto less = [](const std::pair<glm::vec3, std::uint32_t>& a, const std::pair<glm::vec3, std::uint32_t>& b)
+					{
+						return std::tie(a.first.x, a.first.y, a.first.z, a.second) < std::tie(b.first.x, b.first.y, b.first.z, b.second);
+					};
+
+				std::vector<std::pair<glm::vec3, std::uint32_t>> sorted(cloud.size());
+				for (std::size_t i = 0; i < cloud.size(); ++i)
+					sorted[i] = { cloud[i].Position, static_cast<std::uint32_t>(i) };
+				std::sort(sorted.begin(), sorted.end(), less);
+
+				Indices remapped(hullIndices.size());
+				for (std::size_t i = 0; i < hullIndices.size(); ++i)
+				{
+					const glm::vec3 position = glm::vec3(hull[hullIndices[i]]);
+					auto found = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(position, 0u), less);
+					if (found == sorted.end() || found->first != position)
+					{
+						UpdateLayout();
+						return;
+					}
+					remapped[i] = found->second;
+				}
+
+				BuildAdjacency(remapped);
+			}
+		}
+	}
+
+	UpdateLayout();
+}
+
+void shade::physic::MeshShape::UpdateLayout() const
+{
+	const std::size_t count = m_Vertices.size() + (m_Vertices.size() & 1u);
+	m_X.clear(); m_Y.clear(); m_Z.clear();
+	if (m_Vertices.empty()) return;
+
+	m_X.resize(count); m_Y.resize(count); m_Z.resize(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		// Padding repeats last vertex, so it never wins over real one
+		const glm::vec<3, scalar_t>& vertex = m_Vertices[glm::min(i, m_Vertices.size() - 1)];
+		m_X[i] = vertex.x; m_Y[i] = vertex.y; m_Z[i] = vertex.z;
+	}
+}
+
+void shade::physic::MeshShape::BuildAdjacency(const Indices& indices) const
+{
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> edges; edges.reserve(indices.size() * 2);
+	for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		for (std::size_t k = 0; k < 3; ++k)
+		{
+			const std::uint32_t a = indices[i + k], b = indices[i + (k + 1) % 3];
+			if (a >= m_Vertices.size() || b >= m_Vertices.size()) return;
+			edges.emplace_back(a, b); edges.emplace_back(b, a);
+		}
+	}
+
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+	m_AdjacencyOffsets.assign(m_Vertices.size() + 1, 0u);
+	for (const auto& [from, to] : edges)
+		m_AdjacencyOffsets[from + 1]++;
+	for (std::size_t i = 1; i < m_AdjacencyOffsets.size(); ++i)
+		m_AdjacencyOffsets[i] += m_AdjacencyOffsets[i - 1];
+
+	m_Adjacency.resize(edges.size());
+	for (std::size_t i = 0; i < edges.size(); ++i)
+		m_Adjacency[i] = edges[i].second;
+
+	// Vertices without edges are inside of hull and never win, but all hull vertices have to be reachable by climbing
+	std::size_t hullCount = 0u;
+	for (std::size_t i = 0; i < m_Vertices.size(); ++i)
+	{
+		if (m_AdjacencyOffsets[i] != m_AdjacencyOffsets[i + 1])
+		{
+			if (!hullCount) m_ClimbStart = static_cast<std::uint32_t>(i);
+			hullCount++;
+		}
+	}
+
+	std::vector<bool> isVisited(m_Vertices.size(), false);
+	std::vector<std::uint32_t> stack{ m_ClimbStart }; isVisited[m_ClimbStart] = true;
+	std::size_t visitedCount = 0u;
+	while (!stack.empty())
+	{
+		const std::uint32_t current = stack.back(); stack.pop_back(); visitedCount++;
+		for (std::uint32_t i = m_AdjacencyOffsets[current]; i < m_AdjacencyOffsets[current + 1]; ++i)
+		{
+			if (!isVisited[m_Adjacency[i]]) { isVisited[m_Adjacency[i]] = true; stack.emplace_back(m_Adjacency[i]); }
+		}
+	}
+
+	if (!hullCount || visitedCount != hullCount)
+	{
+		m_AdjacencyOffsets.clear(); m_Adjacency.clear(); m_ClimbStart = 0u;
+	}
+}
 
 void shade::physic::MeshShape::AddVertex(const glm::vec<3, scalar_t>& vertex)
 {
-	m_Vertices.emplace_back(vertex);
+	m_Vertices.emplace_back(vertex); m_HullIndices.clear();
+	InvalidateSupportData();
 }
 
 void shade::physic::MeshShape::AddVertices(const std::vector<glm::vec<3, scalar_t>>& vertices)
 {
-	std::copy(vertices.begin(), vertices.end(), std::back_inserter(m_Vertices));
+	std::copy(vertices.begin(), vertices.end(), std::back_inserter(m_Vertices)); m_HullIndices.clear();
+	InvalidateSupportData();
 }
 
 void shade::physic::MeshShape::SetVertices(std::vector<glm::vec<3, scalar_t>>& vertices)
 {
-	m_Vertices = std::move(vertices);
+	m_Vertices = std::move(vertices); m_HullIndices.clear();
+	InvalidateSupportData();
 }
 
-const std::vector<glm::vec<3, shade::physic::scalar_t>>& shade::physic::MeshShape::GetVertices() const
+void shade::physic::MeshShape::SetHull(std::vector<glm::vec<3, scalar_t>>& vertices, const Indices& indices)
 {
-	return m_Vertices;
+	m_Vertices = std::move(vertices); m_HullIndices = indices;
+	InvalidateSupportData();
 }
 
-std::vector<glm::vec<3, shade::physic::scalar_t>>& shade::physic::MeshShape::GetVertices()
+const std::vector<glm::vec<3, shade::physic::scalar_t>>& shade::physic::MeshShape::GetVertices() const
 {
 	return m_Vertices;
 }
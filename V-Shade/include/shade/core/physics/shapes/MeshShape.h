@@ -1,6 +1,7 @@
 #pragma once
 #include <shade/config/ShadeAPI.h>
 #include <shade/core/physics/shapes/CollisionShape.h>
+#include <shade/core/render/vertex/Vertex.h>
 
 namespace shade
 {
@@ -8,24 +9,50 @@ namespace shade
 	{
 		class SHADE_API MeshShape : public CollisionShape
 		{
+		public:
+			/* Hulls with this count of vertices and more use hill climbing over adjacency instead of full scan */
+			static constexpr std::size_t HillClimbingThreshold = 32u;
 		public:
 			MeshShape() : CollisionShape(Shape::Mesh) {}
 			virtual ~MeshShape() = default;
 		public:
-			virtual Manifold TestCollision(const glm::mat<4,4, scalar_t>& transform, const CollisionShape& otherShape, const glm::mat<4, 4, scalar_t>& otherTransform) const override;
 			virtual glm::vec<3, scalar_t> FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const override;
 
 			void AddVertex(const glm::vec<3, scalar_t>& vertex);
 			void AddVertices(const std::vector<glm::vec<3, scalar_t>>& vertices);
 			void SetVertices(std::vector<glm::vec<3, scalar_t>>& vertices);
+			/* Set vertices with triangles produced by ConvexHullGenerator, triangles give adjacency for hill climbing */
+			void SetHull(std::vector<glm::vec<3, scalar_t>>& vertices, const Indices& indices);
 
 			const std::vector<glm::vec<3, scalar_t>>& GetVertices() const;
-			std::vector<glm::vec<3, scalar_t>>& GetVertices();
+			/* Return index of vertex furthest along direction in local space */
+			std::size_t FindFurthestPointLocal(const glm::vec<3, scalar_t>& direction) const;
+		private:
+			/* Support data is rebuilt on first query after vertices have changed */
+			void InvalidateSupportData();
+			void EnsureSupportData() const;
+			void BuildSupportData() const;
+			void UpdateLayout() const;
+			void BuildAdjacency(const Indices& indices) const;
+			std::size_t ScanFurthestPoint(const glm::vec<3, scalar_t>& direction) const;
+			std::size_t ClimbFurthestPoint(const glm::vec<3, scalar_t>& direction) const;
 		private:
 			virtual void Serialize(std::ostream& stream) const override;
 			virtual void Deserialize(std::istream& stream) override;
 
 			std::vector<glm::vec<3, scalar_t>> m_Vertices;
+			/* Triangles of hull given with SetHull, empty when they have to be generated */
+			Indices m_HullIndices;
+
+			mutable std::mutex m_SupportDataMutex;
+			mutable std::atomic<bool> m_IsSupportDataValid = false;
+			/* Vertices in structure of arrays layout for SIMD scan, padded to even count */
+			mutable std::vector<scalar_t> m_X, m_Y, m_Z;
+			/* Neighbours of vertex i are m_Adjacency[m_AdjacencyOffsets[i] .. m_AdjacencyOffsets[i + 1]] */
+			mutable std::vector<std::uint32_t> m_AdjacencyOffsets;
+			mutable std::vector<std::uint32_t> m_Adjacency;
+			/* Climbing starts from hull vertex, vertices inside of hull have no neighbours */
+			mutable std::uint32_t m_ClimbStart = 0u;
 			friend class serialize::Serializer;
 		};
 	}
@@ -0,0 +1,37 @@
+#include "shade_pch.h"
+#include "PlaneShape.h"
+#include <shade/core/physics/algo/AnalyticCollision.h>
+
+shade::physic::PlaneShape::PlaneShape(const glm::vec<2, scalar_t>& halfSize) : CollisionShape(Shape::Plane)
+{
+	SetHalfSize(halfSize);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::PlaneShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+{
+	const algo::ShapeFrame frame(transform);
+	// Plane is a box without thickness
+	return algo::BoxSupport(frame, glm::vec<3, scalar_t>(m_HalfSize.x, 0.0, m_HalfSize.y) * frame.Scale, direction);
+}
+
+void shade::physic::PlaneShape::SetHalfSize(const glm::vec<2, scalar_t>& halfSize)
+{
+	m_HalfSize = halfSize;
+	// Small thickness keeps bounds valid for broad and middle phases
+	SetMinMaxHalfExt(glm::vec<3, scalar_t>(-halfSize.x, -0.01, -halfSize.y), glm::vec<3, scalar_t>(halfSize.x, 0.01, halfSize.y));
+}
+
+void shade::physic::PlaneShape::Serialize(std::ostream& stream) const
+{
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(GetShape()));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfSize.x));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_HalfSize.y));
+}
+
+void shade::physic::PlaneShape::Deserialize(std::istream& stream)
+{
+	glm::vec2 halfSize;
+	serialize::Serializer::Deserialize(stream, halfSize.x);
+	serialize::Serializer::Deserialize(stream, halfSize.y);
+	SetHalfSize(halfSize);
+}
@@ -0,0 +1,35 @@
+#include "shade_pch.h"
+#include "SphereShape.h"
+#include <shade/core/physics/algo/AnalyticCollision.h>
+
+shade::physic::SphereShape::SphereShape(scalar_t radius) : CollisionShape(Shape::Sphere)
+{
+	SetRadius(radius);
+}
+
+glm::vec<3, shade::physic::scalar_t> shade::physic::SphereShape::FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const
+{
+	const algo::ShapeFrame frame(transform);
+	const scalar_t length = glm::length(direction);
+
+	return (length > 0.0) ? frame.Position + direction * (frame.GetMaxScale() * m_Radius / length) : frame.Position;
+}
+
+void shade::physic::SphereShape::SetRadius(scalar_t radius)
+{
+	m_Radius = radius;
+	SetMinMaxHalfExt(glm::vec<3, scalar_t>(-radius), glm::vec<3, scalar_t>(radius));
+}
+
+void shade::physic::SphereShape::Serialize(std::ostream& stream) const
+{
+	serialize::Serializer::Serialize(stream, static_cast<std::uint32_t>(GetShape()));
+	serialize::Serializer::Serialize(stream, static_cast<float>(m_Radius));
+}
+
+void shade::physic::SphereShape::Deserialize(std::istream& stream)
+{
+	float radius = 0.f;
+	serialize::Serializer::Deserialize(stream, radius);
+	SetRadius(radius);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/physics/shapes/CollisionShape.h>
+
+namespace shade
+{
+	namespace physic
+	{
+		/* Sphere around local origin */
+		class SHADE_API SphereShape : public CollisionShape
+		{
+		public:
+			SphereShape(scalar_t radius = 0.5);
+			virtual ~SphereShape() = default;
+		public:
+			virtual glm::vec<3, scalar_t> FindFurthestPointWorld(const glm::mat<4, 4, scalar_t>& transform, const glm::vec<3, scalar_t>& direction) const override;
+
+			void SetRadius(scalar_t radius);
+			scalar_t GetRadius() const { return m_Radius; }
+		private:
+			virtual void Serialize(std::ostream& stream) const override;
+			virtual void Deserialize(std::istream& stream) override;
+
+			scalar_t m_Radius;
+			friend class serialize::Serializer;
+		};
+	}
+}
@@ -0,0 +1,66 @@
+#include "shade_pch.h"
+#include "DrawKey.h"
+#include <shade/utils/Logger.h>
+
+shade::render::IdRegistry::IdRegistry(std::uint32_t capacity) :
+	m_Capacity(capacity)
+{
+	Clear();
+}
+
+std::uint32_t shade::render::IdRegistry::Register(std::size_t hash)
+{
+	auto [id, isNew] = m_IDs.try_emplace(hash, static_cast<std::uint32_t>(m_IDs.size()));
+	// Identifier which doesn't fit its field would alias another object in draw key, so it's never handed out
+	if (id->second >= m_Capacity)
+		SHADE_CORE_ERROR("Id registry is out of capacity = {}, draw key field is too narrow !", m_Capacity);
+	return id->second;
+}
+
+std::uint32_t shade::render::IdRegistry::Find(std::size_t hash) const
+{
+	auto id = m_IDs.find(hash);
+	return (id != m_IDs.end()) ? id->second : INVALID_ID;
+}
+
+void shade::render::IdRegistry::Clear()
+{
+	m_IDs.clear(); m_IDs.emplace(std::size_t(0), 0u);
+}
+
+void shade::render::RadixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch)
+{
+	if (keys.size() < 2) return;
+
+	// Histograms of all bytes are built in one pass
+	std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+	for (const std::uint64_t key : keys)
+		for (std::size_t byte = 0; byte < 8; ++byte)
+			histograms[byte][(key >> (byte * 8u)) & 0xFFu]++;
+
+	scratch.resize(keys.size());
+	std::vector<std::uint64_t>* source = &keys, *destination = &scratch;
+
+	for (std::size_t byte = 0; byte < 8; ++byte)
+	{
+		auto& histogram = histograms[byte];
+
+		// All keys have the same byte, pass wouldn't change the order
+		if (histogram[((*source)[0] >> (byte * 8u)) & 0xFFu] == keys.size())
+			continue;
+
+		std::uint32_t offset = 0;
+		for (std::uint32_t& count : histogram)
+		{
+			const std::uint32_t current = count; count = offset; offset += current;
+		}
+
+		for (const std::uint64_t key : *source)
+			(*destination)[histogram[(key >> (byte * 8u)) & 0xFFu]++] = key;
+
+		std::swap(source, destination);
+	}
+
+	if (source != &keys)
+		keys.swap(scratch);
+}
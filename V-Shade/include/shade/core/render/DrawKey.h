@@ -0,0 +1,72 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <ankerl/unordered_dense.h>
+
+namespace shade
+{
+	namespace render
+	{
+		// Dense identifiers of objects which take part in draw keys, hash 0 (null object) always has identifier 0
+		class SHADE_API IdRegistry
+		{
+		public:
+			static constexpr std::uint32_t INVALID_ID = ~0u;
+		public:
+			IdRegistry(std::uint32_t capacity);
+			~IdRegistry() = default;
+		public:
+			// Returns existing identifier or assigns new one, aborts when capacity is exceeded
+			std::uint32_t Register(std::size_t hash);
+			// Returns INVALID_ID when hash hasn't been registered
+			std::uint32_t Find(std::size_t hash) const;
+			void Clear();
+
+			SHADE_INLINE std::uint32_t GetCount() const { return static_cast<std::uint32_t>(m_IDs.size()); }
+			SHADE_INLINE std::uint32_t GetCapacity() const { return m_Capacity; }
+		private:
+			ankerl::unordered_dense::map<std::size_t, std::uint32_t> m_IDs;
+			std::uint32_t m_Capacity;
+		};
+
+		// Packed sort key of instance batch, fields which are more expensive to switch take higher bits
+		// | Pipeline 8 | Material 18 | Mesh 20 | Lod 4 | Split 14 |
+		struct DrawKey
+		{
+			static constexpr std::uint32_t SPLIT_BITS		= 14;
+			static constexpr std::uint32_t LOD_BITS			= 4;
+			static constexpr std::uint32_t MESH_BITS		= 20;
+			static constexpr std::uint32_t MATERIAL_BITS	= 18;
+			static constexpr std::uint32_t PIPELINE_BITS	= 8;
+
+			static constexpr std::uint32_t SPLIT_SHIFT		= 0;
+			static constexpr std::uint32_t LOD_SHIFT		= SPLIT_SHIFT + SPLIT_BITS;
+			static constexpr std::uint32_t MESH_SHIFT		= LOD_SHIFT + LOD_BITS;
+			static constexpr std::uint32_t MATERIAL_SHIFT	= MESH_SHIFT + MESH_BITS;
+			static constexpr std::uint32_t PIPELINE_SHIFT	= MATERIAL_SHIFT + MATERIAL_BITS;
+
+			static_assert(PIPELINE_SHIFT + PIPELINE_BITS == 64, "Draw key fields have to take exactly 64 bits");
+
+			// Values are range checked on register, mask only keeps them inside their field
+			SHADE_INLINE static constexpr std::uint64_t Field(std::uint64_t value, std::uint32_t bits, std::uint32_t shift) { return (value & ((1ull << bits) - 1ull)) << shift; }
+
+			SHADE_INLINE static constexpr std::uint64_t Make(std::uint32_t pipeline, std::uint32_t material, std::uint32_t mesh, std::uint32_t lod, std::uint32_t split)
+			{
+				return Field(pipeline, PIPELINE_BITS, PIPELINE_SHIFT) | Field(material, MATERIAL_BITS, MATERIAL_SHIFT) | Field(mesh, MESH_BITS, MESH_SHIFT) | Field(lod, LOD_BITS, LOD_SHIFT) | Field(split, SPLIT_BITS, SPLIT_SHIFT);
+			}
+			// Key of bone palettes which are submitted per pipeline and model
+			SHADE_INLINE static constexpr std::uint64_t MakeModel(std::uint32_t pipeline, std::uint32_t model)
+			{
+				return (static_cast<std::uint64_t>(pipeline) << 32u) | static_cast<std::uint64_t>(model);
+			}
+
+			SHADE_INLINE static constexpr std::uint32_t GetPipeline(std::uint64_t key) { return static_cast<std::uint32_t>((key >> PIPELINE_SHIFT) & ((1ull << PIPELINE_BITS) - 1ull)); }
+			SHADE_INLINE static constexpr std::uint32_t GetMaterial(std::uint64_t key) { return static_cast<std::uint32_t>((key >> MATERIAL_SHIFT) & ((1ull << MATERIAL_BITS) - 1ull)); }
+			SHADE_INLINE static constexpr std::uint32_t GetMesh(std::uint64_t key)		{ return static_cast<std::uint32_t>((key >> MESH_SHIFT) & ((1ull << MESH_BITS) - 1ull)); }
+			SHADE_INLINE static constexpr std::uint32_t GetLod(std::uint64_t key)		{ return static_cast<std::uint32_t>((key >> LOD_SHIFT) & ((1ull << LOD_BITS) - 1ull)); }
+			SHADE_INLINE static constexpr std::uint32_t GetSplit(std::uint64_t key)		{ return static_cast<std::uint32_t>((key >> SPLIT_SHIFT) & ((1ull << SPLIT_BITS) - 1ull)); }
+		};
+
+		// LSD radix sort by bytes, bytes which are equal for all keys are skipped, scratch is used as second buffer
+		SHADE_API void RadixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch);
+	}
+}
@@ -0,0 +1,141 @@
+#include "shade_pch.h"
+#include "FrustumCulling.h"
+#include <bit>
+
+namespace
+{
+	// Plane components are broadcasted once, abs of normal is used to get box projected radius
+	struct Planes
+	{
+		__m128 X[6], Y[6], Z[6], W[6];
+		__m128 AbsX[6], AbsY[6], AbsZ[6];
+	};
+
+	Planes BroadcastPlanes(const shade::CameraFrustum& frustum)
+	{
+		Planes planes;
+		for (std::size_t i = 0; i < 6; ++i)
+		{
+			const glm::vec4& plane = frustum.GetSides()[i];
+			planes.X[i] = _mm_set1_ps(plane.x); planes.Y[i] = _mm_set1_ps(plane.y); planes.Z[i] = _mm_set1_ps(plane.z); planes.W[i] = _mm_set1_ps(plane.w);
+			planes.AbsX[i] = _mm_set1_ps(std::abs(plane.x)); planes.AbsY[i] = _mm_set1_ps(std::abs(plane.y)); planes.AbsZ[i] = _mm_set1_ps(std::abs(plane.z));
+		}
+		return planes;
+	}
+
+	// Returns bit mask of 4 boxes which are inside or intersect frustum
+	std::uint32_t InsideMask(const Planes& planes, __m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey, __m128 ez)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		__m128 outside = _mm_setzero_ps();
+
+		for (std::size_t p = 0; p < 6; ++p)
+		{
+			// Signed distance of center and radius of box along plane normal, box is outside when whole of it is behind the plane
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, planes.X[p]), _mm_mul_ps(cy, planes.Y[p])), _mm_add_ps(_mm_mul_ps(cz, planes.Z[p]), planes.W[p]));
+			const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, planes.AbsX[p]), _mm_mul_ps(ey, planes.AbsY[p])), _mm_mul_ps(ez, planes.AbsZ[p]));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		return ~static_cast<std::uint32_t>(_mm_movemask_ps(outside)) & 0xFu;
+	}
+}
+
+void shade::render::FrustumCulling::Reset()
+{
+	m_CenterX.clear(); m_CenterY.clear(); m_CenterZ.clear();
+	m_ExtentX.clear(); m_ExtentY.clear(); m_ExtentZ.clear();
+	m_Visible.clear(); m_IsVisible.clear();
+	m_Count = 0;
+}
+
+std::uint32_t shade::render::FrustumCulling::Add(const glm::mat4& transform, const glm::vec3& minHalfExt, const glm::vec3& maxHalfExt)
+{
+	glm::vec3 minExt, maxExt; ToWorldBox(transform, minHalfExt, maxHalfExt, minExt, maxExt);
+	return Add(minExt, maxExt);
+}
+
+std::uint32_t shade::render::FrustumCulling::Add(const glm::vec3& minExt, const glm::vec3& maxExt)
+{
+	const glm::vec3 center = (minExt + maxExt) * 0.5f, extent = (maxExt - minExt) * 0.5f;
+
+	m_CenterX.emplace_back(center.x); m_CenterY.emplace_back(center.y); m_CenterZ.emplace_back(center.z);
+	m_ExtentX.emplace_back(extent.x); m_ExtentY.emplace_back(extent.y); m_ExtentZ.emplace_back(extent.z);
+
+	return m_Count++;
+}
+
+void shade::render::FrustumCulling::ToWorldBox(const glm::mat4& transform, const glm::vec3& minHalfExt, const glm::vec3& maxHalfExt, glm::vec3& minExt, glm::vec3& maxExt)
+{
+	const glm::vec3 center = glm::vec3(transform * glm::vec4((minHalfExt + maxHalfExt) * 0.5f, 1.f));
+	const glm::vec3 halfSize = (maxHalfExt - minHalfExt) * 0.5f;
+
+	// Extent of box rotated and scaled by transform projected to world axes
+	const glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * halfSize.x + glm::abs(glm::vec3(transform[1])) * halfSize.y + glm::abs(glm::vec3(transform[2])) * halfSize.z;
+
+	minExt = center - extent; maxExt = center + extent;
+}
+
+const std::vector<std::uint32_t>& shade::render::FrustumCulling::Cull(const CameraFrustum& frustum)
+{
+	const std::uint32_t padded = (m_Count + 3u) & ~3u;
+
+	m_CenterX.resize(padded, 0.f); m_CenterY.resize(padded, 0.f); m_CenterZ.resize(padded, 0.f);
+	m_ExtentX.resize(padded, 0.f); m_ExtentY.resize(padded, 0.f); m_ExtentZ.resize(padded, 0.f);
+
+	m_Visible.clear(); m_Visible.reserve(m_Count);
+	m_IsVisible.assign(m_Count, 0u);
+
+	const Planes planes = BroadcastPlanes(frustum);
+
+	for (std::uint32_t i = 0; i < padded; i += 4u)
+	{
+		// Padding lanes are dropped
+		const std::uint32_t lanes = std::min(m_Count - i, 4u);
+		std::uint32_t visible = InsideMask(planes,
+			_mm_loadu_ps(&m_CenterX[i]), _mm_loadu_ps(&m_CenterY[i]), _mm_loadu_ps(&m_CenterZ[i]),
+			_mm_loadu_ps(&m_ExtentX[i]), _mm_loadu_ps(&m_ExtentY[i]), _mm_loadu_ps(&m_ExtentZ[i])) & ((1u << lanes) - 1u);
+
+		while (visible)
+		{
+			const std::uint32_t index = i + static_cast<std::uint32_t>(std::countr_zero(visible));
+			m_Visible.emplace_back(index); m_IsVisible[index] = 1u;
+			visible &= visible - 1u;
+		}
+	}
+
+	return m_Visible;
+}
+
+const std::vector<std::uint32_t>& shade::render::FrustumCulling::Cull(const CameraFrustum& frustum, const std::vector<std::uint32_t>& candidates)
+{
+	m_Visible.clear(); m_Visible.reserve(candidates.size());
+	m_IsVisible.assign(m_Count, 0u);
+
+	const Planes planes = BroadcastPlanes(frustum);
+	const std::uint32_t count = static_cast<std::uint32_t>(candidates.size());
+
+	for (std::uint32_t i = 0; i < count; i += 4u)
+	{
+		// Candidates are scattered, so lanes are gathered, last group repeats its last candidate
+		const std::uint32_t lanes = std::min(count - i, 4u);
+		const std::uint32_t a = candidates[i], b = candidates[i + std::min(1u, lanes - 1u)], c = candidates[i + std::min(2u, lanes - 1u)], d = candidates[i + lanes - 1u];
+
+		std::uint32_t visible = InsideMask(planes,
+			_mm_setr_ps(m_CenterX[a], m_CenterX[b], m_CenterX[c], m_CenterX[d]), _mm_setr_ps(m_CenterY[a], m_CenterY[b], m_CenterY[c], m_CenterY[d]), _mm_setr_ps(m_CenterZ[a], m_CenterZ[b], m_CenterZ[c], m_CenterZ[d]),
+			_mm_setr_ps(m_ExtentX[a], m_ExtentX[b], m_ExtentX[c], m_ExtentX[d]), _mm_setr_ps(m_ExtentY[a], m_ExtentY[b], m_ExtentY[c], m_ExtentY[d]), _mm_setr_ps(m_ExtentZ[a], m_ExtentZ[b], m_ExtentZ[c], m_ExtentZ[d])) & ((1u << lanes) - 1u);
+
+		while (visible)
+		{
+			const std::uint32_t index = candidates[i + static_cast<std::uint32_t>(std::countr_zero(visible))];
+			m_Visible.emplace_back(index); m_IsVisible[index] = 1u;
+			visible &= visible - 1u;
+		}
+	}
+
+	// Keep the same ascending order as full pass produces
+	std::sort(m_Visible.begin(), m_Visible.end());
+
+	return m_Visible;
+}
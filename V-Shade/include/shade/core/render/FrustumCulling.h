@@ -0,0 +1,50 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/camera/CameraFrustum.h>
+
+namespace shade
+{
+	namespace render
+	{
+		// Culling stage, world space bounds of all submitted meshes are gathered first and tested against camera frustum in one batch
+		class SHADE_API FrustumCulling
+		{
+		public:
+			FrustumCulling() = default;
+			~FrustumCulling() = default;
+		public:
+			// Remove all bounds, call it once per frame before gathering
+			void Reset();
+
+			// Add oriented box of mesh, it's kept as world space axis aligned box which encloses it
+			// Returns index of the bounds, the same index is used to check visibility
+			std::uint32_t Add(const glm::mat4& transform, const glm::vec3& minHalfExt, const glm::vec3& maxHalfExt);
+			// Add world space axis aligned box
+			std::uint32_t Add(const glm::vec3& minExt, const glm::vec3& maxExt);
+
+			// Test all bounds against six frustum planes, 4 boxes per iteration
+			// Returns compact list of visible bounds indices in ascending order
+			const std::vector<std::uint32_t>& Cull(const CameraFrustum& frustum);
+			// Test only candidates, for example those which are reported by scene hierarchy, the rest is treated as culled
+			const std::vector<std::uint32_t>& Cull(const CameraFrustum& frustum, const std::vector<std::uint32_t>& candidates);
+
+			// World space axis aligned box which encloses oriented box of mesh
+			static void ToWorldBox(const glm::mat4& transform, const glm::vec3& minHalfExt, const glm::vec3& maxHalfExt, glm::vec3& minExt, glm::vec3& maxExt);
+
+			SHADE_INLINE bool IsVisible(std::uint32_t index) const { return m_IsVisible[index]; }
+
+			SHADE_INLINE const std::vector<std::uint32_t>& GetVisible() const { return m_Visible; }
+			SHADE_INLINE std::uint32_t GetCount() const { return m_Count; }
+			SHADE_INLINE std::uint32_t GetVisibleCount() const { return static_cast<std::uint32_t>(m_Visible.size()); }
+			SHADE_INLINE std::uint32_t GetCulledCount() const { return m_Count - GetVisibleCount(); }
+		private:
+			// SoA bounds, arrays are padded to multiple of 4 so kernel never reads past the end
+			std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+			std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+			std::uint32_t m_Count = 0;
+
+			std::vector<std::uint32_t> m_Visible;
+			std::vector<std::uint8_t>  m_IsVisible;
+		};
+	}
+}
@@ -0,0 +1,148 @@
+#include "shade_pch.h"
+#include "GeometryResidency.h"
+
+shade::render::GeometryResidency::GeometryResidency(const Settings& settings) :
+	m_Settings(settings)
+{
+}
+
+const shade::render::GeometryBuffer& shade::render::GeometryResidency::Request(std::size_t key, const Drawable& drawable, std::size_t lod)
+{
+	assert(lod < Drawable::MAX_LEVEL_OF_DETAIL && "Level of detail is out of range !");
+
+	Entry& entry = m_Entries[key];
+
+	// Hash is pointer based, so different drawable at the same address drops what was uploaded before
+	if (entry.pSource != &drawable)
+	{
+		for (std::size_t i = 0; i < Drawable::MAX_LEVEL_OF_DETAIL; ++i)
+			if (entry.Lods[i].IsResident) Evict(entry, i);
+
+		entry.pSource = &drawable;
+	}
+
+	Lod& current = entry.Lods[lod];
+	const Drawable::Lod& geometry = drawable.GetLod(lod);
+
+	if (current.IsResident && (current.VerticesCount != geometry.Vertices.size() || current.IndicesCount != geometry.Indices.size()))
+		Evict(entry, lod);
+
+	if (!current.IsResident)
+		Upload(entry, drawable, lod);
+
+	current.LastUsedFrame = m_Frame;
+	return current.Buffer;
+}
+
+const shade::render::GeometryBuffer& shade::render::GeometryResidency::Get(std::size_t key, std::size_t lod) const
+{
+	assert(IsResident(key, lod) && "Geometry is not resident !");
+	return m_Entries.at(key).Lods[lod].Buffer;
+}
+
+bool shade::render::GeometryResidency::IsResident(std::size_t key, std::size_t lod) const
+{
+	auto entry = m_Entries.find(key);
+	return entry != m_Entries.end() && entry->second.Lods[lod].IsResident;
+}
+
+void shade::render::GeometryResidency::Collect()
+{
+	struct Candidate
+	{
+		std::uint64_t LastUsedFrame; std::size_t Key; std::size_t Lod;
+	};
+	std::vector<Candidate> candidates;
+
+	for (auto& [key, entry] : m_Entries)
+	{
+		for (std::size_t lod = 0; lod < Drawable::MAX_LEVEL_OF_DETAIL; ++lod)
+		{
+			Lod& current = entry.Lods[lod];
+			if (!current.IsResident || current.LastUsedFrame == m_Frame)
+				continue;
+
+			// Geometry which was out of view for a short while stays resident
+			if (m_Frame - current.LastUsedFrame > m_Settings.GracePeriod)
+				Evict(entry, lod);
+			else
+				candidates.emplace_back(Candidate{ current.LastUsedFrame, key, lod });
+		}
+	}
+
+	if (m_Statistic.ResidentBytes > m_Settings.BudgetBytes)
+	{
+		// Geometry used in current frame is never evicted, so budget can be exceeded by it
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.LastUsedFrame < b.LastUsedFrame; });
+
+		for (const Candidate& candidate : candidates)
+		{
+			if (m_Statistic.ResidentBytes <= m_Settings.BudgetBytes)
+				break;
+
+			Evict(m_Entries.at(candidate.Key), candidate.Lod);
+		}
+	}
+
+	for (auto entry = m_Entries.begin(); entry != m_Entries.end();)
+	{
+		if (!entry->second.ResidentLods)
+			entry = m_Entries.erase(entry);
+		else
+			++entry;
+	}
+
+	m_Statistic.ResidentDrawables = static_cast<std::uint32_t>(m_Entries.size());
+	m_Frame++;
+}
+
+void shade::render::GeometryResidency::Clear()
+{
+	m_Entries.clear();
+	m_Statistic.ResidentBytes = 0u; m_Statistic.ResidentDrawables = 0u; m_Statistic.ResidentLods = 0u;
+}
+
+void shade::render::GeometryResidency::Upload(Entry& entry, const Drawable& drawable, std::size_t lod)
+{
+	Lod& current = entry.Lods[lod];
+	const Drawable::Lod& geometry = drawable.GetLod(lod);
+
+	current.VerticesCount	= geometry.Vertices.size();
+	current.IndicesCount	= geometry.Indices.size();
+	current.Bytes			= 0u;
+
+	if (geometry.Vertices.size() && geometry.Indices.size())
+	{
+		current.Bytes = VERTICES_DATA_SIZE(geometry.Vertices.size()) + INDICES_DATA_SIZE(geometry.Indices.size()) + ((geometry.Bones.size()) ? BONES_DATA_SIZE(geometry.Bones.size()) : 0u);
+
+		if (!m_Settings.CPUAccounting)
+		{
+			// Create a vertex buffer for the drawable object's vertices
+			current.Buffer.VB = VertexBuffer::Create(VertexBuffer::Usage::GPU, VERTICES_DATA_SIZE(geometry.Vertices.size()), 0, geometry.Vertices.data());
+			// Create an index buffer for the drawable object's indices
+			current.Buffer.IB = IndexBuffer::Create(IndexBuffer::Usage::GPU, INDICES_DATA_SIZE(geometry.Indices.size()), 0, geometry.Indices.data());
+
+			if (geometry.Bones.size())
+				current.Buffer.BW = VertexBuffer::Create(VertexBuffer::Usage::GPU, BONES_DATA_SIZE(geometry.Bones.size()), 0, geometry.Bones.data());
+		}
+
+		m_Statistic.Uploads++;
+	}
+
+	current.IsResident = true;
+	entry.ResidentLods++;
+	m_Statistic.ResidentLods++;
+	m_Statistic.ResidentBytes += current.Bytes;
+}
+
+void shade::render::GeometryResidency::Evict(Entry& entry, std::size_t lod)
+{
+	Lod& current = entry.Lods[lod];
+
+	m_Statistic.ResidentBytes -= current.Bytes;
+	m_Statistic.ResidentLods--;
+	m_Statistic.Evictions++;
+	entry.ResidentLods--;
+
+	current = Lod{};
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/render/drawable/Drawable.h>
+#include <shade/core/render/buffers/VertexBuffer.h>
+#include <shade/core/render/buffers/IndexBuffer.h>
+#include <ankerl/unordered_dense.h>
+
+namespace shade
+{
+	namespace render
+	{
+		struct GeometryBuffer
+		{
+			// Vertices.
+			SharedPointer<VertexBuffer> VB;
+			// Indices.
+			SharedPointer<IndexBuffer>  IB;
+			// Bones&Weights
+			SharedPointer<VertexBuffer> BW;
+		};
+
+		// Keeps geometry buffers of drawables resident across frames, only requested levels of detail are uploaded
+		// Level of detail is evicted when it hasn't been used within grace period, or least recently used first while over budget
+		class SHADE_API GeometryResidency
+		{
+		public:
+			struct Settings
+			{
+				std::size_t		BudgetBytes		= 512u * 1024u * 1024u;
+				// In frames
+				std::uint32_t	GracePeriod		= 240u;
+				// Only account memory without creating buffers, so residency can be used without GPU
+				bool			CPUAccounting	= false;
+			};
+			struct Statistic
+			{
+				std::size_t		ResidentBytes		= 0u;
+				std::uint32_t	ResidentDrawables	= 0u;
+				std::uint32_t	ResidentLods		= 0u;
+				// Since creation
+				std::uint64_t	Uploads				= 0u;
+				std::uint64_t	Evictions			= 0u;
+			};
+		public:
+			GeometryResidency(const Settings& settings = Settings{});
+			~GeometryResidency() = default;
+		public:
+			// Make level of detail resident and mark it as used in current frame, key is drawable hash
+			const GeometryBuffer& Request(std::size_t key, const Drawable& drawable, std::size_t lod);
+			// Level of detail must be requested in current frame
+			const GeometryBuffer& Get(std::size_t key, std::size_t lod) const;
+			bool IsResident(std::size_t key, std::size_t lod) const;
+
+			// Evict expired and over budget geometry and start new frame, call once per frame after all submissions
+			void Collect();
+			void Clear();
+
+			SHADE_INLINE Settings& GetSettings() { return m_Settings; }
+			SHADE_INLINE const Settings& GetSettings() const { return m_Settings; }
+			SHADE_INLINE const Statistic& GetStatistic() const { return m_Statistic; }
+			SHADE_INLINE std::uint64_t GetFrame() const { return m_Frame; }
+		private:
+			struct Lod
+			{
+				GeometryBuffer	Buffer;
+				std::size_t		Bytes = 0u;
+				// Counts which were uploaded, geometry is uploaded again when drawable has changed
+				std::size_t		VerticesCount = 0u, IndicesCount = 0u;
+				std::uint64_t	LastUsedFrame = 0u;
+				bool			IsResident = false;
+			};
+			struct Entry
+			{
+				std::array<Lod, Drawable::MAX_LEVEL_OF_DETAIL> Lods;
+				const Drawable* pSource = nullptr;
+				std::uint32_t ResidentLods = 0u;
+			};
+			ankerl::unordered_dense::map<std::size_t, Entry> m_Entries;
+			Settings		m_Settings;
+			Statistic		m_Statistic;
+			std::uint64_t	m_Frame = 1u;
+		private:
+			void Upload(Entry& entry, const Drawable& drawable, std::size_t lod);
+			void Evict(Entry& entry, std::size_t lod);
+		};
+	}
+}
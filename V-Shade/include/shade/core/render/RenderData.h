@@ -2,6 +2,8 @@
 #include <shade/core/render/drawable/Drawable.h>
 #include <shade/core/render/drawable/Material.h>
 #include <shade/core/render/buffers/VertexBuffer.h>
+#include <shade/core/render/GeometryResidency.h>
+#include <shade/core/render/DrawKey.h>
 #include <shade/core/render/buffers/IndexBuffer.h>
 #include <shade/core/render/buffers/StorageBuffer.h>
 #include <shade/core/render/buffers/UniformBuffer.h>
@@ -12,37 +14,6 @@ namespace shade
 {
 	namespace render
 	{
-		//template<typename... Args>
-		//struct PointerHashCombined
-		//{
-		//	std::size_t operator()(Args&&... args) const noexcept
-		//	{
-		//		//return (std::hash<std::decay_t<Args>>()(std::forward<Args>(args)) ^ ...);
-		//		return (std::decay_t<Args>(std::forward<Args>(args)) ^ ...);
-		//	}
-		//};
-
-		// Create combination of pointers
-		// To use this function make sure that your class represents operator std::size_t
-		template<typename... Args>
-		std::size_t PointerHashCombine(Args&&... args)
-		{
-			return (static_cast<std::size_t>(std::decay_t<Args>(std::forward<Args>(args))) ^ ...);
-			//return (std::hash<std::decay_t<Args>>{}(std::forward<Args>(args)) ^ ...);
-		}
-
-		//template<typename... Args>
-		//std::size_t PointerHashCombine(Args&&... args)
-		//{
-		//	std::size_t seed = 0;  //   
-
-		//	//  glm::detail::hash_combine   
-		//	(glm::detail::hash_combine(seed, static_cast<std::size_t>(std::decay_t<Args>(std::forward<Args>(args)))), ...);
-
-		//	return seed;
-		//}
-
-
 		// Cast hash to pointer.
 		// IMPORTANT: To use make sure that you 'hash' is the right pointer address.
 		// IMPORTANT: Doesn't work for SharedPointer since it has mix between ponter and time stamp!
@@ -77,16 +48,6 @@ namespace shade
 			ankerl::unordered_dense::map<std::size_t, MaterialModelPair> Instances;
 		};
 
-		struct GeometryBuffer
-		{
-			// Vertices.
-			SharedPointer<VertexBuffer> VB;
-			// Indices.
-			SharedPointer<IndexBuffer>  IB;
-			// Bones&Weights
-			SharedPointer<VertexBuffer> BW;
-		};
-
 		struct InstanceRawData
 		{
 			// Transform per unique instance encounter, combination of (Pipeline, Drawable, Material).
@@ -102,20 +63,37 @@ namespace shade
 		struct BoneSubmitedMetaData
 		{
 			// Bone transform per unique pipeline
-			std::vector<SharedPointer<std::vector<animation::Pose::GlobalTransform>>> BoneTransforms;
+			// Points into pose arena, valid until next animation frame
+			std::vector<const animation::Pose::GlobalTransform*> BoneTransforms;
 			// Offset within unique pipeline + model.
 			std::uint32_t PipelineModelOffset = 0;
 		};
+		struct InstanceStaging
+		{
+			// Linear arenas which are packed in one pass and uploaded with one copy per buffer, capacity is kept between frames
+			std::vector<glm::mat4>							Transforms;
+			std::vector<Material::RenderData>				Materials;
+			std::vector<animation::Pose::GlobalTransform>	BoneTransforms;
+		};
 		struct SubmitedSceneRenderData
 		{
-			// Where size_t is Asset<Drawable> hash - > Geometry buffers
-			ankerl::unordered_dense::map<std::size_t, std::array<render::GeometryBuffer, Drawable::MAX_LEVEL_OF_DETAIL>> GeometryBuffers;
-			// Where size_t is hash of (Pipeline, Drawable, Material) - > Transforms and materials with offset.
-			ankerl::unordered_dense::map<std::size_t, InstanceRawData> InstanceRawData;
-			// Where size_t hash of Pipeline -> std::uint32_t bone transforms data per with offset
-			ankerl::unordered_dense::map<std::size_t, BoneSubmitedMetaData> BoneOffsetsData;
+			// Where key is Asset<Drawable> hash - > Geometry buffers which stay resident across frames
+			render::GeometryResidency Geometry;
+			// Dense identifiers which are packed into draw keys, registered on submit.
+			render::IdRegistry PipelineIDs	{ 1u << DrawKey::PIPELINE_BITS };
+			render::IdRegistry MaterialIDs	{ 1u << DrawKey::MATERIAL_BITS };
+			render::IdRegistry MeshIDs		{ 1u << DrawKey::MESH_BITS };
+			render::IdRegistry ModelIDs		{ ~0u };
+			// Where key is DrawKey of (Pipeline, Material, Drawable, Lod, Split) - > Transforms and materials with offset.
+			ankerl::unordered_dense::map<std::uint64_t, InstanceRawData> InstanceRawData;
+			// Where key is DrawKey::MakeModel of (Pipeline, Model) -> bone transforms data with offset
+			ankerl::unordered_dense::map<std::uint64_t, BoneSubmitedMetaData> BoneOffsetsData;
+			// Keys of submitted groups in packing order, capacity is kept between frames.
+			std::vector<std::uint64_t> SortedKeys, SortScratch;
 			// Where index is frame index.
 			std::vector<SharedPointer<VertexBuffer>> TransformBuffers;
+			// Where index is frame index.
+			std::vector<InstanceStaging> Staging;
 			SharedPointer<StorageBuffer> MaterialsBuffer;
 			SharedPointer<StorageBuffer> GlobalLightsBuffer;
 			SharedPointer<StorageBuffer> PointsLightsBuffer;
@@ -6,6 +6,36 @@
 // For BONE_TRANSFORMS DATA SIZE
 #include <shade/core/animation/Animation.h>
 
+namespace
+{
+	// Identifiers are registered on submit only, so draw and update never grow registries
+	std::uint64_t RegisterDrawKey(shade::render::SubmitedSceneRenderData& data, std::size_t pipeline, std::size_t drawable, std::size_t material, std::size_t lod, std::uint32_t splitOffset)
+	{
+		if (lod >= (1u << shade::render::DrawKey::LOD_BITS) || splitOffset >= (1u << shade::render::DrawKey::SPLIT_BITS))
+			SHADE_CORE_ERROR("Draw key field is out of range, lod = {}, split = {} !", lod, splitOffset);
+		return shade::render::DrawKey::Make(data.PipelineIDs.Register(pipeline), data.MaterialIDs.Register(material), data.MeshIDs.Register(drawable), static_cast<std::uint32_t>(lod), splitOffset);
+	}
+	// Returns false when something wasn't submitted, so there is no group for it
+	bool FindDrawKey(const shade::render::SubmitedSceneRenderData& data, std::size_t pipeline, std::size_t drawable, std::size_t material, std::size_t lod, std::uint32_t splitOffset, std::uint64_t& key)
+	{
+		const std::uint32_t pipelineID = data.PipelineIDs.Find(pipeline), materialID = data.MaterialIDs.Find(material), meshID = data.MeshIDs.Find(drawable);
+		if (pipelineID == shade::render::IdRegistry::INVALID_ID || materialID == shade::render::IdRegistry::INVALID_ID || meshID == shade::render::IdRegistry::INVALID_ID)
+			return false;
+
+		key = shade::render::DrawKey::Make(pipelineID, materialID, meshID, static_cast<std::uint32_t>(lod), splitOffset);
+		return true;
+	}
+	bool FindModelKey(const shade::render::SubmitedSceneRenderData& data, std::size_t pipeline, std::size_t model, std::uint64_t& key)
+	{
+		const std::uint32_t pipelineID = data.PipelineIDs.Find(pipeline), modelID = data.ModelIDs.Find(model);
+		if (pipelineID == shade::render::IdRegistry::INVALID_ID || modelID == shade::render::IdRegistry::INVALID_ID)
+			return false;
+
+		key = shade::render::DrawKey::MakeModel(pipelineID, modelID);
+		return true;
+	}
+}
+
 shade::UniquePointer<shade::RenderAPI> shade::Renderer::m_sRenderAPI;
 shade::UniquePointer<shade::RenderContext> shade::Renderer::m_sRenderContext;
 
@@ -55,6 +85,8 @@ void shade::Renderer::Initialize(const RenderAPI::API& api, const SystemsRequire
 		m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers.emplace_back() = VertexBuffer::Create(VertexBuffer::Usage::CPU_GPU, TRANSFORM_DATA_SIZE, 50);
 	}
 
+	m_sRenderAPI->m_sSubmitedSceneRenderData.Staging.resize(GetFramesCount());
+
 	render::Image diffuseImage; diffuseImage.GenerateDiffuseTexture();
 	m_sDefaultDiffuseTexture = Texture2D::CreateEXP(render::Image2D::Create(diffuseImage));
 	render::Image normalImage; normalImage.GenerateDiffuseTexture();
@@ -92,14 +124,24 @@ std::uint32_t shade::Renderer::GetMaxViewportsCount()
 	return m_sRenderAPI->GetMaxViewportsCount();
 }
 
+shade::render::GeometryResidency& shade::Renderer::GetGeometryResidency()
+{
+	return m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry;
+}
+
 void shade::Renderer::ShutDown()
 {
 	// clear submitted pipelines and scene rendering data
 	m_sRenderAPI->m_sSubmitedPipelines.clear();
-	m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Clear();
 	m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers.clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.Staging.clear();
 	m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.clear();
 	m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.PipelineIDs.Clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialIDs.Clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.MeshIDs.Clear();
+	m_sRenderAPI->m_sSubmitedSceneRenderData.ModelIDs.Clear();
 
 	m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialsBuffer			= nullptr;
 	m_sRenderAPI->m_sSubmitedSceneRenderData.CameraBuffer				= nullptr;
@@ -154,86 +196,85 @@ void shade::Renderer::BeginFrame(std::uint32_t frameIndex)
 	//	}
 	//}
 
-	// Iterate over GeometryBuffers inside the object m_sSubmitedSceneRenderData.
-	for (auto drawable = m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.begin(); drawable != m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.end();)
-	{
-		// Initialize a flag called hasFound to false.
-		bool hasFound = false;
+	// Geometry which hasn't been submitted stays resident for grace period, so objects popping in and out of view aren't uploaded again
+	m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Collect();
 
-		// Iterate over m_sSubmitedPipelines.
-		for (auto& [pipeline, instances] : m_sRenderAPI->m_sSubmitedPipelines)
-		{
-			// If the Instances map inside the current pipeline contains a drawable with a matching key as the one we're currently iterating over.
-			if (instances.Instances.find(drawable->first) != instances.Instances.end())
-			{
-				// Set the hasFound flag to true.
-				hasFound = true;
-				// Break out of the loop since we already found the drawable.
-				break;
-			}
-		}
+	render::InstanceStaging& staging = m_sRenderAPI->m_sSubmitedSceneRenderData.Staging[frameIndex];
+	staging.Transforms.clear(); staging.Materials.clear(); staging.BoneTransforms.clear();
 
-		// If we couldn't find the current drawable we're iterating over, then remove it from the map.
-		if (!hasFound)
-		{
-			// Erase the current drawable from the map, and get the iterator of the next drawable.
-			drawable = m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.erase(drawable);
-		}
-		else // Otherwise, move on to the next drawable.
-		{
-			++drawable;
-		}
-	}
+	// Groups are packed in draw key order, so instances which share pipeline, material and mesh are adjacent in buffers.
+	std::vector<std::uint64_t>& sortedKeys = m_sRenderAPI->m_sSubmitedSceneRenderData.SortedKeys;
+	sortedKeys.clear();
+	for (const auto& [key, instance] : m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData)
+		if (instance.Transforms.size()) sortedKeys.emplace_back(key);
+
+	render::RadixSort(sortedKeys, m_sRenderAPI->m_sSubmitedSceneRenderData.SortScratch);
 
-	// Iterate over through all submitted transform and material data and calculate offset.
-	std::uint32_t count = 0;
-	for (auto& [hash, instance] : m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData)
+	// Pack all submitted transform and material data in one pass and calculate offsets.
+	for (const std::uint64_t key : sortedKeys)
 	{
+		render::InstanceRawData& instance = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(key)->second;
 		// Set the transform and material offsets for each instance
-		instance.TransformOffset = TRANSFORMS_DATA_SIZE(count);
-		instance.MaterialOffset = MATERIALS_DATA_SIZE(count);
+		instance.TransformOffset = TRANSFORMS_DATA_SIZE(staging.Transforms.size());
+		instance.MaterialOffset = MATERIALS_DATA_SIZE(staging.Materials.size());
 
-		for (auto i = 0; i < instance.Transforms.size(); ++i)
+		staging.Transforms.insert(staging.Transforms.end(), instance.Transforms.begin(), instance.Transforms.end());
+		staging.Materials.insert(staging.Materials.end(), instance.Materials.begin(), instance.Materials.end());
+	}
+
+	// Passes iterate submitted instances, so they are reordered by the same draw keys: materials of drawable by key, drawables by key of their first material.
+	// Drawables which start with the same material end up adjacent, so pipeline state is switched as rarely as possible.
+	render::SubmitedSceneRenderData& data = m_sRenderAPI->m_sSubmitedSceneRenderData;
+	for (auto& [pipeline, submited] : m_sRenderAPI->m_sSubmitedPipelines)
+	{
+		auto drawKey = [&](std::size_t drawable, const std::pair<std::size_t, Asset<Material>>& material)
 		{
-			// Increment the count of transforms and materials.
-			++count;
+			std::uint64_t key;
+			return FindDrawKey(data, pipeline, drawable, material.second, material.first, 0u, key) ? key : ~0ull;
+		};
+
+		auto instances = std::move(submited.Instances).extract();
+		for (auto& [drawable, instance] : instances)
+		{
+			auto materials = std::move(instance.Materials).extract();
+			std::sort(materials.begin(), materials.end(), [&](const auto& a, const auto& b) { return drawKey(drawable, a) < drawKey(drawable, b); });
+			instance.Materials.replace(std::move(materials));
 		}
+		std::sort(instances.begin(), instances.end(), [&](const auto& a, const auto& b)
+			{
+				const std::uint64_t aKey = a.second.Materials.empty() ? ~0ull : drawKey(a.first, *a.second.Materials.begin());
+				const std::uint64_t bKey = b.second.Materials.empty() ? ~0ull : drawKey(b.first, *b.second.Materials.begin());
+				return aKey < bKey;
+			});
+		submited.Instances.replace(std::move(instances));
 	}
+
 	// Resize the transform and materials buffers based on the number instances.
-	m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex]->Resize(TRANSFORMS_DATA_SIZE(count));
+	m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex]->Resize(TRANSFORMS_DATA_SIZE(staging.Transforms.size()));
 	// Should be at least size 1
-	m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialsBuffer->Resize(MATERIALS_DATA_SIZE(count));
+	m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialsBuffer->Resize(MATERIALS_DATA_SIZE(staging.Materials.size()));
 
-	for (auto& [hash, instance] : m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData)
+	// One contiguous copy per buffer
+	if (staging.Transforms.size())
 	{
-		// Set the transform and material data for each instance in the buffers
-		m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex]->SetData(TRANSFORMS_DATA_SIZE(instance.Transforms.size()), instance.Transforms.data(), instance.TransformOffset);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialsBuffer->SetData(MATERIALS_DATA_SIZE(instance.Materials.size()), instance.Materials.data(), frameIndex, instance.MaterialOffset);
+		m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex]->SetData(TRANSFORMS_DATA_SIZE(staging.Transforms.size()), staging.Transforms.data(), 0);
+		m_sRenderAPI->m_sSubmitedSceneRenderData.MaterialsBuffer->SetData(MATERIALS_DATA_SIZE(staging.Materials.size()), staging.Materials.data(), frameIndex, 0);
 	}
 
-	std::uint32_t bonesCount = 0;
+	// Every submitted bone palette takes MAX_BONES_PER_INSTANCE transforms
 	for (auto& [hash, boneData] : m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData)
 	{
-		boneData.PipelineModelOffset = BONE_TRANSFORMS_DATA_SIZE(bonesCount);
+		boneData.PipelineModelOffset = BONE_TRANSFORMS_DATA_SIZE(staging.BoneTransforms.size() / RenderAPI::MAX_BONES_PER_INSTANCE);
 
-		for (auto i = 0; i < boneData.BoneTransforms.size(); ++i)
-		{
-			++bonesCount;
-		}
+		for (const animation::Pose::GlobalTransform* palette : boneData.BoneTransforms)
+			staging.BoneTransforms.insert(staging.BoneTransforms.end(), palette, palette + RenderAPI::MAX_BONES_PER_INSTANCE);
 	}
 
-	m_sRenderAPI->m_sSubmitedSceneRenderData.BoneTransfromsBuffer->Resize(BONE_TRANSFORMS_DATA_SIZE(bonesCount));
-
-	for (auto& [hash, boneData] : m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData)
-	{
-		for (std::uint32_t instance = 0; instance < boneData.BoneTransforms.size(); ++instance)
-		{
-			auto value = boneData.PipelineModelOffset + BONE_TRANSFORMS_DATA_SIZE(instance);
+	const std::size_t palettesCount = staging.BoneTransforms.size() / RenderAPI::MAX_BONES_PER_INSTANCE;
+	m_sRenderAPI->m_sSubmitedSceneRenderData.BoneTransfromsBuffer->Resize(BONE_TRANSFORMS_DATA_SIZE(palettesCount));
 
-			m_sRenderAPI->m_sSubmitedSceneRenderData.BoneTransfromsBuffer->SetData(BONE_TRANSFORM_DATA_SIZE,
-				boneData.BoneTransforms[instance]->data(), frameIndex, boneData.PipelineModelOffset + BONE_TRANSFORMS_DATA_SIZE(instance));
-		}
-	}
+	if (palettesCount)
+		m_sRenderAPI->m_sSubmitedSceneRenderData.BoneTransfromsBuffer->SetData(BONE_TRANSFORMS_DATA_SIZE(palettesCount), staging.BoneTransforms.data(), frameIndex, 0);
 }
 
 void shade::Renderer::EndFrame(std::uint32_t frameIndex)
@@ -276,9 +317,37 @@ void shade::Renderer::EndFrame(std::uint32_t frameIndex)
 
 	//}
 
-	// Clear all transform and material data.
-	m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.clear();
-	m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.clear();
+	// Clear all transform and material data, groups which were submitted keep their capacity for the next frame.
+	for (auto instance = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.begin(); instance != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end();)
+	{
+		if (instance->second.Transforms.empty())
+		{
+			instance = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.erase(instance);
+		}
+		else
+		{
+			instance->second.Transforms.clear(); instance->second.Materials.clear(); ++instance;
+		}
+	}
+	for (auto boneData = m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.begin(); boneData != m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.end();)
+	{
+		if (boneData->second.BoneTransforms.empty())
+		{
+			boneData = m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.erase(boneData);
+		}
+		else
+		{
+			boneData->second.BoneTransforms.clear(); ++boneData;
+		}
+	}
+
+	// Identifiers are never released one by one, so registries start over before any of them runs out of its field
+	render::SubmitedSceneRenderData& data = m_sRenderAPI->m_sSubmitedSceneRenderData;
+	if (data.PipelineIDs.GetCount() > data.PipelineIDs.GetCapacity() / 2u || data.MaterialIDs.GetCount() > data.MaterialIDs.GetCapacity() / 2u || data.MeshIDs.GetCount() > data.MeshIDs.GetCapacity() / 2u || data.ModelIDs.GetCount() > data.ModelIDs.GetCapacity() / 2u)
+	{
+		data.InstanceRawData.clear(); data.BoneOffsetsData.clear();
+		data.PipelineIDs.Clear(); data.MaterialIDs.Clear(); data.MeshIDs.Clear(); data.ModelIDs.Clear();
+	}
 
 	m_sSubmitedPointLightRenderData.clear();
 	m_sSubmitedSpotLightRenderData.clear();
@@ -375,34 +444,38 @@ void shade::Renderer::DrawInstanced(SharedPointer<RenderCommandBuffer>& commandB
 //DrawSubmitedInstancedAnimated
 void shade::Renderer::DrawSubmitedInstanced(SharedPointer<RenderCommandBuffer>& commandBuffer, const SharedPointer<RenderPipeline>& pipeline, std::size_t instance, std::size_t material, std::uint32_t frameIndex, std::size_t lod, std::uint32_t splitOffset)
 {
-	const std::size_t hashCombined = render::PointerHashCombine(pipeline, instance, material, lod, splitOffset);
+	std::uint64_t key;
+	if (!FindDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, instance, material, lod, splitOffset, key))
+		return;
 
-	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(hashCombined);
+	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(key);
 	
-	// In case we are iterating through split offsets this is ok when there is no entry
-	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end())
+	// In case we are iterating through split offsets this is ok when there is no entry or it's empty
+	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end() && rawData->second.Transforms.size())
 	{
 		m_sRenderAPI->DrawInstanced(commandBuffer,
-			m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.at(instance)[lod].VB,
-			m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.at(instance)[lod].IB,
+			m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Get(instance, lod).VB,
+			m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Get(instance, lod).IB,
 			m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex],
 			rawData->second.Transforms.size(), rawData->second.TransformOffset);
 	}
 }
 void shade::Renderer::DrawSubmitedInstancedAnimated(SharedPointer<RenderCommandBuffer>& commandBuffer, const SharedPointer<RenderPipeline>& pipeline, std::size_t instance, std::size_t material, std::uint32_t frameIndex, std::size_t lod, std::uint32_t splitOffset)
 {
-	const std::size_t hashCombined = render::PointerHashCombine(pipeline, instance, material, lod, splitOffset);
+	std::uint64_t key;
+	if (!FindDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, instance, material, lod, splitOffset, key))
+		return;
 
-	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(hashCombined);
+	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(key);
 
-	// In case we are iterating through split offsets this is ok when there is no entry
-	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end())
+	// In case we are iterating through split offsets this is ok when there is no entry or it's empty
+	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end() && rawData->second.Transforms.size())
 	{
 		// Draw as animated with bone data.
 		m_sRenderAPI->DrawInstancedAnimated(commandBuffer,
-			m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.at(instance)[lod].VB,
-			m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.at(instance)[lod].IB,
-			m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.at(instance)[lod].BW,
+			m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Get(instance, lod).VB,
+			m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Get(instance, lod).IB,
+			m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Get(instance, lod).BW,
 			m_sRenderAPI->m_sSubmitedSceneRenderData.TransformBuffers[frameIndex],
 			rawData->second.Transforms.size(), rawData->second.TransformOffset);
 	}
@@ -410,10 +483,13 @@ void shade::Renderer::DrawSubmitedInstancedAnimated(SharedPointer<RenderCommandB
 
 void shade::Renderer::DummyInvocation(SharedPointer<RenderCommandBuffer>& commandBuffer, const SharedPointer<RenderPipeline>& pipeline, std::size_t instance, std::size_t material, std::uint32_t frameIndex, std::size_t lod, std::uint32_t splitOffset)
 {
-	const std::size_t hashCombined = render::PointerHashCombine(pipeline, instance, material, lod, splitOffset);
-	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(hashCombined);
+	std::uint64_t key;
+	if (!FindDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, instance, material, lod, splitOffset, key))
+		return;
 
-	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end())
+	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(key);
+
+	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end() && rawData->second.Transforms.size())
 	{
 		m_sRenderAPI->DummyInvocation(commandBuffer, nullptr, nullptr, nullptr, nullptr, rawData->second.Transforms.size(), rawData->second.TransformOffset);
 	}
@@ -424,23 +500,20 @@ void shade::Renderer::SubmitStaticMesh(const SharedPointer<RenderPipeline>& pipe
 	if (pipeline->IsActive())
 	{
 		const std::size_t lod = 0;
-		// Calculates a hash value based on the pipeline, drawable, and material and stores it in a variable
-		const std::size_t combinedHash = render::PointerHashCombine(pipeline, drawable, material, lod, splitOffset);
+		// Packs identifiers of the pipeline, material, drawable, lod and split into draw key
+		const std::uint64_t key = RegisterDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, drawable, material, lod, splitOffset);
 
-		// Add transform and material to the instance raw data for the given combined hash
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Transforms.emplace_back(transform);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
+		// Add transform and material to the instance raw data for the given draw key
+		render::InstanceRawData& rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[key];
+		rawData.Transforms.emplace_back(transform);
+		rawData.Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
 
 		// Add the material and model hash to the instances for the given pipeline and drawable
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].Materials.insert({ lod, material });
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].ModelHash = (model) ? model : 0u;
 
-		// If the drawable is not already in the geometry buffers, create instanced geometry buffers for each level of detail
-		if (m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.find(drawable) == m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.end())
-		{
-			for (std::size_t i = 0; i < Drawable::MAX_LEVEL_OF_DETAIL; i++)
-				CreateInstancedGeometryBuffer(drawable, i);
-		}
+		// Only submitted level of detail is made resident
+		CreateInstancedGeometryBuffer(drawable, lod);
 	}
 }
 
@@ -449,23 +522,20 @@ void shade::Renderer::SubmitStaticMesh(const SharedPointer<RenderPipeline>& pipe
 	if (pipeline->IsActive())
 	{
 		const std::size_t lod = 0;
-		// Calculates a hash value based on the pipeline, drawable, and material and stores it in a variable
-		const std::size_t combinedHash = render::PointerHashCombine(pipeline, drawable, material, lod, splitOffset);
+		// Packs identifiers of the pipeline, material, drawable, lod and split into draw key
+		const std::uint64_t key = RegisterDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, drawable, material, lod, splitOffset);
 
-		// Add transform and material to the instance raw data for the given combined hash
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Transforms.emplace_back(transform);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
+		// Add transform and material to the instance raw data for the given draw key
+		render::InstanceRawData& rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[key];
+		rawData.Transforms.emplace_back(transform);
+		rawData.Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
 
 		// Add the material and model hash to the instances for the given pipeline and drawable
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].Materials.insert({ lod, material });
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].ModelHash = (model) ? std::size_t(model) : 0u;
 
-		// If the drawable is not already in the geometry buffers, create instanced geometry buffers for each level of detail
-		if (m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.find(drawable) == m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.end())
-		{
-			for (std::size_t i = 0; i < Drawable::MAX_LEVEL_OF_DETAIL; i++)
-				CreateInstancedGeometryBuffer(drawable, i);
-		}
+		// Only submitted level of detail is made resident
+		CreateInstancedGeometryBuffer(drawable, lod);
 	}
 }
 
@@ -474,23 +544,20 @@ void shade::Renderer::SubmitStaticMeshDynamicLOD(const SharedPointer<RenderPipel
 	if (pipeline->IsActive())
 	{
 		const std::size_t lod = m_sRenderAPI->m_sSubmitedSceneRenderData.Camera ? GetLodLevelBasedOnDistance(m_sRenderAPI->m_sSubmitedSceneRenderData.Camera, Drawable::MAX_LEVEL_OF_DETAIL, transform, glm::vec3(0), glm::vec3(0)) : 0;
-		// Calculates a hash value based on the pipeline, drawable, and material and stores it in a variable
-		const std::size_t combinedHash = render::PointerHashCombine(pipeline, drawable, material, lod, splitOffset);
+		// Packs identifiers of the pipeline, material, drawable, lod and split into draw key
+		const std::uint64_t key = RegisterDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, drawable, material, lod, splitOffset);
 
-		// Add transform and material to the instance raw data for the given combined hash
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Transforms.emplace_back(transform);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
+		// Add transform and material to the instance raw data for the given draw key
+		render::InstanceRawData& rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[key];
+		rawData.Transforms.emplace_back(transform);
+		rawData.Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
 
 		// Add the material and model hash to the instances for the given pipeline and drawable
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].Materials.insert({ lod, material });
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].ModelHash = (model) ? model : 0u;
 
-		// If the drawable is not already in the geometry buffers, create instanced geometry buffers for each level of detail
-		if (m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.find(drawable) == m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.end())
-		{
-			for (std::size_t i = 0; i < Drawable::MAX_LEVEL_OF_DETAIL; i++)
-				CreateInstancedGeometryBuffer(drawable, i);
-		}
+		// Only submitted level of detail is made resident
+		CreateInstancedGeometryBuffer(drawable, lod);
 	}
 }
 
@@ -499,23 +566,20 @@ void shade::Renderer::SubmitStaticMeshDynamicLOD(const SharedPointer<RenderPipel
 	if (pipeline->IsActive())
 	{
 		const std::size_t lod = m_sRenderAPI->m_sSubmitedSceneRenderData.Camera ? GetLodLevelBasedOnDistance(m_sRenderAPI->m_sSubmitedSceneRenderData.Camera, Drawable::MAX_LEVEL_OF_DETAIL, transform, glm::vec3(0), glm::vec3(0)) : 0;
-		// Calculates a hash value based on the pipeline, drawable, and material and stores it in a variable
-		const std::size_t combinedHash = render::PointerHashCombine(pipeline, drawable, material, lod, splitOffset);
+		// Packs identifiers of the pipeline, material, drawable, lod and split into draw key
+		const std::uint64_t key = RegisterDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, drawable, material, lod, splitOffset);
 
-		// Add transform and material to the instance raw data for the given combined hash
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Transforms.emplace_back(transform);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[combinedHash].Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
+		// Add transform and material to the instance raw data for the given draw key
+		render::InstanceRawData& rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData[key];
+		rawData.Transforms.emplace_back(transform);
+		rawData.Materials.emplace_back((material) ? material->GetRenderData() : GetDefaultMaterial()->GetRenderData());
 
 		// Add the material and model hash to the instances for the given pipeline and drawable
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].Materials.insert({ lod, material });
 		m_sRenderAPI->m_sSubmitedPipelines[pipeline].Instances[drawable].ModelHash = (model) ? std::size_t(model) : 0u;
 
-		// If the drawable is not already in the geometry buffers, create instanced geometry buffers for each level of detail
-		if (m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.find(drawable) == m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers.end())
-		{
-			for (std::size_t i = 0; i < Drawable::MAX_LEVEL_OF_DETAIL; i++)
-				CreateInstancedGeometryBuffer(drawable, i);
-		}
+		// Only submitted level of detail is made resident
+		CreateInstancedGeometryBuffer(drawable, lod);
 	}
 }
 
@@ -577,17 +641,19 @@ void shade::Renderer::SubmitLight(const SharedPointer<SpotLight>& light, const g
 	m_sRenderAPI->m_sSceneRenderData.SpotLightCount++;
 }
 
-void shade::Renderer::UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, const Asset<Drawable>& instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod)
+void shade::Renderer::UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, const Asset<Drawable>& instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod, std::uint32_t splitOffset)
 {
-	UpdateSubmitedMaterial(commandBuffer, pipeline, static_cast<std::size_t>(instance), material, frameIndex, lod);
+	UpdateSubmitedMaterial(commandBuffer, pipeline, static_cast<std::size_t>(instance), material, frameIndex, lod, splitOffset);
 }
 
-void shade::Renderer::UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod)
+void shade::Renderer::UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod, std::uint32_t splitOffset)
 {
-	// Combines the hash values of pipeline, instance, and material using a custom hash function
-	std::size_t combinedHash = render::PointerHashCombine(pipeline, instance, material, lod);
-	// Searches for the combinedHash in the map containing instance raw data
-	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(combinedHash);
+	// Every split is its own group with its own packed materials, so offset of the split which is going to be drawn is bound
+	std::uint64_t key;
+	if (!FindDrawKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, instance, material, lod, splitOffset, key))
+		return;
+	// Searches for the key in the map containing instance raw data
+	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.find(key);
 	// If the rawData is found in the map
 	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.InstanceRawData.end())
 	{
@@ -599,20 +665,23 @@ void shade::Renderer::UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>&
 	}
 }
 
-void shade::Renderer::SubmitBoneTransforms(const SharedPointer<RenderPipeline>& pipeline, const Asset<Model>& instance, const SharedPointer<std::vector<animation::Pose::GlobalTransform>>& transform)
+void shade::Renderer::SubmitBoneTransforms(const SharedPointer<RenderPipeline>& pipeline, const Asset<Model>& instance, const animation::Pose::GlobalTransform* transform)
 {
 	if (pipeline->IsActive())
 	{
-		std::size_t combinedHash = render::PointerHashCombine(pipeline, instance);
-		m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData[combinedHash].BoneTransforms.emplace_back(transform);
+		const std::uint64_t key = render::DrawKey::MakeModel(m_sRenderAPI->m_sSubmitedSceneRenderData.PipelineIDs.Register(pipeline), m_sRenderAPI->m_sSubmitedSceneRenderData.ModelIDs.Register(instance));
+		m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData[key].BoneTransforms.emplace_back(transform);
 		//m_sRenderAPI->m_sSubmitedSceneRenderData.BoneTransfromsBuffer->SetData;
 	}
 }
 
 void shade::Renderer::UpdateSubmitedBonesData(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t modelInstance, std::uint32_t frameIndex)
 {
-	std::size_t combinedHash = render::PointerHashCombine(pipeline, modelInstance);
-	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.find(combinedHash);
+	std::uint64_t key;
+	if (!FindModelKey(m_sRenderAPI->m_sSubmitedSceneRenderData, pipeline, modelInstance, key))
+		return;
+
+	auto rawData = m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.find(key);
 	if (rawData != m_sRenderAPI->m_sSubmitedSceneRenderData.BoneOffsetsData.end())
 	{
 		// TODO: !!!!!!   ,         
@@ -688,45 +757,12 @@ const shade::PointLight::RenderData& shade::Renderer::GetSubmitedPointLightRende
 void shade::Renderer::CreateInstancedGeometryBuffer(const Asset<Drawable>& drawable, std::size_t lod)
 {
 	if (drawable)
-	{
-		// Get the geometry buffer of the current drawable object
-		auto& buffer = m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers[drawable];
-
-		const auto& vertices = drawable->GetLod((lod) ? lod : 0).Vertices;
-		const auto& indices = drawable->GetLod((lod) ? lod : 0).Indices;
-		const auto& bones = drawable->GetLod((lod) ? lod : 0).Bones;
-
-		if (vertices.size() && indices.size())
-		{
-			// Create a vertex buffer for the drawable object's vertices
-			buffer[lod].VB = VertexBuffer::Create(VertexBuffer::Usage::GPU, VERTICES_DATA_SIZE(vertices.size()), 0, vertices.data());
-			// Create an index buffer for the drawable object's indices
-			buffer[lod].IB = IndexBuffer::Create(IndexBuffer::Usage::GPU, INDICES_DATA_SIZE(indices.size()), 0, indices.data());
-
-			if (bones.size())
-				buffer[lod].BW = VertexBuffer::Create(VertexBuffer::Usage::GPU, BONES_DATA_SIZE(bones.size()), 0, bones.data());
-		}
-	}
+		m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Request(drawable, *drawable, lod);
 }
 
 void shade::Renderer::CreateInstancedGeometryBuffer(const SharedPointer<Drawable>& drawable, std::size_t lod)
 {
-	// Get the geometry buffer of the current drawable object
-	auto& buffer = m_sRenderAPI->m_sSubmitedSceneRenderData.GeometryBuffers[drawable];
-
-	const auto& vertices	= drawable->GetLod((lod) ? lod : 0).Vertices;
-	const auto& indices		= drawable->GetLod((lod) ? lod : 0).Indices;
-	const auto& bones		= drawable->GetLod((lod) ? lod : 0).Bones;
-
-	if (vertices.size() && indices.size())
-	{
-		// Create a vertex buffer for the drawable object's vertices
-		buffer[lod].VB = VertexBuffer::Create(VertexBuffer::Usage::GPU, VERTICES_DATA_SIZE(vertices.size()), 0, vertices.data());
-		// Create an index buffer for the drawable object's indices
-		buffer[lod].IB = IndexBuffer::Create(IndexBuffer::Usage::GPU, INDICES_DATA_SIZE(indices.size()), 0, indices.data());
-
-		if (bones.size())
-			buffer[lod].BW = VertexBuffer::Create(VertexBuffer::Usage::GPU, BONES_DATA_SIZE(bones.size()), 0, bones.data());
-	}
+	if (drawable)
+		m_sRenderAPI->m_sSubmitedSceneRenderData.Geometry.Request(drawable, *drawable, lod);
 }
 
@@ -62,10 +62,10 @@ namespace shade
 		static void SubmitLight(const SharedPointer<SpotLight>& light, const glm::mat4& transform, const SharedPointer<Camera>& camera);
 		static void SubmitLight(const SharedPointer<PointLight>& light, const glm::mat4& transform, const SharedPointer<Camera>& camera);
 		
-		static void UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, const Asset<Drawable>& instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod = 0);
-		static void UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod = 0);
+		static void UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, const Asset<Drawable>& instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod = 0, std::uint32_t splitOffset = 0);
+		static void UpdateSubmitedMaterial(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t instance, const Asset<Material>& material, std::uint32_t frameIndex, std::size_t lod = 0, std::uint32_t splitOffset = 0);
 		
-		static void SubmitBoneTransforms(const SharedPointer<RenderPipeline>& pipeline, const Asset<Model>& instance, const SharedPointer<std::vector<animation::Pose::GlobalTransform>>& transform);
+		static void SubmitBoneTransforms(const SharedPointer<RenderPipeline>& pipeline, const Asset<Model>& instance, const animation::Pose::GlobalTransform* transform);
 		static void UpdateSubmitedBonesData(SharedPointer<RenderCommandBuffer>& commandBuffer, SharedPointer<RenderPipeline> pipeline, std::size_t modelInstance, std::uint32_t frameIndex);
 
 		static const SpotLight::RenderData& GetSubmitedSpotLightRenderData(std::uint32_t lightIndex);
@@ -90,9 +90,12 @@ namespace shade
 
 		static std::uint32_t GetMaxImageLayers();
 		static std::uint32_t GetMaxViewportsCount();
+
+		static render::GeometryResidency& GetGeometryResidency();
 	protected:
 
 	private:
+		// Make level of detail resident, geometry is uploaded only once and kept till residency evicts it
 		void static CreateInstancedGeometryBuffer(const Asset<Drawable>& drawable, std::size_t lod = 0);
 		void static CreateInstancedGeometryBuffer(const SharedPointer<Drawable>& drawable, std::size_t lod = 0);
 	private:
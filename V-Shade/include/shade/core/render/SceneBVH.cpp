@@ -0,0 +1,109 @@
+#include "shade_pch.h"
+#include "SceneBVH.h"
+
+shade::render::SceneBVH::SceneBVH(float margin) :
+	m_Tree(static_cast<physic::scalar_t>(margin))
+{
+}
+
+void shade::render::SceneBVH::BeginFrame()
+{
+	m_Stamp++; m_Statistic.Refitted = 0u; m_Statistic.Removed = 0u;
+}
+
+void shade::render::SceneBVH::Update(Key key, const glm::vec3& minExt, const glm::vec3& maxExt, std::uint32_t payload)
+{
+	const physic::AABB box = { glm::vec<3, physic::scalar_t>(minExt), glm::vec<3, physic::scalar_t>(maxExt) };
+
+	auto slot = m_Slots.find(key);
+	if (slot != m_Slots.end())
+	{
+		Leaf& leaf = m_Leafs[slot->second];
+		leaf.Payload = payload; leaf.Stamp = m_Stamp;
+
+		// Tree is touched only when bounds have changed, fat box mostly absorbs small movements
+		if (leaf.MinExt != minExt || leaf.MaxExt != maxExt)
+		{
+			leaf.MinExt = minExt; leaf.MaxExt = maxExt;
+			m_Tree.UpdateProxy(leaf.Proxy, box, slot->second);
+			m_Statistic.Refitted++;
+		}
+	}
+	else
+	{
+		std::uint32_t index;
+		if (!m_FreeLeafs.empty())
+		{
+			index = m_FreeLeafs.back(); m_FreeLeafs.pop_back();
+		}
+		else
+		{
+			index = static_cast<std::uint32_t>(m_Leafs.size()); m_Leafs.emplace_back();
+		}
+
+		m_Leafs[index] = Leaf{ m_Tree.CreateProxy(box, index), minExt, maxExt, payload, m_Stamp };
+		m_Slots.emplace(key, index);
+		m_Statistic.Refitted++;
+	}
+}
+
+void shade::render::SceneBVH::EndFrame()
+{
+	// Remove bounds of destroyed entities or meshes
+	for (auto slot = m_Slots.begin(); slot != m_Slots.end();)
+	{
+		if (m_Leafs[slot->second].Stamp != m_Stamp)
+		{
+			m_Tree.DestroyProxy(m_Leafs[slot->second].Proxy);
+			m_FreeLeafs.emplace_back(slot->second);
+			slot = m_Slots.erase(slot);
+			m_Statistic.Removed++;
+		}
+		else
+		{
+			++slot;
+		}
+	}
+
+	m_Statistic.LeafsCount = static_cast<std::uint32_t>(m_Slots.size());
+}
+
+bool shade::render::SceneBVH::IsBoxInFrustum(const std::array<glm::vec4, 6>& planes, const glm::vec3& minExt, const glm::vec3& maxExt)
+{
+	const glm::vec3 center = (minExt + maxExt) * 0.5f, extent = (maxExt - minExt) * 0.5f;
+
+	for (const glm::vec4& plane : planes)
+	{
+		// Box is outside when whole of it is behind any plane
+		if (glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), extent) < 0.f)
+			return false;
+	}
+
+	return true;
+}
+
+bool shade::render::SceneBVH::IsBoxInSphere(const glm::vec3& center, float radius, const glm::vec3& minExt, const glm::vec3& maxExt)
+{
+	const glm::vec3 difference = glm::clamp(center, minExt, maxExt) - center;
+	return glm::dot(difference, difference) <= radius * radius;
+}
+
+bool shade::render::SceneBVH::IsBoxInCone(const glm::vec3& apex, const glm::vec3& direction, float length, float radius, const glm::vec3& minExt, const glm::vec3& maxExt)
+{
+	// Box is approximated by its bounding sphere, so the test is conservative
+	const glm::vec3 center = (minExt + maxExt) * 0.5f;
+	const float sphereRadius = glm::length(maxExt - minExt) * 0.5f;
+
+	const glm::vec3 toCenter = center - apex;
+	const float alongAxis = glm::dot(toCenter, direction);
+
+	if (alongAxis > length + sphereRadius || alongAxis < -sphereRadius)
+		return false;
+
+	const float angle = glm::atan(radius, length);
+	const float toAxis = glm::sqrt(glm::max(glm::dot(toCenter, toCenter) - alongAxis * alongAxis, 0.f));
+	// Distance from sphere center to cone surface
+	const float distance = glm::cos(angle) * toAxis - glm::sin(angle) * alongAxis;
+
+	return distance <= sphereRadius;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+#include <shade/core/entity/Common.h>
+#include <shade/core/camera/CameraFrustum.h>
+#include <shade/core/physics/broadphase/DynamicAABBTree.h>
+
+namespace shade
+{
+	namespace render
+	{
+		// Bounding volume hierarchy over world space bounds of scene renderables or lights
+		// Bounds are keyed, so only those which changed since last frame are refitted in the tree
+		class SHADE_API SceneBVH
+		{
+		public:
+			using Key = std::uint64_t;
+
+			struct Statistic
+			{
+				std::uint32_t LeafsCount	= 0;
+				// Bounds which changed during last frame
+				std::uint32_t Refitted		= 0;
+				std::uint32_t Removed		= 0;
+			};
+		public:
+			SceneBVH(float margin = 0.1f);
+			~SceneBVH() = default;
+		public:
+			SHADE_INLINE static Key MakeKey(ecs::EntityID entity, std::uint32_t index = 0u) { return (static_cast<Key>(entity) << 32u) | static_cast<Key>(index); }
+
+			// Start new frame, all bounds which are not updated till EndFrame are removed
+			void BeginFrame();
+			// Insert or refit bounds, payload is passed back to query function
+			void Update(Key key, const glm::vec3& minExt, const glm::vec3& maxExt, std::uint32_t payload);
+			void EndFrame();
+
+			template<typename Function>
+			void QueryFrustum(const CameraFrustum& frustum, Function function) const;
+			template<typename Function>
+			void QuerySphere(const glm::vec3& center, float radius, Function function) const;
+			// Cone goes from apex along normalized direction, radius is radius of its base
+			template<typename Function>
+			void QueryCone(const glm::vec3& apex, const glm::vec3& direction, float length, float radius, Function function) const;
+
+			SHADE_INLINE const Statistic& GetStatistic() const { return m_Statistic; }
+		public:
+			static bool IsBoxInFrustum(const std::array<glm::vec4, 6>& planes, const glm::vec3& minExt, const glm::vec3& maxExt);
+			static bool IsBoxInSphere(const glm::vec3& center, float radius, const glm::vec3& minExt, const glm::vec3& maxExt);
+			static bool IsBoxInCone(const glm::vec3& apex, const glm::vec3& direction, float length, float radius, const glm::vec3& minExt, const glm::vec3& maxExt);
+		private:
+			struct Leaf
+			{
+				physic::BroadPhase::ProxyID Proxy = physic::BroadPhase::NULL_PROXY;
+				// Exact bounds, tree keeps fattened ones
+				glm::vec3		MinExt = glm::vec3(0.f), MaxExt = glm::vec3(0.f);
+				std::uint32_t	Payload = 0u;
+				std::uint32_t	Stamp = 0u;
+			};
+			physic::DynamicAABBTree					m_Tree;
+			std::unordered_map<Key, std::uint32_t>	m_Slots;
+			std::vector<Leaf>						m_Leafs;
+			std::vector<std::uint32_t>				m_FreeLeafs;
+			std::uint32_t							m_Stamp = 0u;
+			Statistic								m_Statistic;
+		private:
+			template<typename Test, typename Function>
+			void Query(Test test, Function function) const;
+		};
+
+		template<typename Test, typename Function>
+		inline void SceneBVH::Query(Test test, Function function) const
+		{
+			// Subtrees are rejected by fattened boxes, leafs are confirmed by exact ones
+			m_Tree.Traverse([&test](const physic::AABB& box) { return test(glm::vec3(box.Min), glm::vec3(box.Max)); },
+				[&](std::uint32_t slot)
+				{
+					const Leaf& leaf = m_Leafs[slot];
+					if (test(leaf.MinExt, leaf.MaxExt))
+						function(leaf.Payload);
+				});
+		}
+
+		template<typename Function>
+		inline void SceneBVH::QueryFrustum(const CameraFrustum& frustum, Function function) const
+		{
+			const std::array<glm::vec4, 6>& planes = frustum.GetSides();
+			Query([&planes](const glm::vec3& minExt, const glm::vec3& maxExt) { return IsBoxInFrustum(planes, minExt, maxExt); }, function);
+		}
+
+		template<typename Function>
+		inline void SceneBVH::QuerySphere(const glm::vec3& center, float radius, Function function) const
+		{
+			Query([&](const glm::vec3& minExt, const glm::vec3& maxExt) { return IsBoxInSphere(center, radius, minExt, maxExt); }, function);
+		}
+
+		template<typename Function>
+		inline void SceneBVH::QueryCone(const glm::vec3& apex, const glm::vec3& direction, float length, float radius, Function function) const
+		{
+			Query([&](const glm::vec3& minExt, const glm::vec3& maxExt) { return IsBoxInCone(apex, direction, length, radius, minExt, maxExt); }, function);
+		}
+	}
+}
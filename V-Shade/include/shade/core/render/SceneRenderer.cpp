@@ -7,6 +7,52 @@
 
 #include <shade/core/layer/imgui/ImGuiLayer.h>
 
+namespace
+{
+	// Conservative base radius of spot light cone for scene hierarchy queries, angle is in degrees
+	float ConeRadius(float distance, float maxAngle)
+	{
+		return distance * glm::tan(glm::radians(glm::min(maxAngle, 89.f)));
+	}
+
+	// Everything world transform of model entity depends on, it's much cheaper to gather than the transform itself
+	void GatherMotion(shade::ecs::Entity entity, std::vector<glm::vec4>& motion)
+	{
+		motion.clear();
+
+		if (entity.HasComponent<shade::AnimationGraphComponent>())
+		{
+			auto& graph = entity.GetComponent<shade::AnimationGraphComponent>();
+			const shade::animation::Pose* pose = (graph.AnimationGraph) ? graph.AnimationGraph->GetOutputPose(graph.Instance.Raw()) : nullptr;
+
+			if (pose && pose->HasRootMotion())
+			{
+				const glm::quat& rotation = pose->GetRootMotion().Rotation.Current;
+				motion.emplace_back(pose->GetRootMotion().Translation.Current, 1.f);
+				motion.emplace_back(rotation.x, rotation.y, rotation.z, rotation.w);
+			}
+		}
+
+		for (;;)
+		{
+			// Entity id keeps the chain different when entity is reparented to one with the same transform
+			motion.emplace_back(glm::uintBitsToFloat(static_cast<std::uint32_t>(entity.GetID())), 0.f, 0.f, 0.f);
+
+			if (entity.HasComponent<shade::TransformComponent>())
+			{
+				const auto& transform = entity.GetComponent<shade::TransformComponent>();
+				const glm::quat& rotation = transform.GetRotationQuaternion();
+				motion.emplace_back(transform.GetPosition(), 0.f);
+				motion.emplace_back(rotation.x, rotation.y, rotation.z, rotation.w);
+				motion.emplace_back(transform.GetScale(), 0.f);
+			}
+
+			if (!entity.HasParent()) break;
+			entity = entity.GetParent();
+		}
+	}
+}
+
 shade::SharedPointer<shade::SceneRenderer> shade::SceneRenderer::Create(bool swapChainAsMainTarget)
 {
 	return SharedPointer<SceneRenderer>::Create(swapChainAsMainTarget);
@@ -479,10 +525,24 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 				Renderer::SubmitLight(light, transform.GetForwardDirection(), m_Camera);
 			});
 
+		// Light bounds go to scene hierarchy, only lights reported by frustum query are tested precisely
+		m_PointLightsBVH.BeginFrame(); m_RenderablePointLights.clear();
+
 		scene->View<PointLightComponent, TransformComponent>().Each([&](ecs::Entity& entity, PointLightComponent& light, TransformComponent& transform)
+			{
+				const glm::mat4 pcTransform = scene->ComputePCTransform(entity).first;
+				const glm::vec3 position = glm::vec3(pcTransform[3]);
+
+				m_PointLightsBVH.Update(render::SceneBVH::MakeKey(entity), position - glm::vec3(light->Distance), position + glm::vec3(light->Distance), static_cast<std::uint32_t>(m_RenderablePointLights.size()));
+				m_RenderablePointLights.emplace_back(RenderableLight{ entity, pcTransform });
+			});
+
+		m_PointLightsBVH.EndFrame();
+		m_PointLightsBVH.QueryFrustum(frustum, [&](std::uint32_t index)
 			{
 				// Check if point light within camera frustum 
-				glm::mat4 pcTransform = scene->ComputePCTransform(entity).first;
+				PointLightComponent& light = m_RenderablePointLights[index].Entity.GetComponent<PointLightComponent>();
+				glm::mat4 pcTransform = m_RenderablePointLights[index].Transform;
 
 				if (frustum.IsInFrustum({ pcTransform[3].x, pcTransform[3].y, pcTransform[3].z }, light->Distance))
 				{
@@ -494,9 +554,25 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 				}
 			});
 
+		m_SpotLightsBVH.BeginFrame(); m_RenderableSpotLights.clear();
+
 		scene->View<SpotLightComponent, TransformComponent>().Each([&](ecs::Entity& entity, SpotLightComponent& light, TransformComponent& transform)
 			{
-				glm::mat4 pcTransform = scene->ComputePCTransform(entity).first;
+				const glm::mat4 pcTransform = scene->ComputePCTransform(entity).first;
+				const glm::vec3 apex = glm::vec3(pcTransform[3]), direction = glm::normalize(glm::mat3(pcTransform) * glm::vec3(0.f, 0.f, 1.f));
+				const float radius = ConeRadius(light->Distance, light->MaxAngle);
+
+				// Box which encloses apex and base disc of the cone
+				const glm::vec3 base = apex + direction * light->Distance;
+				m_SpotLightsBVH.Update(render::SceneBVH::MakeKey(entity), glm::min(apex, base - glm::vec3(radius)), glm::max(apex, base + glm::vec3(radius)), static_cast<std::uint32_t>(m_RenderableSpotLights.size()));
+				m_RenderableSpotLights.emplace_back(RenderableLight{ entity, pcTransform });
+			});
+
+		m_SpotLightsBVH.EndFrame();
+		m_SpotLightsBVH.QueryFrustum(frustum, [&](std::uint32_t index)
+			{
+				SpotLightComponent& light = m_RenderableSpotLights[index].Entity.GetComponent<SpotLightComponent>();
+				glm::mat4 pcTransform = m_RenderableSpotLights[index].Transform;
 			
 				float radius = light->Distance * glm::acos(glm::radians(light->MaxAngle));
 	
@@ -509,98 +585,103 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 				}
 			});
 
+		// Transform and bounds are recomputed only for entities which have moved, so scene hierarchy is refitted only for them
+		m_FrustumCulling.Reset(); m_RenderablesBVH.BeginFrame(); ++m_RenderablesStamp;
+		m_RenderableModels.clear(); m_RenderableMeshes.clear();
+
 		scene->View<Asset<Model>, TransformComponent>().Each([&](ecs::Entity& entity, Asset<Model>& model, TransformComponent& transform)
 			{
-				auto pcTransform = scene->ComputePCTransform(entity).first; // Frusturm culling need matrix without compensation
-				bool isModelInFrustrum = true;
+				AnimationGraphComponent* pGraph = (entity.HasComponent<AnimationGraphComponent>()) ? &entity.GetComponent<AnimationGraphComponent>() : nullptr;
+				animation::Pose* pose = (pGraph && pGraph->AnimationGraph) ? pGraph->AnimationGraph->GetOutputPose(pGraph->Instance.Raw()) : nullptr;
 
-				Asset<animation::AnimationGraph> animationGraph = (entity.HasComponent<AnimationGraphComponent>()) ? entity.GetComponent<AnimationGraphComponent>().AnimationGraph : nullptr;
-				animation::Pose* finalPose = (animationGraph) ? animationGraph->GetOutputPose() : nullptr;
+				CachedRenderable& cached = m_RenderablesCache[entity.GetID()]; cached.Stamp = m_RenderablesStamp;
+				GatherMotion(entity, m_MotionScratch);
 
-				for (const auto& mesh : *model)
+				const bool hasMoved = cached.Model != model.Raw() || cached.Bounds.size() != model->GetMeshes().size() || cached.Motion.size() != m_MotionScratch.size() ||
+					std::memcmp(cached.Motion.data(), m_MotionScratch.data(), sizeof(glm::vec4) * m_MotionScratch.size()) != 0;
+
+				if (hasMoved)
 				{
-					//if (frustum.IsInFrustum(pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
+					std::swap(cached.Motion, m_MotionScratch); cached.Model = model.Raw();
+					cached.Transform = scene->ComputePCTransform(entity).first; // Frusturm culling need matrix without compensation
+
+					cached.Bounds.resize(model->GetMeshes().size());
+					for (std::size_t meshIndex = 0; meshIndex < cached.Bounds.size(); ++meshIndex)
 					{
-						isModelInFrustrum = true;
+						const Asset<Mesh>& mesh = model->GetMeshes()[meshIndex];
+						render::FrustumCulling::ToWorldBox(cached.Transform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt(), cached.Bounds[meshIndex].first, cached.Bounds[meshIndex].second);
+					}
+				}
 
+				const std::uint32_t modelIndex = static_cast<std::uint32_t>(m_RenderableModels.size());
+				m_RenderableModels.emplace_back(RenderableModel{ &model, cached.Transform, pose });
+
+				for (std::uint32_t meshIndex = 0; meshIndex < static_cast<std::uint32_t>(cached.Bounds.size()); ++meshIndex)
+				{
+					const auto& [minExt, maxExt] = cached.Bounds[meshIndex];
+
+					// Bounds of entities which haven't moved are the same, so their leafs only take new payload
+					const std::uint32_t boundsIndex = m_FrustumCulling.Add(minExt, maxExt);
+					m_RenderablesBVH.Update(render::SceneBVH::MakeKey(entity, meshIndex), minExt, maxExt, boundsIndex);
+					m_RenderableMeshes.emplace_back(RenderableMesh{ modelIndex, meshIndex });
+				}
+			});
+
+		m_RenderablesBVH.EndFrame();
+
+		// Forget entities which have been destroyed or lost their model
+		for (auto cached = m_RenderablesCache.begin(); cached != m_RenderablesCache.end();)
+			cached = (cached->second.Stamp != m_RenderablesStamp) ? m_RenderablesCache.erase(cached) : std::next(cached);
+
+		// Hierarchy rejects whole subtrees, candidates are tested precisely in batches
+		m_CullingCandidates.clear();
+		m_RenderablesBVH.QueryFrustum(frustum, [&](std::uint32_t boundsIndex) { m_CullingCandidates.emplace_back(boundsIndex); });
+		m_FrustumCulling.Cull(frustum, m_CullingCandidates);
+		m_Statistic.VisibleMeshes = m_FrustumCulling.GetVisibleCount();
+		m_Statistic.CulledMeshes  = m_FrustumCulling.GetCulledCount();
+
+		std::size_t modelIndex = 0; std::uint32_t boundsIndex = 0;
+
+		scene->View<Asset<Model>, TransformComponent>().Each([&](ecs::Entity& entity, Asset<Model>& model, TransformComponent& transform)
+			{
+				auto pcTransform = m_RenderableModels[modelIndex++].Transform;
+				const std::uint32_t firstBoundsIndex = boundsIndex;
+
+				AnimationGraphComponent* pGraph = (entity.HasComponent<AnimationGraphComponent>()) ? &entity.GetComponent<AnimationGraphComponent>() : nullptr;
+				Asset<animation::AnimationGraph> animationGraph = (pGraph) ? pGraph->AnimationGraph : nullptr;
+				animation::Pose* finalPose = (animationGraph) ? animationGraph->GetOutputPose(pGraph->Instance.Raw()) : nullptr;
+
+				bool isModelInFrustrum = false;
+				for (std::uint32_t index = firstBoundsIndex; index < firstBoundsIndex + static_cast<std::uint32_t>(model->GetMeshes().size()); ++index)
+					isModelInFrustrum = isModelInFrustrum || m_FrustumCulling.IsVisible(index);
+
+				// Animation LOD for the next graph update, same distance split as geometry LOD uses
+				if (animationGraph)
+					entity.GetComponent<AnimationGraphComponent>().Lod.SetState(Renderer::GetLodLevelBasedOnDistance(m_Camera, animation::AnimationLod::LEVELS_COUNT, pcTransform, glm::vec3(0.f), glm::vec3(0.f)), isModelInFrustrum);
+
+				// Culled model still needs its pose while any animated shadow pass can draw it
+				const bool isPoseRendered = isModelInFrustrum ||
+					GetPipeline("Global-Light-Shadow-Pre-Depth-Animated")->IsActive() ||
+					GetPipeline("Point-Light-Shadow-Pre-Depth-Animated")->IsActive() ||
+					GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated")->IsActive();
+
+				for (const auto& mesh : *model)
+				{
+					// Meshes outside of camera frustum still cast shadows, so only camera passes are culled
+					if (m_FrustumCulling.IsVisible(boundsIndex++))
+					{
 						if (finalPose && mesh->GetLod(0).Bones.size())
-						{
 							Renderer::SubmitStaticMesh(GetPipeline("Main-Geometry-Animated"), mesh, mesh->GetMaterial(), model, pcTransform);
-							Renderer::SubmitStaticMesh(GetPipeline("Global-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, pcTransform);
-						}
 						else
-						{
 							Renderer::SubmitStaticMesh(GetPipeline("Main-Geometry-Static"), mesh, mesh->GetMaterial(), model, pcTransform);
-							Renderer::SubmitStaticMesh(GetPipeline("Global-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, pcTransform);
-						}
-					
-						Renderer::SubmitStaticMesh(GetPipeline("Light-Culling-Pre-Depth"), mesh, nullptr, model, pcTransform);
-					}
 
-					if (GetPipeline("Point-Light-Shadow-Pre-Depth-Static")->IsActive() || GetPipeline("Point-Light-Shadow-Pre-Depth-Animated")->IsActive())
-					{
-						for (std::uint32_t index = 0; index < Renderer::GetSubmitedPointLightCount(); index++)
-						{
-							auto& renderData = Renderer::GetSubmitedPointLightRenderData(index);
-
-							if (PointLight::GetRenderSettings().SplitBySides)
-							{
-								// Split render passes for each side of cube 
-								for (std::uint32_t side = 0; side < 6; side++)
-								{
-									// Check if mesh inside point light for shadow pass  
-									if (PointLight::IsMeshInside(renderData.Cascades[side].ViewProjectionMatrix, pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
-									{
-										std::size_t seed = index; glm::detail::hash_combine(seed, side);
-										if (finalPose && mesh->GetLod(0).Bones.size())
-										{
-											Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), mesh, nullptr, model, pcTransform, seed);
-										}
-										else
-										{
-											Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Static"), mesh, nullptr, model, pcTransform, seed);
-										}
-									}
-								}
-							}
-							else
-							{
-								if (PointLight::IsMeshInside(renderData.Position, renderData.Distance, pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
-								{
-									if (finalPose && mesh->GetLod(0).Bones.size())
-									{
-										Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, pcTransform, index);
-									}
-									else
-									{
-										Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, pcTransform, index);
-									}
-									
-								}	
-							}
-						}
+						Renderer::SubmitStaticMesh(GetPipeline("Light-Culling-Pre-Depth"), mesh, nullptr, model, pcTransform);
 					}
-					 // Check if mesh inside spot light for shadow pass  
-					if (GetPipeline("Spot-Light-Shadow-Pre-Depth-Static") || GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"))
-					{
-						for (std::uint32_t index = 0; index < Renderer::GetSubmitedSpotLightCount(); index++)
-						{
-							auto& renderData = Renderer::GetSubmitedSpotLightRenderData(index);
 
-							float radius = glm::acos(glm::radians(renderData.MaxAngle)) * renderData.Distance;
-							if (SpotLight::IsMeshInside(renderData.Cascade.ViewProjectionMatrix, pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
-							{
-								if (finalPose && mesh->GetLod(0).Bones.size())
-								{
-									Renderer::SubmitStaticMesh(GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, pcTransform, index);
-								}
-								else
-								{
-									Renderer::SubmitStaticMesh(GetPipeline("Spot-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, pcTransform, index);
-								}
-							}
-						}
-					}
+					if (finalPose && mesh->GetLod(0).Bones.size())
+						Renderer::SubmitStaticMesh(GetPipeline("Global-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, pcTransform);
+					else
+						Renderer::SubmitStaticMesh(GetPipeline("Global-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, pcTransform);
 
 					// OBB Visualization
 					if (GetPipeline("AABB-OBB")->IsActive())
@@ -615,13 +696,16 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 					}
 				}
 
-				if (isModelInFrustrum && finalPose)
+				if (isPoseRendered && finalPose)
 				{
+					// Global transforms are computed lazily, only for poses that are actually rendered
+					finalPose->UpdateGlobalTransforms();
+
 					// Only for the selected entity 
 					if (activeEntity == entity) // TODO: check if pipelines are enabled to avoid using this part of the code 
 					{
 						// Create a copy of skeleton transforms
-						static SharedPointer<std::vector<animation::Pose::GlobalTransform>> skVisualize = SharedPointer<std::vector<animation::Pose::GlobalTransform>>::Create(RenderAPI::MAX_BONES_PER_INSTANCE);
+						static std::vector<animation::Pose::GlobalTransform> skVisualize(RenderAPI::MAX_BONES_PER_INSTANCE);
 
 						for (const auto& [name, bone] : finalPose->GetSkeleton()->GetBones())
 						{
@@ -638,9 +722,9 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 								parentBoneT = parentBoneT * glm::inverse(parentInverseBindPoseT);
 							}
 
-							skVisualize->at(bone.ID).ParentId = parentId;
+							skVisualize.at(bone.ID).ParentId = parentId;
 							// Set the global bone transform 
-							skVisualize->at(bone.ID).Transform = pcTransform * boneT;
+							skVisualize.at(bone.ID).Transform = pcTransform * boneT;
 
 							// Calculate the distance between parent and child bones to determine scale factor for the spheres
 							const float scale = glm::distance(boneT * glm::vec4(0, 0, 0, 1), parentBoneT * glm::vec4(0, 0, 0, 1)) * 0.06f;
@@ -655,24 +739,26 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 						// Submit bones visualization, dummy invocation for the geometry shader 
 						Renderer::SubmitStaticMesh(GetPipeline("Skeleton-Bone-Visualizing"), nullptr, nullptr, model, pcTransform);
 						// Submit bone matrices for visualization 
-						Renderer::SubmitBoneTransforms(GetPipeline("Skeleton-Bone-Visualizing"), model, skVisualize);
+						Renderer::SubmitBoneTransforms(GetPipeline("Skeleton-Bone-Visualizing"), model, skVisualize.data());
 					}
 
 
 					if (!finalPose->HasInverseBindPose())
 					{
-						for (auto& [name, bone] : finalPose->GetSkeleton()->GetBones())
+						const Skeleton::Hierarchy& hierarchy = finalPose->GetSkeleton()->GetHierarchy();
+
+						for (std::size_t i = 0; i < hierarchy.GetBonesCount(); ++i)
 						{
-							finalPose->GetBoneGlobalTransforms()->at(bone.ID).Transform *= bone.InverseBindPose;
+							finalPose->GetBoneGlobalTransform(hierarchy.IDs[i]).Transform *= hierarchy.InverseBindPoses[i];
 						}
 
 						finalPose->MarkHasInverseBindPose(true);
 					}
 					
-					Renderer::SubmitBoneTransforms(GetPipeline("Global-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms());
-					Renderer::SubmitBoneTransforms(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms());
-					Renderer::SubmitBoneTransforms(GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms());
-					Renderer::SubmitBoneTransforms(GetPipeline("Main-Geometry-Animated"), model, finalPose->GetBoneGlobalTransforms());
+					Renderer::SubmitBoneTransforms(GetPipeline("Global-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms().data());
+					Renderer::SubmitBoneTransforms(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms().data());
+					Renderer::SubmitBoneTransforms(GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"), model, finalPose->GetBoneGlobalTransforms().data());
+					Renderer::SubmitBoneTransforms(GetPipeline("Main-Geometry-Animated"), model, finalPose->GetBoneGlobalTransforms().data());
 				}
 
 				// AABB Visualization
@@ -746,6 +832,86 @@ void shade::SceneRenderer::OnUpdate(SharedPointer<Scene>& scene, const shade::Ca
 				//}
 			});
 
+		// Assign meshes to shadow views, only meshes reported by scene hierarchy for light volume are tested precisely
+		if (GetPipeline("Point-Light-Shadow-Pre-Depth-Static")->IsActive() || GetPipeline("Point-Light-Shadow-Pre-Depth-Animated")->IsActive())
+		{
+			for (std::uint32_t index = 0; index < Renderer::GetSubmitedPointLightCount(); index++)
+			{
+				auto& renderData = Renderer::GetSubmitedPointLightRenderData(index);
+
+				m_RenderablesBVH.QuerySphere(renderData.Position, renderData.Distance, [&](std::uint32_t boundsIndex)
+					{
+						const RenderableModel& renderable = m_RenderableModels[m_RenderableMeshes[boundsIndex].Model];
+						const Asset<Model>& model = *renderable.Model;
+						const Asset<Mesh>& mesh = model->GetMeshes()[m_RenderableMeshes[boundsIndex].Mesh];
+						const glm::mat4& pcTransform = renderable.Transform;
+
+						if (PointLight::GetRenderSettings().SplitBySides)
+						{
+							// Split render passes for each side of cube 
+							for (std::uint32_t side = 0; side < 6; side++)
+							{
+								// Check if mesh inside point light for shadow pass  
+								if (PointLight::IsMeshInside(renderData.Cascades[side].ViewProjectionMatrix, pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
+								{
+									// Split of every side is unique, so it fits draw key split field
+									const std::uint32_t split = index * 6u + side;
+									if (renderable.Pose && mesh->GetLod(0).Bones.size())
+									{
+										Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), mesh, nullptr, model, pcTransform, split);
+									}
+									else
+									{
+										Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Static"), mesh, nullptr, model, pcTransform, split);
+									}
+								}
+							}
+						}
+						else
+						{
+							if (PointLight::IsMeshInside(renderData.Position, renderData.Distance, pcTransform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
+							{
+								if (renderable.Pose && mesh->GetLod(0).Bones.size())
+								{
+									Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, pcTransform, index);
+								}
+								else
+								{
+									Renderer::SubmitStaticMesh(GetPipeline("Point-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, pcTransform, index);
+								}
+							}
+						}
+					});
+			}
+		}
+		// Check if mesh inside spot light for shadow pass  
+		if (GetPipeline("Spot-Light-Shadow-Pre-Depth-Static") || GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"))
+		{
+			for (std::uint32_t index = 0; index < Renderer::GetSubmitedSpotLightCount(); index++)
+			{
+				auto& renderData = Renderer::GetSubmitedSpotLightRenderData(index);
+
+				m_RenderablesBVH.QueryCone(renderData.Position, renderData.Direction, renderData.Distance, ConeRadius(renderData.Distance, glm::degrees(renderData.MaxAngle)), [&](std::uint32_t boundsIndex)
+					{
+						const RenderableModel& renderable = m_RenderableModels[m_RenderableMeshes[boundsIndex].Model];
+						const Asset<Model>& model = *renderable.Model;
+						const Asset<Mesh>& mesh = model->GetMeshes()[m_RenderableMeshes[boundsIndex].Mesh];
+
+						if (SpotLight::IsMeshInside(renderData.Cascade.ViewProjectionMatrix, renderable.Transform, mesh->GetMinHalfExt(), mesh->GetMaxHalfExt()))
+						{
+							if (renderable.Pose && mesh->GetLod(0).Bones.size())
+							{
+								Renderer::SubmitStaticMesh(GetPipeline("Spot-Light-Shadow-Pre-Depth-Animated"), mesh, mesh->GetMaterial(), model, renderable.Transform, index);
+							}
+							else
+							{
+								Renderer::SubmitStaticMesh(GetPipeline("Spot-Light-Shadow-Pre-Depth-Static"), mesh, mesh->GetMaterial(), model, renderable.Transform, index);
+							}
+						}
+					});
+			}
+		}
+
 		// Submit grid for rendering
 		
 		Renderer::SubmitStaticMesh(GetPipeline("Grid"), m_Plane, nullptr, nullptr, glm::mat4(1.f));
@@ -1006,15 +1172,15 @@ void shade::SceneRenderer::PointLightShadowPreDepthPass(SharedPointer<RenderPipe
 					if (PointLight::GetRenderSettings().SplitBySides)
 					{
 						// Draw the submitted instance
-						std::size_t seed = index; glm::detail::hash_combine(seed, side);
+						const std::uint32_t split = index * 6u + side;
 						
 						if (GetPipeline("Point-Light-Shadow-Pre-Depth-Animated").Raw() == pipeline.Raw())
 						{
-							Renderer::DrawSubmitedInstancedAnimated(m_MainCommandBuffer, pipeline, instance, material, frameIndex, lod, seed);
+							Renderer::DrawSubmitedInstancedAnimated(m_MainCommandBuffer, pipeline, instance, material, frameIndex, lod, split);
 						}
 						else
 						{
-							Renderer::DrawSubmitedInstanced(m_MainCommandBuffer, pipeline, instance, material, frameIndex, lod);
+							Renderer::DrawSubmitedInstanced(m_MainCommandBuffer, pipeline, instance, material, frameIndex, lod, split);
 						}
 					}
 					else
@@ -13,6 +13,8 @@
 #include <shade/core/render/drawable/primitives/Box.h>
 #include <shade/core/render/drawable/primitives/Sphere.h>
 #include <shade/core/render/drawable/primitives/Cone.h>
+#include <shade/core/render/FrustumCulling.h>
+#include <shade/core/render/SceneBVH.h>
 
 namespace shade
 {
@@ -139,6 +141,8 @@ namespace shade
 			std::uint32_t SubmitedInstances			= 0;
 			std::uint32_t SubmitedOmnidirectLights	= 0;
 			std::uint32_t SubmitedSpotLights		= 0;
+			std::uint32_t VisibleMeshes				= 0;
+			std::uint32_t CulledMeshes				= 0;
 
 			void Reset() { (*this) = Statistic{}; }
 		};
@@ -192,6 +196,47 @@ namespace shade
 		// Settings
 		Settings m_Settings;
 		Statistic m_Statistic;
+		render::FrustumCulling m_FrustumCulling;
+
+		// Per frame renderables, bounds index of FrustumCulling is index of RenderableMesh
+		struct RenderableModel
+		{
+			const Asset<Model>*	Model;
+			glm::mat4			Transform;
+			animation::Pose*	Pose;
+		};
+		struct RenderableMesh
+		{
+			std::uint32_t Model, Mesh;
+		};
+		struct RenderableLight
+		{
+			ecs::Entity	Entity;
+			glm::mat4	Transform;
+		};
+		// World transform and bounds of model entity, recomputed only when entity or its parents have moved
+		struct CachedRenderable
+		{
+			// Local transforms of entity and its parents and root motion of entity, compared bitwise
+			std::vector<glm::vec4>							Motion;
+			const void*										Model = nullptr;
+			glm::mat4										Transform = glm::mat4(1.f);
+			std::vector<std::pair<glm::vec3, glm::vec3>>	Bounds;
+			std::uint32_t									Stamp = 0u;
+		};
+		std::vector<RenderableModel>	m_RenderableModels;
+		std::vector<RenderableMesh>		m_RenderableMeshes;
+		// Bounds indices reported by scene hierarchy, reused every frame
+		std::vector<std::uint32_t>		m_CullingCandidates;
+		std::unordered_map<ecs::EntityID, CachedRenderable> m_RenderablesCache;
+		std::vector<glm::vec4>			m_MotionScratch;
+		std::uint32_t					m_RenderablesStamp = 0u;
+		std::vector<RenderableLight>	m_RenderablePointLights;
+		std::vector<RenderableLight>	m_RenderableSpotLights;
+
+		render::SceneBVH m_RenderablesBVH;
+		render::SceneBVH m_PointLightsBVH;
+		render::SceneBVH m_SpotLightsBVH;
 
 		SharedPointer<Plane>	m_Plane;
 		SharedPointer<Box>		m_OBB;
@@ -2,6 +2,7 @@
 #include "Scene.h"
 #include <shade/core/asset/AssetManager.h>
 #include <shade/core/scripting/ScriptManager.h>
+#include <shade/core/animation/PoseArena.h>
 // TODO: TEMPORARY
 #include <shade/core/camera/Camera.h>
 #include <ctti/type_id.hpp>
@@ -49,6 +50,7 @@ shade::SharedPointer<shade::Scene>& shade::Scene::SetActiveScene(const std::stri
 
 void shade::Scene::NativeScriptsUpdate(const shade::FrameTimer& deltaTime)
 {
+	// Scripts may write any component and change the scene, so they are updated serially
 	View<NativeScriptComponent>().Each([=](ecs::Entity& entity, NativeScriptComponent& script)
 		{
 			if (script.InstantiateScript)
@@ -67,10 +69,17 @@ void shade::Scene::NativeScriptsUpdate(const shade::FrameTimer& deltaTime)
 
 void shade::Scene::GraphsUpdate(const shade::FrameTimer& deltaTime)
 {
-	View<shade::AnimationGraphComponent>().Each([&](shade::ecs::Entity& entity, shade::AnimationGraphComponent& graph)
+	// Poses of previous frame are released, every worker thread takes transforms from its own arena
+	animation::PoseArena::BeginFrame();
+
+	View<shade::AnimationGraphComponent>().ParallelEach([&](shade::ecs::Entity& entity, shade::AnimationGraphComponent& graph)
 		{
-			if (graph.AnimationGraph) graph.AnimationGraph->ProcessBranch(deltaTime);
-		});
+			if (graph.AnimationGraph)
+			{
+				graphs::GraphInstance::Scope instance(*graph.AnimationGraph->GetGraphContext(), graph.Instance.Raw());
+				graph.Lod.Update(*graph.AnimationGraph, deltaTime);
+			}
+		}, 4);
 }
 
 shade::ecs::Entity shade::Scene::GetPrimaryCamera()
@@ -132,7 +141,9 @@ std::pair<glm::mat4, glm::mat4> shade::Scene::ComputePCTransform(ecs::Entity& en
 
 		if (entity.HasComponent<shade::AnimationGraphComponent>())
 		{
-			if (const animation::Pose* pose = entity.GetComponent<shade::AnimationGraphComponent>().AnimationGraph->GetOutputPose())
+			auto& graph = entity.GetComponent<shade::AnimationGraphComponent>();
+
+			if (const animation::Pose* pose = (graph.AnimationGraph) ? graph.AnimationGraph->GetOutputPose(graph.Instance.Raw()) : nullptr)
 			{
 				if (pose->HasRootMotion())
 				{
@@ -411,14 +422,15 @@ void shade::Scene::DeserrializeEntity(std::istream& stream, ecs::Entity entity,
 			});
 
 		// Deserialize AnimationGraphComponent
-		cSize += entity.DeserializeComponent<AnimationGraphComponent>(stream, compTypeHash, [](std::istream& stream, AnimationGraphComponent& graph)
+		cSize += entity.DeserializeComponent<AnimationGraphComponent>(stream, compTypeHash, [entity](std::istream& stream, AnimationGraphComponent& graph) mutable
 			{
 				std::string assetId; serialize::Serializer::Deserialize(stream, assetId);
-				graph.GraphContext.Controller = shade::animation::AnimationController::Create();
+				graph.Instance = SharedPointer<animation::AnimationGraphInstance>::Create();
+				// Graph is loaded asynchronously, component can be moved by removal of other components before that, so handle is captured instead of reference
 				AssetManager::GetAsset<animation::AnimationGraph, BaseAsset::InstantiationBehaviour::Aynchronous>(assetId, AssetMeta::Category::Secondary, BaseAsset::LifeTime::KeepAlive, 
-					[&](auto& asset) mutable { 
-						graph.AnimationGraph = asset;
-					}, &graph.GraphContext);
+					[handle = entity.GetComponentHandle<AnimationGraphComponent>()](auto& asset) mutable { 
+						if (handle) handle->AnimationGraph = asset;
+					}, static_cast<graphs::GraphContext*>(nullptr));
 			});
 
 		if (!cSize)
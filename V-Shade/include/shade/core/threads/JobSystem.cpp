@@ -0,0 +1,180 @@
+#include "shade_pch.h"
+#include "JobSystem.h"
+#include <shade/utils/Logger.h>
+
+namespace
+{
+	// Job system which owns current thread and worker index in it, nullptr for non worker threads
+	thread_local shade::thread::JobSystem* s_pJobSystem = nullptr;
+	thread_local std::size_t s_WorkerIndex = 0u;
+}
+
+shade::thread::JobSystem::JobSystem(std::size_t threadsCount)
+{
+	if (!threadsCount)
+		throw std::invalid_argument("Invalid thread count: 0 or less.");
+	else
+		Start(threadsCount);
+}
+
+shade::thread::JobSystem::~JobSystem()
+{
+	Quit();
+}
+
+shade::thread::JobSystem& shade::thread::JobSystem::GetGlobal()
+{
+	// Calling thread always participates, so keep one core for it
+	static JobSystem jobSystem((std::max)(std::thread::hardware_concurrency(), 2u) - 1u);
+	return jobSystem;
+}
+
+void shade::thread::JobSystem::Start(std::size_t threadsCount)
+{
+	for (std::size_t i = 0; i < threadsCount; ++i)
+		m_Queues.emplace_back(std::make_unique<WorkerQueue>());
+
+	for (std::size_t i = 0; i < threadsCount; ++i)
+	{
+		m_Threads.emplace_back([this, i] {
+			s_pJobSystem = this; s_WorkerIndex = i;
+
+			while (true)
+			{
+				if (TryExecuteOne())
+					continue;
+
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				// Has to be visible before pending jobs check, see Submit
+				m_SleepingWorkers.fetch_add(1u);
+				m_Event.wait(lock, [this] { return m_Quit.load() || m_PendingJobs.load() != 0u; });
+				m_SleepingWorkers.fetch_sub(1u);
+
+				if (m_Quit.load() && m_PendingJobs.load() == 0u)
+					break;
+			}
+		});
+	}
+}
+
+void shade::thread::JobSystem::Quit() noexcept
+{
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		m_Quit = true;
+	}
+
+	m_Event.notify_all();
+
+	for (auto& thread : m_Threads)
+		thread.join();
+}
+
+void shade::thread::JobSystem::Submit(Job&& job)
+{
+	// Workers push into own queue, other threads spread jobs between workers
+	const std::size_t index = (s_pJobSystem == this) ? s_WorkerIndex : m_NextQueue.fetch_add(1u, std::memory_order_relaxed) % m_Queues.size();
+	{
+		std::lock_guard<std::mutex> lock{ m_Queues[index]->Mutex };
+		m_Queues[index]->Jobs.emplace_back(std::move(job));
+	}
+
+	m_PendingJobs.fetch_add(1u);
+	if (m_SleepingWorkers.load() != 0u)
+	{
+		{ std::lock_guard<std::mutex> lock{ m_Mutex }; }
+		m_Event.notify_one();
+	}
+}
+
+void shade::thread::JobSystem::Continue(JobCounter& dependency, Job&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock{ dependency.m_Mutex };
+		if (!dependency.IsDone())
+		{
+			dependency.m_Continuations.emplace_back(std::move(job));
+			return;
+		}
+	}
+
+	Submit(std::move(job));
+}
+
+bool shade::thread::JobSystem::TryExecuteOne()
+{
+	const bool isWorker = (s_pJobSystem == this);
+	const std::size_t first = isWorker ? s_WorkerIndex : m_NextQueue.load(std::memory_order_relaxed) % m_Queues.size();
+
+	Job job;
+	for (std::size_t i = 0; i < m_Queues.size() && !job; ++i)
+	{
+		auto& queue = *m_Queues[(first + i) % m_Queues.size()];
+		std::lock_guard<std::mutex> lock{ queue.Mutex };
+
+		if (queue.Jobs.empty())
+			continue;
+		// Owner takes latest job while it's still hot in cache, thieves take oldest one
+		if (isWorker && i == 0)
+		{
+			job = std::move(queue.Jobs.back()); queue.Jobs.pop_back();
+		}
+		else
+		{
+			job = std::move(queue.Jobs.front()); queue.Jobs.pop_front();
+		}
+	}
+
+	if (!job)
+		return false;
+
+	m_PendingJobs.fetch_sub(1u);
+	Execute(job);
+	return true;
+}
+
+void shade::thread::JobSystem::Execute(Job& job)
+{
+	try
+	{
+		job();
+	}
+	catch (std::exception& exception)
+	{
+		SHADE_CORE_ERROR("Job exception: {0}", exception.what());
+	}
+	catch (...)
+	{
+		SHADE_CORE_ERROR("Job exception: unknown");
+	}
+
+	if (JobCounter* counter = job.GetCounter())
+	{
+		// Not last job of counter, nobody can be waiting for it
+		std::uint32_t value = counter->m_Value.load(std::memory_order_relaxed);
+		while (value > 1u && !counter->m_Value.compare_exchange_weak(value, value - 1u, std::memory_order_acq_rel));
+		if (value > 1u)
+			return;
+
+		std::vector<Job> continuations;
+		{
+			std::lock_guard<std::mutex> lock{ counter->m_Mutex };
+			if (counter->m_Value.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+				continuations.swap(counter->m_Continuations);
+		}
+		// Counter may be destroyed by waiting thread from now on, don't touch it anymore
+		for (auto& continuation : continuations)
+			Submit(std::move(continuation));
+	}
+}
+
+void shade::thread::JobSystem::WaitFor(JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!TryExecuteOne())
+			std::this_thread::yield();
+	}
+	// Wait until last job releases counter, so caller can destroy it
+	std::lock_guard<std::mutex> lock{ counter.m_Mutex };
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <shade/config/ShadeAPI.h>
+
+namespace shade
+{
+	namespace thread
+	{
+		class JobSystem;
+		class JobCounter;
+
+		/* Type erased move only task, small callables are stored inline without heap allocation */
+		class Job
+		{
+		public:
+			static constexpr std::size_t InlineSize = 48u;
+		public:
+			Job() = default;
+			template<typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Job>>>
+			Job(Function&& function, JobCounter* counter = nullptr) : m_pCounter(counter)
+			{
+				using Type = std::decay_t<Function>;
+
+				if constexpr (sizeof(Type) <= InlineSize && alignof(Type) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Type>)
+				{
+					new (m_Storage) Type(std::forward<Function>(function));
+					m_Invoke = [](void* storage) { (*static_cast<Type*>(storage))(); };
+					m_Operate = [](void* destination, void* source)
+						{
+							if (source) { new (destination) Type(std::move(*static_cast<Type*>(source))); static_cast<Type*>(source)->~Type(); }
+							else static_cast<Type*>(destination)->~Type();
+						};
+				}
+				else
+				{
+					*reinterpret_cast<Type**>(m_Storage) = new Type(std::forward<Function>(function));
+					m_Invoke = [](void* storage) { (**static_cast<Type**>(storage))(); };
+					m_Operate = [](void* destination, void* source)
+						{
+							if (source) *static_cast<Type**>(destination) = *static_cast<Type**>(source);
+							else delete *static_cast<Type**>(destination);
+						};
+				}
+			}
+			Job(Job&& other) noexcept { MoveFrom(other); }
+			Job& operator=(Job&& other) noexcept
+			{
+				if (this != &other) { Reset(); MoveFrom(other); }
+				return *this;
+			}
+			Job(const Job&) = delete;
+			Job& operator=(const Job&) = delete;
+			~Job() { Reset(); }
+		public:
+			void operator()() { m_Invoke(m_Storage); }
+			operator bool() const { return m_Invoke != nullptr; }
+			JobCounter* GetCounter() const { return m_pCounter; }
+		private:
+			void Reset()
+			{
+				if (m_Operate) m_Operate(m_Storage, nullptr);
+				m_Invoke = nullptr; m_Operate = nullptr; m_pCounter = nullptr;
+			}
+			void MoveFrom(Job& other)
+			{
+				if (other.m_Operate) other.m_Operate(m_Storage, other.m_Storage);
+				m_Invoke = other.m_Invoke; m_Operate = other.m_Operate; m_pCounter = other.m_pCounter;
+				other.m_Invoke = nullptr; other.m_Operate = nullptr; other.m_pCounter = nullptr;
+			}
+		private:
+			alignas(std::max_align_t) unsigned char m_Storage[InlineSize];
+			void (*m_Invoke)(void*) = nullptr;
+			/* Move construct from source into destination or destroy destination if source is nullptr */
+			void (*m_Operate)(void*, void*) = nullptr;
+			JobCounter* m_pCounter = nullptr;
+		};
+
+		/* Count of unfinished jobs, jobs which depend on counter are scheduled once it reaches zero. Destroy it only after WaitFor */
+		class SHADE_API JobCounter
+		{
+		public:
+			JobCounter() = default;
+			~JobCounter() = default;
+			JobCounter(const JobCounter&) = delete;
+			JobCounter& operator=(const JobCounter&) = delete;
+		public:
+			/* Return true if all jobs linked with counter are finished */
+			bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0u; }
+		private:
+			friend class JobSystem;
+			std::atomic<std::uint32_t> m_Value{ 0u };
+			std::mutex m_Mutex;
+			std::vector<Job> m_Continuations;
+		};
+
+		/* Work stealing job system, every worker owns a queue and steals from others when it runs out of jobs */
+		class SHADE_API JobSystem
+		{
+		public:
+			JobSystem(std::size_t threadsCount = std::thread::hardware_concurrency());
+			~JobSystem();
+			JobSystem(const JobSystem&) = delete;
+			JobSystem& operator=(const JobSystem&) = delete;
+		public:
+			/* Schedule function, counter is decremented when it's done, if dependency is set function starts only after dependency is done */
+			template<typename Function>
+			void Schedule(Function&& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+			/* Execute other jobs on calling thread until counter is done */
+			void WaitFor(JobCounter& counter);
+			/* Split [0, count) into chunks of grainSize and run function(first, last) for each chunk, returns when all chunks are done */
+			template<typename Function>
+			void ParallelFor(std::size_t count, std::size_t grainSize, Function function);
+			/* Return count of worker threads */
+			std::size_t GetWorkersCount() const { return m_Threads.size(); }
+			/* Engine wide job system for per frame parallel work */
+			static JobSystem& GetGlobal();
+		private:
+			struct alignas(64) WorkerQueue
+			{
+				std::mutex Mutex;
+				std::deque<Job> Jobs;
+			};
+		private:
+			void Start(std::size_t threadsCount);
+			void Quit() noexcept;
+			void Submit(Job&& job);
+			void Continue(JobCounter& dependency, Job&& job);
+			bool TryExecuteOne();
+			void Execute(Job& job);
+		private:
+			std::vector<std::unique_ptr<WorkerQueue>>	m_Queues;
+			std::vector<std::thread>					m_Threads;
+			std::atomic<std::size_t>					m_PendingJobs{ 0u };
+			std::atomic<std::size_t>					m_SleepingWorkers{ 0u };
+			std::atomic<std::size_t>					m_NextQueue{ 0u };
+			std::condition_variable						m_Event;
+			std::mutex									m_Mutex;
+			std::atomic<bool>							m_Quit{ false };
+		};
+
+		template<typename Function>
+		inline void JobSystem::Schedule(Function&& function, JobCounter* counter, JobCounter* dependency)
+		{
+			if (counter)
+				counter->m_Value.fetch_add(1u, std::memory_order_relaxed);
+
+			if (dependency)
+				Continue(*dependency, Job(std::forward<Function>(function), counter));
+			else
+				Submit(Job(std::forward<Function>(function), counter));
+		}
+
+		template<typename Function>
+		inline void JobSystem::ParallelFor(std::size_t count, std::size_t grainSize, Function function)
+		{
+			grainSize = (std::max)(grainSize, std::size_t(1));
+			const std::size_t chunks = (count + grainSize - 1) / grainSize;
+
+			if (chunks <= 1)
+			{
+				if (count) function(std::size_t(0), count);
+				return;
+			}
+
+			struct Failure
+			{
+				std::atomic<bool> IsFailed{ false };
+				std::exception_ptr Exception;
+			} failure;
+
+			JobCounter counter;
+			for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+			{
+				const std::size_t first = chunk * grainSize, last = (std::min)(first + grainSize, count);
+				Schedule([&function, &failure, first, last]()
+					{
+						try { function(first, last); }
+						catch (...) { if (!failure.IsFailed.exchange(true)) failure.Exception = std::current_exception(); }
+					}, &counter);
+			}
+			// Calling thread participates instead of blocking
+			WaitFor(counter);
+
+			if (failure.Exception)
+				std::rethrow_exception(failure.Exception);
+		}
+	}
+}
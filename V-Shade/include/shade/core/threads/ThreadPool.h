@@ -1,45 +1,54 @@
 #pragma once
 #include <shade/config/ShadeAPI.h>
+#include <shade/core/threads/JobSystem.h>
 
 namespace shade
 {
 	namespace thread
 	{
+		/* Future based interface over own job system, kept for long running tasks like asset loading */
 		class SHADE_API ThreadPool
 		{
 		public:
 			ThreadPool(std::size_t threadsCount = std::thread::hardware_concurrency());
-			~ThreadPool();
+			~ThreadPool() = default;
 
 			template<class T>
 			auto Emplace(T task) -> std::future<decltype(task())>;
+			/* Return count of worker threads */
+			std::size_t GetThreadsCount() const { return m_JobSystem.GetWorkersCount(); }
+			/* Get underlying job system */
+			JobSystem& GetJobSystem() { return m_JobSystem; }
 		private:
-			void Start(std::size_t threadsCount);
-			void Quit() noexcept;
-		private:
-			std::queue<std::function<void()>>	m_Tasks;
-			std::vector<std::thread>			m_Threads;
-			std::condition_variable				m_Event;
-			std::mutex							m_Mutex;
-			bool								m_Quit = false;
+			JobSystem m_JobSystem;
 		};
 
 		template<class T>
 		inline auto ThreadPool::Emplace(T task) -> std::future<decltype(task())>
 		{
-			// TODO: Add exeption catcher !
-			auto wrapper = std::make_shared<std::packaged_task<decltype(task()) ()>>(task);
-			{
-				std::unique_lock<std::mutex> lock{ m_Mutex };
-				m_Tasks.emplace([=] {
-					(*wrapper)();
-					});
-			}
+			using Result = decltype(task());
 
-			m_Event.notify_one();
-			return wrapper->get_future();
-		}
+			std::promise<Result> promise;
+			auto future = promise.get_future();
+
+			m_JobSystem.Schedule([task = std::move(task), promise = std::move(promise)]() mutable
+				{
+					try
+					{
+						if constexpr (std::is_void_v<Result>)
+						{
+							task(); promise.set_value();
+						}
+						else
+							promise.set_value(task());
+					}
+					catch (...)
+					{
+						promise.set_exception(std::current_exception());
+					}
+				});
 
+			return future;
+		}
 	}
 }
-
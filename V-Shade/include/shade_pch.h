@@ -23,7 +23,10 @@
 #include <random>
 #include <regex>
 #include <queue>
+#include <deque>
+#include <mutex>
 #include <array>
+#include <span>
 #include <map>
 #include <set>
 